@@ -30,6 +30,8 @@
 #include <algorithm>
 #include <limits>
 #include <cmath>
+#include <type_traits>
+#include <utility>
 
 #define MAX_STACK_SIZE 64
 
@@ -60,6 +62,15 @@ struct AABound
     G3D::Vector3 lo, hi;
 };
 
+// Ray callbacks providing IntersectLeaf(ray, firstObject, objectCount, maxDist, stopAtFirst) are given whole leaves at once.
+// Objects are referenced by their position in BIH::getObjects() and not by their primitive index.
+template<typename RayCallback, typename = void>
+struct BIHHasLeafCallback : std::false_type { };
+
+template<typename RayCallback>
+struct BIHHasLeafCallback<RayCallback, decltype(void(std::declval<RayCallback&>().IntersectLeaf(std::declval<G3D::Ray const&>(),
+    uint32(), uint32(), std::declval<float&>(), bool())))> : std::true_type { };
+
 /** Bounding Interval Hierarchy Class.
 Building and Ray-Intersection functions based on BIH from
 Sunflow, a Java Raytracer, released under MIT/X11 License
@@ -116,6 +127,8 @@ public:
         delete[] dat.indices;
     }
     uint32 primCount() const { return uint32(objects.size()); }
+    // Primitive indexes in tree order, leaves reference consecutive ranges of it
+    std::vector<uint32> const& getObjects() const { return objects; }
 
     template<typename RayCallback>
     void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst = false) const
@@ -215,13 +228,8 @@ public:
                     else
                     {
                         // leaf - test some objects
-                        int n = tree[node + 1];
-                        while (n > 0) {
-                            bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
-                            if (stopAtFirst && hit) return;
-                            --n;
-                            ++offset;
-                        }
+                        bool hit = intersectLeaf(r, intersectCallback, offset, tree[node + 1], maxDist, stopAtFirst, BIHHasLeafCallback<RayCallback>());
+                        if (stopAtFirst && hit) return;
                         break;
                     }
                 }
@@ -338,6 +346,25 @@ public:
     bool readFromFile(FILE* rf);
 
 protected:
+    template<typename RayCallback>
+    bool intersectLeaf(const G3D::Ray &r, RayCallback& intersectCallback, uint32 offset, uint32 n, float &maxDist, bool stopAtFirst, std::true_type /*leafCallback*/) const
+    {
+        return intersectCallback.IntersectLeaf(r, offset, n, maxDist, stopAtFirst);
+    }
+
+    template<typename RayCallback>
+    bool intersectLeaf(const G3D::Ray &r, RayCallback& intersectCallback, uint32 offset, uint32 n, float &maxDist, bool stopAtFirst, std::false_type /*leafCallback*/) const
+    {
+        bool hit = false;
+        while (n > 0) {
+            hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
+            if (stopAtFirst && hit) return true;
+            --n;
+            ++offset;
+        }
+        return hit;
+    }
+
     std::vector<uint32> tree;
     std::vector<uint32> objects;
     G3D::AABox bounds;
@@ -21,6 +21,7 @@
 //#include "RegularGrid.h"
 #include "BoundingIntervalHierarchyWrapper.h"
 
+#include "IVMapManager.h"
 #include "Log.h"
 #include "RegularGrid.h"
 #include "Timer.h"
@@ -242,6 +243,16 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
     return !callback.did_hit;
 }
 
+void DynamicMapTree::isInLineOfSight(VMAP::LineOfSightRay* rays, size_t count, uint32 phasemask) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightRay& ray = rays[i];
+        if (ray.inLineOfSight)
+            ray.inLineOfSight = isInLineOfSight(ray.x1, ray.y1, ray.z1, ray.x2, ray.y2, ray.z2, phasemask);
+    }
+}
+
 float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist, uint32 phasemask) const
 {
     G3D::Vector3 v(x, y, z);
@@ -13,6 +13,11 @@ namespace G3D
 class GameObjectModel;
 struct DynTreeImpl;
 
+namespace VMAP
+{
+    struct LineOfSightRay;
+}
+
 class TC_COMMON_API DynamicMapTree
 {
     DynTreeImpl *impl;
@@ -24,6 +29,8 @@ public:
 
     bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2,
                          float z2, uint32 phasemask) const;
+    // Rays already out of line of sight are not cast
+    void isInLineOfSight(VMAP::LineOfSightRay* rays, size_t count, uint32 phasemask) const;
 
     bool getIntersectionTime(uint32 phasemask, const G3D::Ray& ray,
                              const G3D::Vector3& endPos, float& maxDist) const;
@@ -75,6 +75,13 @@ namespace VMAP
         Optional<AreaInfo> areaInfo;
         Optional<LiquidInfo> liquidInfo;
     };
+    // A ray of a batched line of sight query
+    struct LineOfSightRay
+    {
+        float x1, y1, z1;
+        float x2, y2, z2;
+        bool inLineOfSight; // result, rays already out of line of sight are not cast
+    };
     //===========================================================
     class TC_COMMON_API IVMapManager
     {
@@ -95,6 +102,8 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) = 0;
+            // Same as above for several rays, map tree is only looked up once
+            virtual void isInLineOfSight(unsigned int pMapId, LineOfSightRay* rays, size_t count, ModelIgnoreFlags ignoreFlags) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             virtual float getCeil(unsigned int /*pMapId*/, float /*x*/, float /*y*/, float /*z*/, float /*maxSearchDist*/) { return VMAP_INVALID_CEIL_VALUE; }
 
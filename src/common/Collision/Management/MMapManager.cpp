@@ -22,11 +22,80 @@
 #include "Config.h"
 #include "MapDefines.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace MMAP
 {
     static char const* const MAP_FILE_NAME_FORMAT = "%s/mmaps/%03i.mmap";
     static char const* const TILE_FILE_NAME_FORMAT = "%s/mmaps/%03i%02i%02i.mmtile";
     static char const* const GAMEOBJECT_FILE_NAME_FORMAT = "%s/mmaps/go%04i.mmap";
+    static int32 const MAX_TILES_PER_AXIS = 64; // one tile per grid
+
+    // ######################## MMapTileFile ########################
+    MMapTileFile* MMapTileFile::Open(std::string const& fileName)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+            return nullptr;
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            return nullptr;
+        }
+
+        return new MMapTileFile((unsigned char*)data, size_t(fileSize.QuadPart), mapping);
+#else
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return nullptr;
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        void* data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return nullptr;
+
+        return new MMapTileFile((unsigned char*)data, size_t(fileStat.st_size), nullptr);
+#endif
+    }
+
+    MMapTileFile::~MMapTileFile()
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(_handle);
+#else
+        munmap(_data, _size);
+#endif
+    }
 
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
@@ -45,6 +114,28 @@ namespace MMAP
             loadedMMaps.insert(MMapDataSet::value_type(mapId, nullptr));
 
         thread_safe_environment = false;
+        useFileMapping = sConfigMgr->GetBoolDefault("MMap.UseFileMapping", true);
+    }
+
+    void MMapManager::PreloadMaps(const std::vector<uint32>& mapIds)
+    {
+        for (uint32 mapId : mapIds)
+        {
+            if (!loadMapData(mapId))
+            {
+                TC_LOG_ERROR("maps", "MMAP:PreloadMaps: Could not load mmap %03u", mapId);
+                continue;
+            }
+
+            uint32 count = 0;
+            for (int32 x = 0; x < MAX_TILES_PER_AXIS; ++x)
+                for (int32 y = 0; y < MAX_TILES_PER_AXIS; ++y)
+                    if (loadMap("", mapId, x, y))
+                        ++count;
+
+            loadedMMaps[mapId]->preloaded = true;
+            TC_LOG_INFO("maps", "MMAP:PreloadMaps: Preloaded %u tiles for map %03u", count, mapId);
+        }
     }
 
     MMapDataSet::const_iterator MMapManager::GetMMapData(uint32 mapId) const
@@ -128,23 +219,62 @@ namespace MMAP
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
-            return false;
+            return mmap->preloaded;
 
         // load this tile :: mmaps/MMMXXYY.mmtile
         std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, sConfigMgr->GetStringDefault("DataDir", ".").c_str(), mapId, x, y);
-        FILE* file = fopen(fileName.c_str(), "rb");
-        if (!file)
+
+        // map the whole file if possible and give detour a pointer past our header, or read it in a detour owned buffer
+        std::unique_ptr<MMapTileFile> tileFile(useFileMapping ? MMapTileFile::Open(fileName) : nullptr);
+        MmapTileHeader fileHeader;
+        unsigned char* data = nullptr;
+        if (tileFile)
         {
-            TC_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName.c_str());
-            return false;
+            if (tileFile->GetSize() < sizeof(MmapTileHeader))
+            {
+                TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                return false;
+            }
+
+            memcpy(&fileHeader, tileFile->GetData(), sizeof(MmapTileHeader));
         }
+        else
+        {
+            FILE* file = fopen(fileName.c_str(), "rb");
+            if (!file)
+            {
+                TC_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName.c_str());
+                return false;
+            }
 
-        // read header
-        MmapTileHeader fileHeader;
-        if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1 || fileHeader.mmapMagic != MMAP_MAGIC)
+            // read header
+            if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1)
+            {
+                TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                fclose(file);
+                return false;
+            }
+
+            if (fileHeader.mmapMagic == MMAP_MAGIC && fileHeader.mmapVersion == MMAP_VERSION)
+            {
+                data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+                ASSERT(data);
+
+                if (!fread(data, fileHeader.size, 1, file))
+                {
+                    TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                    dtFree(data);
+                    fclose(file);
+                    return false;
+                }
+            }
+
+            fclose(file);
+        }
+
+        if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
             return false;
         }
 
@@ -152,44 +282,63 @@ namespace MMAP
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                 mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        if (tileFile)
         {
-            TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
-        }
+            if (tileFile->GetSize() < sizeof(MmapTileHeader) + fileHeader.size)
+            {
+                TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                return false;
+            }
 
-        fclose(file);
+            data = tileFile->GetData() + sizeof(MmapTileHeader);
+        }
 
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
+        // memory read from file is managed by detour and will be deallocated when the tile is removed, mapped memory is ours
+        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, tileFile ? 0 : DT_TILE_FREE_DATA, 0, &tileRef)))
         {
             mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
             ++loadedTiles;
+            if (tileFile)
+            {
+                mmap->tileFiles[packedGridPos] = std::move(tileFile);
+                ++mappedTiles;
+            }
             TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %03i[%02i, %02i] into %03i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
             return true;
         }
         else
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (!tileFile)
+                dtFree(data);
             return false;
         }
 
         return false;
     }
 
+    bool MMapManager::removeTile(MMapData* mmap, uint32 packedGridPos, dtTileRef tileRef)
+    {
+        if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
+            return false;
+
+        auto itr = mmap->tileFiles.find(packedGridPos);
+        if (itr != mmap->tileFiles.end())
+        {
+            mmap->tileFiles.erase(itr);
+            --mappedTiles;
+        }
+
+        --loadedTiles;
+        return true;
+    }
+
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
@@ -212,10 +361,14 @@ namespace MMAP
             return false;
         }
 
+        // preloaded tiles are kept until shutdown
+        if (mmap->preloaded)
+            return false;
+
         dtTileRef tileRef = mmap->loadedTileRefs[packedGridPos];
 
         // unload, and mark as non loaded
-        if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
+        if (!removeTile(mmap, packedGridPos, tileRef))
         {
             // this is technically a memory leak
             // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
@@ -226,7 +379,6 @@ namespace MMAP
         else
         {
             mmap->loadedTileRefs.erase(packedGridPos);
-            --loadedTiles;
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %03i[%02i, %02i] from %03i", mapId, x, y, mapId);
             return true;
         }
@@ -246,15 +398,17 @@ namespace MMAP
 
         // unload all tiles from given map
         MMapData* mmap = itr->second;
+        if (mmap->preloaded)
+            return false;
+
         for (auto i = mmap->loadedTileRefs.begin(); i != mmap->loadedTileRefs.end(); ++i)
         {
             uint32 x = (i->first >> 16);
             uint32 y = (i->first & 0x0000FFFF);
-            if (dtStatusFailed(mmap->navMesh->removeTile(i->second, nullptr, nullptr)))
+            if (!removeTile(mmap, i->first, i->second))
                 TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload %03u%02i%02i.mmtile from navmesh", mapId, x, y);
             else
             {
-                --loadedTiles;
                 TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %03i[%02i, %02i] from %03i", mapId, x, y, mapId);
             }
         }
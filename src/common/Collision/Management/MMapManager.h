@@ -23,6 +23,7 @@
 #include "DetourAlloc.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,13 +31,36 @@
 //  move map related classes
 namespace MMAP
 {
+    // .mmtile file mapped in memory, data is given to detour without copy.
+    // Mapping is private copy-on-write: detour only writes tile polys and links when adding the tile, other
+    // pages (vertices, detail meshes, BV tree) stay shared with the system page cache.
+    class TC_COMMON_API MMapTileFile
+    {
+        public:
+            ~MMapTileFile();
+
+            // returns nullptr if the file could not be mapped
+            static MMapTileFile* Open(std::string const& fileName);
+
+            unsigned char* GetData() const { return _data; }
+            size_t GetSize() const { return _size; }
+
+        private:
+            MMapTileFile(unsigned char* data, size_t size, void* handle) : _data(data), _size(size), _handle(handle) { }
+
+            unsigned char* _data;
+            size_t _size;
+            void* _handle; // mapping handle, only used on Windows
+    };
+
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
+    typedef std::unordered_map<uint32, std::unique_ptr<MMapTileFile>> MMapTileFileSet;
     typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), preloaded(false) { }
         ~MMapData()
         {
             for (auto & navMeshQuerie : navMeshQueries)
@@ -44,6 +68,8 @@ namespace MMAP
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
+
+            // tiles files are unmapped after navMesh is freed
         }
 
         dtNavMesh* navMesh;
@@ -51,6 +77,8 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet loadedTileRefs;         // maps [map grid coords] to [dtTile]
+        MMapTileFileSet tileFiles;          // maps [map grid coords] to file mapping, for tiles not owned by detour
+        bool preloaded;                     // all tiles loaded at startup, never unload them
     };
 
 
@@ -61,10 +89,12 @@ namespace MMAP
     class TC_COMMON_API MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0), thread_safe_environment(true) {}
+            MMapManager() : loadedTiles(0), mappedTiles(0), thread_safe_environment(true), useFileMapping(true) {}
             ~MMapManager();
 
             void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
+            // load all tiles of given maps and keep them until shutdown
+            void PreloadMaps(const std::vector<uint32>& mapIds);
             bool loadMap(const std::string& basePath, uint32 mapId, int32 x, int32 y);
             bool loadGameObject(uint32 displayId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
@@ -77,16 +107,20 @@ namespace MMAP
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
+            uint32 getMappedTilesCount() const { return mappedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            bool removeTile(MMapData* mmap, uint32 packedGridPos, dtTileRef tileRef);
 
             MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
             MMapDataSet loadedModels;
             uint32 loadedTiles;
+            uint32 mappedTiles;
             bool thread_safe_environment;
+            bool useFileMapping;
     };
 }
 
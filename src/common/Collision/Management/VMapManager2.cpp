@@ -181,6 +181,28 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, LineOfSightRay* rays, size_t count, ModelIgnoreFlags ignoreFlags)
+    {
+        if (!isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            return;
+
+        auto instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            LineOfSightRay& ray = rays[i];
+            if (!ray.inLineOfSight)
+                continue;
+
+            Vector3 pos1 = convertPositionToInternalRep(ray.x1, ray.y1, ray.z1);
+            Vector3 pos2 = convertPositionToInternalRep(ray.x2, ray.y2, ray.z2);
+            if (pos1 != pos2)
+                ray.inLineOfSight = instanceTree->second->isInLineOfSight(pos1, pos2, ignoreFlags);
+        }
+    }
+
     /* same as getObjectHitPos but a bit more gentle, will try from a bit higher and return collision from there if it gets further */
     bool VMapManager2::getLeapHitPos(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist)
     {
@@ -422,6 +444,19 @@ namespace VMAP
         return model->second.getModel();
     }
 
+    void VMapManager2::preloadTileModels(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models)
+    {
+        std::string path = basePath;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\')
+            path.push_back('/');
+
+        std::vector<ModelSpawn> spawns;
+        StaticMapTree::ReadTileSpawns(path, mapId, x, y, spawns);
+        for (ModelSpawn const& spawn : spawns)
+            if (acquireModelInstance(path, spawn.name, spawn.flags))
+                models.push_back(spawn.name);
+    }
+
     void VMapManager2::releaseModelInstance(const std::string &filename)
     {
         //! Critical section, thread safe access to iLoadedModelFiles
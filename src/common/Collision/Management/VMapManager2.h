@@ -107,6 +107,7 @@ namespace VMAP
             void unloadMap(unsigned int mapId) override;
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) override;
+            void isInLineOfSight(unsigned int mapId, LineOfSightRay* rays, size_t count, ModelIgnoreFlags ignoreFlags) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -128,6 +129,10 @@ namespace VMAP
 
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags = 0);
             void releaseModelInstance(const std::string& filename);
+            // Load models used by given tile and keep a reference on them so that loading the tile later only has to link them.
+            // Acquired model names are added to <models>, caller must release them with releaseModelInstance.
+            // Can be called from any thread.
+            void preloadTileModels(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models);
 
             // what's the use of this? o.O
             std::string getDirFileName(unsigned int mapId, int /*x*/, int /*y*/) const override
@@ -463,6 +463,32 @@ namespace VMAP
 
     //=========================================================
 
+    bool StaticMapTree::ReadTileSpawns(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<ModelSpawn> &spawns)
+    {
+        std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
+        FILE* tf = fopen(tilefile.c_str(), "rb");
+        if (!tf)
+            return false;
+
+        char chunk[8];
+        bool result = readChunk(tf, chunk, VMAP_MAGIC, 8);
+        uint32 numSpawns = 0;
+        if (result && fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
+            result = false;
+        for (uint32 i = 0; i < numSpawns && result; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            result = ModelSpawn::readFromFile(tf, spawn) && fread(&referencedVal, sizeof(uint32), 1, tf) == 1;
+            if (result)
+                spawns.push_back(spawn);
+        }
+        fclose(tf);
+        return result;
+    }
+
+    //=========================================================
+
     void StaticMapTree::UnloadMapTile(uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
         uint32 tileID = packTileID(tileX, tileY);
@@ -5,10 +5,12 @@
 #include "Define.h"
 #include "BoundingIntervalHierarchy.h"
 #include <unordered_map>
+#include <vector>
 
 namespace VMAP
 {
     class ModelInstance;
+    class ModelSpawn;
     class GroupModel;
     class VMapManager2;
     enum class LoadResult : uint8;
@@ -54,6 +56,8 @@ namespace VMAP
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID>>16; tileY = ID&0xFF; }
             static LoadResult CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+            // read model spawns of a tile file without loading anything, basePath must end with a separator
+            static bool ReadTileSpawns(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<ModelSpawn> &spawns);
 
             StaticMapTree(uint32 mapID, std::string basePath);
             ~StaticMapTree();
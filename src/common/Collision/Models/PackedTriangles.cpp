@@ -0,0 +1,161 @@
+#include "PackedTriangles.h"
+#include "WorldModel.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VMAP_PACKED_TRIANGLES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace VMAP
+{
+    // Same as IntersectTriangle()
+    static const float PACKED_TRIANGLE_EPS = 1e-5f;
+    static const uint32 PACKED_TRIANGLE_WIDTH = 4;
+
+    void PackedTriangles::build(std::vector<G3D::Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, std::vector<uint32> const& order)
+    {
+        _count = uint32(order.size());
+        _stride = _count + PACKED_TRIANGLE_WIDTH - 1;
+        // degenerated padding triangles never hit
+        _data.assign(size_t(_stride) * MAX_COMPONENTS, 0.0f);
+
+        for (uint32 i = 0; i < _count; ++i)
+        {
+            MeshTriangle const& tri = triangles[order[i]];
+            G3D::Vector3 const& v0 = vertices[tri.idx0];
+            G3D::Vector3 const e1 = vertices[tri.idx1] - v0;
+            G3D::Vector3 const e2 = vertices[tri.idx2] - v0;
+
+            _data[V0_X * _stride + i] = v0.x;
+            _data[V0_Y * _stride + i] = v0.y;
+            _data[V0_Z * _stride + i] = v0.z;
+            _data[E1_X * _stride + i] = e1.x;
+            _data[E1_Y * _stride + i] = e1.y;
+            _data[E1_Z * _stride + i] = e1.z;
+            _data[E2_X * _stride + i] = e2.x;
+            _data[E2_Y * _stride + i] = e2.y;
+            _data[E2_Z * _stride + i] = e2.z;
+        }
+    }
+
+    void PackedTriangles::clear()
+    {
+        _data.clear();
+        _data.shrink_to_fit();
+        _count = 0;
+        _stride = 0;
+    }
+
+    bool PackedTriangles::IntersectRayScalar(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        G3D::Vector3 const& org = ray.origin();
+        G3D::Vector3 const& dir = ray.direction();
+        float const* v0x = get(V0_X); float const* v0y = get(V0_Y); float const* v0z = get(V0_Z);
+        float const* e1x = get(E1_X); float const* e1y = get(E1_Y); float const* e1z = get(E1_Z);
+        float const* e2x = get(E2_X); float const* e2y = get(E2_Y); float const* e2z = get(E2_Z);
+
+        bool hit = false;
+        for (uint32 i = first; i < first + count; ++i)
+        {
+            // p = dir x e2
+            float const px = dir.y * e2z[i] - dir.z * e2y[i];
+            float const py = dir.z * e2x[i] - dir.x * e2z[i];
+            float const pz = dir.x * e2y[i] - dir.y * e2x[i];
+            float const a = e1x[i] * px + e1y[i] * py + e1z[i] * pz;
+            if (std::fabs(a) < PACKED_TRIANGLE_EPS)
+                continue;
+
+            float const f = 1.0f / a;
+            float const sx = org.x - v0x[i];
+            float const sy = org.y - v0y[i];
+            float const sz = org.z - v0z[i];
+            float const u = f * (sx * px + sy * py + sz * pz);
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            // q = s x e1
+            float const qx = sy * e1z[i] - sz * e1y[i];
+            float const qy = sz * e1x[i] - sx * e1z[i];
+            float const qz = sx * e1y[i] - sy * e1x[i];
+            float const v = f * (dir.x * qx + dir.y * qy + dir.z * qz);
+            if (v < 0.0f || (u + v) > 1.0f)
+                continue;
+
+            float const t = f * (e2x[i] * qx + e2y[i] * qy + e2z[i] * qz);
+            if (t > 0.0f && t < distance)
+            {
+                distance = t;
+                hit = true;
+            }
+        }
+        return hit;
+    }
+
+#ifdef VMAP_PACKED_TRIANGLES_SSE2
+    bool PackedTriangles::IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        G3D::Vector3 const& org = ray.origin();
+        G3D::Vector3 const& dir = ray.direction();
+        __m128 const dx = _mm_set1_ps(dir.x), dy = _mm_set1_ps(dir.y), dz = _mm_set1_ps(dir.z);
+        __m128 const ox = _mm_set1_ps(org.x), oy = _mm_set1_ps(org.y), oz = _mm_set1_ps(org.z);
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const eps = _mm_set1_ps(PACKED_TRIANGLE_EPS);
+        __m128 const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 const laneIndex = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+        bool hit = false;
+        for (uint32 i = first; i < first + count; i += PACKED_TRIANGLE_WIDTH)
+        {
+            __m128 const e1x = _mm_loadu_ps(get(E1_X) + i), e1y = _mm_loadu_ps(get(E1_Y) + i), e1z = _mm_loadu_ps(get(E1_Z) + i);
+            __m128 const e2x = _mm_loadu_ps(get(E2_X) + i), e2y = _mm_loadu_ps(get(E2_Y) + i), e2z = _mm_loadu_ps(get(E2_Z) + i);
+
+            // p = dir x e2
+            __m128 const px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 const py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 const pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 const a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 reject = _mm_cmplt_ps(_mm_and_ps(a, absMask), eps);
+            // lanes past the range
+            reject = _mm_or_ps(reject, _mm_cmpge_ps(laneIndex, _mm_set1_ps(float(first + count - i))));
+            if (_mm_movemask_ps(reject) == 0xF)
+                continue;
+
+            __m128 const f = _mm_div_ps(one, a);
+            __m128 const sx = _mm_sub_ps(ox, _mm_loadu_ps(get(V0_X) + i));
+            __m128 const sy = _mm_sub_ps(oy, _mm_loadu_ps(get(V0_Y) + i));
+            __m128 const sz = _mm_sub_ps(oz, _mm_loadu_ps(get(V0_Z) + i));
+            __m128 const u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            reject = _mm_or_ps(reject, _mm_or_ps(_mm_cmplt_ps(u, zero), _mm_cmpgt_ps(u, one)));
+
+            // q = s x e1
+            __m128 const qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 const qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 const qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 const v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            reject = _mm_or_ps(reject, _mm_or_ps(_mm_cmplt_ps(v, zero), _mm_cmpgt_ps(_mm_add_ps(u, v), one)));
+
+            __m128 const t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            __m128 const dist = _mm_set1_ps(distance);
+            __m128 const accept = _mm_andnot_ps(reject, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, dist)));
+            if (!_mm_movemask_ps(accept))
+                continue;
+
+            // closest accepted hit
+            __m128 closest = _mm_or_ps(_mm_and_ps(accept, t), _mm_andnot_ps(accept, dist));
+            closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(2, 3, 0, 1)));
+            closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(1, 0, 3, 2)));
+            distance = _mm_cvtss_f32(closest);
+            hit = true;
+        }
+        return hit;
+    }
+#else
+    bool PackedTriangles::IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        return IntersectRayScalar(ray, first, count, distance);
+    }
+#endif
+} // namespace VMAP
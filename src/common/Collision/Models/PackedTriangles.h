@@ -0,0 +1,51 @@
+#ifndef _PACKEDTRIANGLES_H
+#define _PACKEDTRIANGLES_H
+
+#include "Define.h"
+
+#include <G3D/Vector3.h>
+#include <G3D/Ray.h>
+#include <vector>
+
+namespace VMAP
+{
+    class MeshTriangle;
+
+    /**
+    Triangles of a mesh stored as structure of arrays (first vertex and both edges, one array per coordinate),
+    so that consecutive triangles can be tested against a ray with SIMD instructions (4 at a time with SSE2).
+    Triangles are stored in BIH object order, a BIH leaf is a range of consecutive triangles.
+    Results are the same as IntersectTriangle() for each triangle of the range.
+    */
+    class TC_COMMON_API PackedTriangles
+    {
+        public:
+            // order: mesh triangle index for each packed triangle (BIH::getObjects())
+            void build(std::vector<G3D::Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, std::vector<uint32> const& order);
+            void clear();
+            uint32 size() const { return _count; }
+
+            // Tests triangles [first, first + count) against ray. Returns true and set distance to the closest hit if one is closer than distance.
+            bool IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const;
+            // Same without SIMD instructions
+            bool IntersectRayScalar(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const;
+
+        private:
+            enum Component
+            {
+                V0_X, V0_Y, V0_Z,
+                E1_X, E1_Y, E1_Z,
+                E2_X, E2_Y, E2_Z,
+                MAX_COMPONENTS
+            };
+
+            float const* get(Component component) const { return &_data[component * _stride]; }
+
+            // all components in a single buffer, each one padded so that a range can always be loaded by 4
+            std::vector<float> _data;
+            uint32 _count = 0;
+            uint32 _stride = 0;
+    };
+} // namespace VMAP
+
+#endif // _PACKEDTRIANGLES_H
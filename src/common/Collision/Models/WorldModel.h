@@ -9,6 +9,7 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include "BoundingIntervalHierarchy.h"
+#include "PackedTriangles.h"
 
 namespace VMAP
 {
@@ -84,6 +85,7 @@ namespace VMAP
             std::vector<G3D::Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            PackedTriangles packedTriangles; //!< triangles in meshTree order, used for ray intersections
             WmoLiquid* iLiquid;
     };
     /*! Holds a model (converted M2 or WMO) in its original coordinate space */
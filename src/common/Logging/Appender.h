@@ -42,6 +42,8 @@ class TC_COMMON_API Appender
         void write(LogMessage* message);
         static char const* getLogLevelString(LogLevel level);
         virtual void setRealmId(uint32 /*realmId*/) { }
+        // Write buffered messages, called by the logger thread when logging is asynchronous
+        virtual void flush() { }
 
     private:
         virtual void _write(LogMessage const* /*message*/) = 0;
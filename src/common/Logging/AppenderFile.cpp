@@ -20,6 +20,9 @@
 #include "LogMessage.h"
 #include <algorithm>
 
+// Buffered messages are written as soon as they reach this size, without waiting for Log flush interval
+size_t const LOG_FILE_BUFFER_SIZE = 64 * 1024;
+
 AppenderFile::AppenderFile(uint8 id, std::string const& name, LogLevel level, AppenderFlags flags, std::vector<char const*> extraArgs) :
     Appender(id, name, level, flags),
     logfile(nullptr),
@@ -84,11 +87,34 @@ void AppenderFile::_write(LogMessage const* message)
     if (!logfile)
         return;
 
-    fprintf(logfile, "%s%s\n", message->prefix.c_str(), message->text.c_str());
-    fflush(logfile);
+    if (sLog->IsAsynchronous())
+    {
+        // only the logger thread writes in asynchronous mode, one fwrite for the whole batch when flushed
+        _buffer.append(message->prefix).append(message->text).push_back('\n');
+        if (_buffer.size() >= LOG_FILE_BUFFER_SIZE)
+            flush();
+    }
+    else
+    {
+        fprintf(logfile, "%s%s\n", message->prefix.c_str(), message->text.c_str());
+        fflush(logfile);
+    }
     _fileSize += uint64(message->Size());
 }
 
+void AppenderFile::flush()
+{
+    if (_buffer.empty())
+        return;
+
+    if (logfile)
+    {
+        fwrite(_buffer.data(), 1, _buffer.size(), logfile);
+        fflush(logfile);
+    }
+    _buffer.clear();
+}
+
 FILE* AppenderFile::OpenFile(std::string const& filename, std::string const& mode, bool backup)
 {
     std::string fullName(_logDir + filename);
@@ -113,6 +139,7 @@ FILE* AppenderFile::OpenFile(std::string const& filename, std::string const& mod
 
 void AppenderFile::CloseFile()
 {
+    flush();
     if (logfile)
     {
         fclose(logfile);
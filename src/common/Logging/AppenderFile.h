@@ -30,6 +30,7 @@ class TC_COMMON_API AppenderFile : public Appender
         ~AppenderFile();
         FILE* OpenFile(std::string const& name, std::string const& mode, bool backup);
         AppenderType getType() const override { return TypeIndex::value; }
+        void flush() override;
 
     private:
         void CloseFile();
@@ -41,6 +42,8 @@ class TC_COMMON_API AppenderFile : public Appender
         bool _backup;
         uint64 _maxFileSize;
         std::atomic<uint64> _fileSize;
+        // messages written by the logger thread, waiting for next flush
+        std::string _buffer;
 };
 
 #endif
@@ -24,13 +24,18 @@
 #include "Errors.h"
 #include "Logger.h"
 #include "LogMessage.h"
-#include "LogOperation.h"
-#include "Strand.h"
+#include "LogQueue.h"
 #include "Util.h"
 #include <chrono>
 #include <sstream>
 
-Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL), _ioContext(nullptr), _strand(nullptr)
+// Messages written by the logger thread before checking flush interval
+uint32 const LOG_THREAD_BATCH_SIZE = 256;
+// Max wait of the logger thread when the queue is empty. Producers only wake it up if it's sleeping, which is racy, this bounds the delay of a missed wake up.
+uint32 const LOG_THREAD_IDLE_WAIT = 100;
+
+Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL), _queueFullPolicy(LOG_QUEUE_FULL_DROP), _flushInterval(1000),
+    _loggerThreadStop(false), _loggerThreadSleeping(false), _asyncQueued(0), _asyncDropped(0), _asyncWaited(0), _asyncFlushes(0)
 {
     m_logsTimestamp = "_" + GetTimestampStr();
     RegisterAppender<AppenderConsole>();
@@ -39,7 +44,7 @@ Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL), _ioContext(nullptr)
 
 Log::~Log()
 {
-    delete _strand;
+    SetSynchronous();
     Close();
 }
 
@@ -216,25 +221,139 @@ void Log::RegisterAppender(uint8 index, AppenderCreatorFn appenderCreateFn)
 
 void Log::outMessage(std::string const& filter, LogLevel level, std::string&& message)
 {
-    write(Trinity::make_unique<LogMessage>(level, filter, std::move(message)));
+    write(level, filter, std::move(message));
 }
 
 void Log::outCommand(std::string&& message, std::string&& param1)
 {
-    write(Trinity::make_unique<LogMessage>(LOG_LEVEL_INFO, "commands.gm", std::move(message), std::move(param1)));
+    write(LOG_LEVEL_INFO, "commands.gm", std::move(message), std::move(param1));
 }
 
-void Log::write(std::unique_ptr<LogMessage>&& msg) const
+void Log::write(LogLevel level, std::string const& type, std::string&& text, std::string&& param1)
 {
-    Logger const* logger = GetLoggerByType(msg->type);
+    // logger thread logging itself (appenders errors...) must not wait for its own queue
+    if (!_queue || std::this_thread::get_id() == _loggerThread.get_id())
+    {
+        LogMessage msg(level, type, std::move(text), std::move(param1));
+        write(&msg);
+        return;
+    }
+
+    if (!_queue->TryPush(level, type, std::move(text), std::move(param1)))
+    {
+        if (_queueFullPolicy == LOG_QUEUE_FULL_DROP && level < LOG_LEVEL_ERROR)
+        {
+            ++_asyncDropped;
+            return;
+        }
+
+        ++_asyncWaited;
+        do
+        {
+            _loggerThreadCondition.notify_one();
+            std::this_thread::yield();
+        } while (!_queue->TryPush(level, type, std::move(text), std::move(param1)));
+    }
+    ++_asyncQueued;
 
-    if (_ioContext)
+    if (_loggerThreadSleeping)
     {
-        std::shared_ptr<LogOperation> logOperation = std::make_shared<LogOperation>(logger, std::move(msg));
-        Trinity::Asio::post(*_ioContext, Trinity::Asio::bind_executor(*_strand, [logOperation]() { logOperation->call(); }));
+        std::lock_guard<std::mutex> lock(_loggerThreadLock);
+        _loggerThreadCondition.notify_one();
     }
-    else
-        logger->write(msg.get());
+}
+
+void Log::write(LogMessage* msg) const
+{
+    if (Logger const* logger = GetLoggerByType(msg->type))
+        logger->write(msg);
+}
+
+void Log::StartLoggerThread()
+{
+    _loggerThreadStop = false;
+    _loggerThread = std::thread(&Log::LoggerThread, this);
+}
+
+void Log::StopLoggerThread()
+{
+    if (!_loggerThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_loggerThreadLock);
+        _loggerThreadStop = true;
+    }
+    _loggerThreadCondition.notify_one();
+    _loggerThread.join();
+}
+
+void Log::LoggerThread()
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point lastFlush = Clock::now();
+    bool pendingFlush = false;
+
+    while (true)
+    {
+        uint32 count = 0;
+        bool urgent = false;
+        while (count < LOG_THREAD_BATCH_SIZE)
+        {
+            std::unique_ptr<LogMessage> msg = _queue->Pop();
+            if (!msg)
+                break;
+
+            urgent |= msg->level >= LOG_LEVEL_ERROR;
+            write(msg.get());
+            ++count;
+        }
+        pendingFlush |= count != 0;
+
+        Clock::time_point now = Clock::now();
+        uint32 sinceFlush = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastFlush).count());
+        if (pendingFlush && (urgent || sinceFlush >= _flushInterval))
+        {
+            FlushAppenders();
+            lastFlush = now;
+            pendingFlush = false;
+            sinceFlush = 0;
+        }
+
+        if (count)
+            continue;
+
+        std::unique_lock<std::mutex> lock(_loggerThreadLock);
+        if (_loggerThreadStop)
+            break;
+
+        uint32 wait = pendingFlush ? std::min(_flushInterval - std::min(sinceFlush, _flushInterval), LOG_THREAD_IDLE_WAIT) : LOG_THREAD_IDLE_WAIT;
+        _loggerThreadSleeping = true;
+        if (_queue->Empty())
+            _loggerThreadCondition.wait_for(lock, std::chrono::milliseconds(std::max(wait, 1u)));
+        _loggerThreadSleeping = false;
+    }
+
+    // messages queued after stop was requested stay in queue, they're written when thread is restarted
+    FlushAppenders();
+}
+
+void Log::FlushAppenders()
+{
+    for (auto& appender : appenders)
+        appender.second->flush();
+    ++_asyncFlushes;
+}
+
+LogAsyncStats Log::GetAsyncStats() const
+{
+    LogAsyncStats stats;
+    stats.queued = _asyncQueued;
+    stats.dropped = _asyncDropped;
+    stats.waited = _asyncWaited;
+    stats.flushes = _asyncFlushes;
+    stats.capacity = _queue ? _queue->GetCapacity() : 0;
+    return stats;
 }
 
 Logger const* Log::GetLoggerByType(std::string const& type) const
@@ -312,13 +431,10 @@ void Log::outCharDump(char const* str, uint32 accountId, uint64 guid, char const
     ss << "== START DUMP == (account: " << accountId << " guid: " << guid << " name: " << name
        << ")\n" << str << "\n== END DUMP ==\n";
 
-    std::unique_ptr<LogMessage> msg(new LogMessage(LOG_LEVEL_INFO, "entities.player.dump", ss.str()));
     std::ostringstream param;
     param << guid << '_' << name;
 
-    msg->param1 = param.str();
-
-    write(std::move(msg));
+    write(LOG_LEVEL_INFO, "entities.player.dump", ss.str(), param.str());
 }
 
 void Log::SetRealmId(uint32 id)
@@ -357,26 +473,33 @@ Log* Log::instance()
     return &instance;
 }
 
-void Log::Initialize(Trinity::Asio::IoContext* ioContext)
+void Log::Initialize(bool asynchronous)
 {
-    if (ioContext)
-    {
-        _ioContext = ioContext;
-        _strand = new Trinity::Asio::Strand(*ioContext);
-    }
+    if (asynchronous)
+        _queue = Trinity::make_unique<LogQueue>(std::max(sConfigMgr->GetIntDefault("Log.Async.QueueSize", 8192), 16));
 
     LoadFromConfig();
 }
 
 void Log::SetSynchronous()
 {
-    delete _strand;
-    _strand = nullptr;
-    _ioContext = nullptr;
+    if (!_queue)
+        return;
+
+    StopLoggerThread();
+    // nothing can be queued anymore, all other threads are joined
+    while (std::unique_ptr<LogMessage> msg = _queue->Pop())
+        write(msg.get());
+    FlushAppenders();
+    _queue.reset();
 }
 
 void Log::LoadFromConfig()
 {
+    // logger thread uses appenders and loggers, stop it while they're recreated
+    if (_queue)
+        StopLoggerThread();
+
     Close();
 
     lowestLogLevel = LOG_LEVEL_FATAL;
@@ -388,4 +511,11 @@ void Log::LoadFromConfig()
 
     ReadAppendersFromConfig();
     ReadLoggersFromConfig();
+
+    if (_queue)
+    {
+        _flushInterval = uint32(std::max(sConfigMgr->GetIntDefault("Log.Async.FlushInterval", 1000), 1));
+        _queueFullPolicy = sConfigMgr->GetIntDefault("Log.Async.QueueFullPolicy", 0) ? LOG_QUEUE_FULL_WAIT : LOG_QUEUE_FULL_DROP;
+        StartLoggerThread();
+    }
 }
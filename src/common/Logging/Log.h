@@ -20,27 +20,39 @@
 #define TRINITYCORE_LOG_H
 
 #include "Define.h"
-#include "AsioHacksFwd.h"
 #include "LogCommon.h"
 #include "StringFormat.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 class Appender;
 class Logger;
+class LogQueue;
 struct LogMessage;
 
-namespace Trinity
+#define LOGGER_ROOT "root"
+
+// What producers do when the asynchronous log queue is full
+enum LogQueueFullPolicy
 {
-    namespace Asio
-    {
-        class IoContext;
-    }
-}
+    LOG_QUEUE_FULL_DROP = 0, // drop the message, errors and fatal messages still wait
+    LOG_QUEUE_FULL_WAIT = 1, // wait for the logger thread to free a record
+};
 
-#define LOGGER_ROOT "root"
+struct LogAsyncStats
+{
+    uint64 queued  = 0; // messages queued since async logging start
+    uint64 dropped = 0; // messages dropped because the queue was full
+    uint64 waited  = 0; // messages which waited for a free record
+    uint64 flushes = 0; // appenders buffers flushes
+    size_t capacity = 0;
+};
 
 typedef Appender*(*AppenderCreatorFn)(uint8 id, std::string const& name, LogLevel level, AppenderFlags flags, std::vector<char const*>&& extraArgs);
 
@@ -65,8 +77,11 @@ class TC_COMMON_API Log
     public:
         static Log* instance();
 
-        void Initialize(Trinity::Asio::IoContext* ioContext);
+        // With asynchronous set, messages are queued in a preallocated ring and written by a dedicated logger thread
+        void Initialize(bool asynchronous);
         void SetSynchronous();  // Not threadsafe - should only be called from main() after all threads are joined
+        bool IsAsynchronous() const { return _queue != nullptr; }
+        LogAsyncStats GetAsyncStats() const;
         void LoadFromConfig();
         void Close();
         bool ShouldLog(std::string const& type, LogLevel level) const;
@@ -103,7 +118,8 @@ class TC_COMMON_API Log
 
     private:
         static std::string GetTimestampStr();
-        void write(std::unique_ptr<LogMessage>&& msg) const;
+        void write(LogLevel level, std::string const& type, std::string&& text, std::string&& param1 = std::string());
+        void write(LogMessage* msg) const;
 
         Logger const* GetLoggerByType(std::string const& type) const;
         Appender* GetAppenderByName(std::string const& name);
@@ -116,6 +132,12 @@ class TC_COMMON_API Log
         void outMessage(std::string const& filter, LogLevel level, std::string&& message);
         void outCommand(std::string&& message, std::string&& param1);
 
+        void StartLoggerThread();
+        // Write all queued messages, flush appenders and join logger thread
+        void StopLoggerThread();
+        void LoggerThread();
+        void FlushAppenders();
+
         std::unordered_map<uint8, AppenderCreatorFn> appenderFactory;
         std::unordered_map<uint8, std::unique_ptr<Appender>> appenders;
         std::unordered_map<std::string, std::unique_ptr<Logger>> loggers;
@@ -125,8 +147,20 @@ class TC_COMMON_API Log
         std::string m_logsDir;
         std::string m_logsTimestamp;
 
-        Trinity::Asio::IoContext* _ioContext;
-        Trinity::Asio::Strand* _strand;
+        std::unique_ptr<LogQueue> _queue;
+        LogQueueFullPolicy _queueFullPolicy;
+        uint32 _flushInterval;
+        std::thread _loggerThread;
+        std::atomic<bool> _loggerThreadStop;
+        // producers only wake up the logger thread if it's waiting for messages
+        std::atomic<bool> _loggerThreadSleeping;
+        std::mutex _loggerThreadLock;
+        std::condition_variable _loggerThreadCondition;
+
+        std::atomic<uint64> _asyncQueued;
+        std::atomic<uint64> _asyncDropped;
+        std::atomic<uint64> _asyncWaited;
+        std::atomic<uint64> _asyncFlushes;
 };
 
 #define sLog Log::instance()
@@ -0,0 +1,77 @@
+
+#include "LogQueue.h"
+#include "LogMessage.h"
+#include <cstring>
+
+LogQueue::LogQueue(size_t capacity) : _mask(0), _enqueuePos(0), _dequeuePos(0)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    _records.reset(new Record[size]);
+    _mask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+        _records[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+LogQueue::~LogQueue() { }
+
+bool LogQueue::TryPush(LogLevel level, std::string const& type, std::string&& text, std::string&& param1)
+{
+    Record* record;
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        record = &_records[pos & _mask];
+        size_t seq = record->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0)
+        {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false; // consumer has not freed this record yet, queue is full
+        else
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    record->level = level;
+    record->mtime = time(nullptr);
+    if (param1.empty() && type.size() + text.size() <= LOG_RECORD_DATA_SIZE)
+    {
+        record->typeSize = uint16(type.size());
+        record->textSize = uint16(text.size());
+        memcpy(record->data, type.data(), type.size());
+        memcpy(record->data + type.size(), text.data(), text.size());
+    }
+    else
+        record->overflow.reset(new LogMessage(level, type, std::move(text), std::move(param1)));
+
+    record->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+std::unique_ptr<LogMessage> LogQueue::Pop()
+{
+    Record& record = _records[_dequeuePos & _mask];
+    if (record.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+        return nullptr;
+
+    std::unique_ptr<LogMessage> message = std::move(record.overflow);
+    if (!message)
+        message.reset(new LogMessage(record.level, std::string(record.data, record.typeSize),
+            std::string(record.data + record.typeSize, record.textSize)));
+    message->mtime = record.mtime;
+
+    // free the record for next lap
+    record.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+    ++_dequeuePos;
+    return message;
+}
+
+bool LogQueue::Empty() const
+{
+    return _records[_dequeuePos & _mask].sequence.load(std::memory_order_acquire) != _dequeuePos + 1;
+}
@@ -0,0 +1,61 @@
+
+#ifndef LogQueue_h__
+#define LogQueue_h__
+
+#include "Define.h"
+#include "LogCommon.h"
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <string>
+
+struct LogMessage;
+
+// Bytes available in a record for message type + text. Longer messages are stored in a separately allocated LogMessage.
+#define LOG_RECORD_DATA_SIZE 448
+
+/**
+Bounded multiple producers / single consumer queue of fixed size log records, all allocated at creation.
+Producers copy message type and text into a free record, the logger thread builds the LogMessage from it.
+Each record holds a sequence number telling whether it's free or filled for the current lap over the buffer,
+so that producers only contend on the enqueue position (see D. Vyukov bounded MPMC queue).
+*/
+class TC_COMMON_API LogQueue
+{
+    public:
+        explicit LogQueue(size_t capacity); // rounded up to a power of 2
+        ~LogQueue();
+
+        // Returns false if the queue is full. Strings are only moved from if the message was queued.
+        bool TryPush(LogLevel level, std::string const& type, std::string&& text, std::string&& param1);
+        // Single consumer only. Returns nullptr if the queue is empty.
+        std::unique_ptr<LogMessage> Pop();
+
+        // Single consumer only
+        bool Empty() const;
+        size_t GetCapacity() const { return _mask + 1; }
+
+    private:
+        struct Record
+        {
+            std::atomic<size_t> sequence;
+            LogLevel level;
+            time_t mtime;
+            uint16 typeSize;
+            uint16 textSize;
+            std::unique_ptr<LogMessage> overflow;
+            char data[LOG_RECORD_DATA_SIZE];
+        };
+
+        LogQueue(LogQueue const&) = delete;
+        LogQueue& operator=(LogQueue const&) = delete;
+
+        std::unique_ptr<Record[]> _records;
+        size_t _mask;
+
+        // keep producers and consumer positions on different cache lines
+        alignas(64) std::atomic<size_t> _enqueuePos;
+        alignas(64) size_t _dequeuePos;
+};
+
+#endif // LogQueue_h__
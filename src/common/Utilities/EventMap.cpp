@@ -19,6 +19,9 @@
 #include "Random.h"
 #include "Errors.h"
 
+#include <algorithm>
+#include <limits>
+
 void EventMap::Reset()
 {
     _eventMap.clear();
@@ -49,7 +52,7 @@ void EventMap::ScheduleEvent(uint32 eventId, uint32 time, uint32 group /*= 0*/,
     if (phase && phase <= 8)
         eventId |= (1 << (phase + 23));
 
-    _eventMap.insert(EventStore::value_type(_time + time, eventId));
+    Insert(_time + time, eventId);
 }
 
 void EventMap::RescheduleEvent(uint32 eventId, Milliseconds minTime, Milliseconds maxTime, uint32 group /*= 0*/, uint32 phase /*= 0*/)
@@ -66,18 +69,16 @@ uint32 EventMap::ExecuteEvent()
 {
     while (!Empty())
     {
-        EventStore::iterator itr = _eventMap.begin();
+        ScheduledEvent const next = _eventMap.back();
 
-        if (itr->first > _time)
+        if (next.time > _time)
             return 0;
-        else if (_phase && (itr->second & 0xFF000000) && !((itr->second >> 24) & _phase))
-            _eventMap.erase(itr);
-        else
+
+        _eventMap.pop_back();
+        if (!_phase || !(next.data & 0xFF000000) || ((next.data >> 24) & _phase))
         {
-            uint32 eventId = (itr->second & 0x0000FFFF);
-            _lastEvent = itr->second; // include phase/group
-            _eventMap.erase(itr);
-            return eventId;
+            _lastEvent = next.data; // include phase/group
+            return (next.data & 0x0000FFFF);
         }
     }
 
@@ -89,20 +90,18 @@ void EventMap::DelayEvents(uint32 delay, uint32 group)
     if (!group || group > 8 || Empty())
         return;
 
+    // in occurrence order
     EventStore delayed;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+        if (itr->data & (1 << (group + 15)))
+            delayed.push_back({ itr->time + delay, itr->data });
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
-    {
-        if (itr->second & (1 << (group + 15)))
-        {
-            delayed.insert(EventStore::value_type(itr->first + delay, itr->second));
-            _eventMap.erase(itr++);
-        }
-        else
-            ++itr;
-    }
+    if (delayed.empty())
+        return;
 
-    _eventMap.insert(delayed.begin(), delayed.end());
+    CancelEventGroup(group);
+    for (ScheduledEvent const& event : delayed)
+        Insert(event.time, event.data);
 }
 
 void EventMap::SetMinimalDelay(uint32 eventId, uint32 delay)
@@ -110,20 +109,21 @@ void EventMap::SetMinimalDelay(uint32 eventId, uint32 delay)
     if (Empty())
         return;
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
-    {
-        if (eventId == (itr->second & 0x0000FFFF))
-        {
-            if (itr->first < delay)
-            {
-                _eventMap.insert(EventStore::value_type(delay, itr->second));
-                itr = _eventMap.erase(itr);
-                continue;
-            }
+    // in occurrence order
+    EventStore delayed;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+        if (eventId == (itr->data & 0x0000FFFF) && itr->time < delay)
+            delayed.push_back({ delay, itr->data });
 
-        }
-        itr++;
-    }
+    if (delayed.empty())
+        return;
+
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [eventId, delay](ScheduledEvent const& event)
+    {
+        return eventId == (event.data & 0x0000FFFF) && event.time < delay;
+    }), _eventMap.end());
+    for (ScheduledEvent const& event : delayed)
+        Insert(event.time, event.data);
 }
 
 void EventMap::CancelEvent(uint32 eventId)
@@ -131,13 +131,10 @@ void EventMap::CancelEvent(uint32 eventId)
     if (Empty())
         return;
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [eventId](ScheduledEvent const& event)
     {
-        if (eventId == (itr->second & 0x0000FFFF))
-            _eventMap.erase(itr++);
-        else
-            ++itr;
-    }
+        return eventId == (event.data & 0x0000FFFF);
+    }), _eventMap.end());
 }
 
 void EventMap::CancelEventGroup(uint32 group)
@@ -145,13 +142,10 @@ void EventMap::CancelEventGroup(uint32 group)
     if (!group || group > 8 || Empty())
         return;
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [group](ScheduledEvent const& event)
     {
-        if (itr->second & (1 << (group + 15)))
-            _eventMap.erase(itr++);
-        else
-            ++itr;
-    }
+        return (event.data & (1 << (group + 15))) != 0;
+    }), _eventMap.end());
 }
 
 uint32 EventMap::GetNextEventTime(uint32 eventId) const
@@ -159,18 +153,28 @@ uint32 EventMap::GetNextEventTime(uint32 eventId) const
     if (Empty())
         return 0;
 
-    for (EventStore::const_iterator itr = _eventMap.begin(); itr != _eventMap.end(); ++itr)
-        if (eventId == (itr->second & 0x0000FFFF))
-            return itr->first;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+        if (eventId == (itr->data & 0x0000FFFF))
+            return itr->time;
 
     return 0;
 }
 
 uint32 EventMap::GetTimeUntilEvent(uint32 eventId) const
 {
-    for (EventStore::const_iterator itr = _eventMap.begin(); itr != _eventMap.end(); ++itr)
-        if (eventId == (itr->second & 0x0000FFFF))
-            return itr->first - _time;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+        if (eventId == (itr->data & 0x0000FFFF))
+            return itr->time - _time;
 
     return std::numeric_limits<uint32>::max();
 }
+
+void EventMap::Insert(uint32 time, uint32 data)
+{
+    // before the events of the same time, which occur first
+    auto itr = std::lower_bound(_eventMap.begin(), _eventMap.end(), time, [](ScheduledEvent const& event, uint32 time)
+    {
+        return event.time > time;
+    });
+    _eventMap.insert(itr, { time, data });
+}
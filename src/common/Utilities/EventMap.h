@@ -20,14 +20,14 @@
 
 #include "Define.h"
 #include "Duration.h"
-#include <map>
+#include <vector>
 
 class TC_COMMON_API EventMap
 {
     /**
     * Internal storage type.
-    * Key: Time as uint32 when the event should occur.
-    * Value: The event data as uint32.
+    * time: Time as uint32 when the event should occur.
+    * data: The event data as uint32.
     *
     * Structure of event data:
     * - Bit  0 - 15: Event Id.
@@ -35,7 +35,17 @@ class TC_COMMON_API EventMap
     * - Bit 24 - 31: Phase
     * - Pattern: 0xPPGGEEEE
     */
-    typedef std::multimap<uint32, uint32> EventStore;
+    struct ScheduledEvent
+    {
+        uint32 time;
+        uint32 data;
+    };
+
+    /**
+    * Scheduled events sorted by decreasing time, the next event is at the back.
+    * Events scheduled at the same time occur in scheduling order.
+    */
+    typedef std::vector<ScheduledEvent> EventStore;
 
 public:
     EventMap() : _time(0), _phase(0), _lastEvent(0) { }
@@ -201,7 +211,7 @@ public:
     */
     void Repeat(uint32 time)
     {
-        _eventMap.insert(EventStore::value_type(_time + time, _lastEvent));
+        Insert(_time + time, _lastEvent);
     }
 
     /**
@@ -303,7 +313,7 @@ public:
     */
     uint32 GetNextEventTime() const
     {
-        return Empty() ? 0 : _eventMap.begin()->first;
+        return Empty() ? 0 : _eventMap.back().time;
     }
 
     /**
@@ -326,6 +336,14 @@ public:
     uint32 GetTimeUntilEvent(uint32 eventId) const;
 
 private:
+    /**
+    * @name Insert
+    * @brief Adds an event to the storage, after the events scheduled at the same time.
+    * @param time Time when the event occurs.
+    * @param data Event data, see EventStore.
+    */
+    void Insert(uint32 time, uint32 data);
+
     /**
     * @name _time
     * @brief Internal timer.
@@ -350,7 +368,7 @@ private:
 
     /**
     * @name _eventMap
-    * @brief Internal event storage map. Contains the scheduled events.
+    * @brief Internal event storage. Contains the scheduled events, its capacity is kept on Reset.
     *
     * See typedef at the beginning of the class for more
     * details.
@@ -2,6 +2,8 @@
 #include "EventProcessor.h"
 #include "Errors.h"
 
+#include <algorithm>
+
 void BasicEvent::ScheduleAbort()
 {
     ASSERT(IsRunning()
@@ -17,9 +19,24 @@ void BasicEvent::SetAborted()
 }
 
 
+namespace
+{
+    // Heap ordering, the event executing first is the greatest
+    struct ExecutesLater
+    {
+        bool operator()(QueuedEvent const& left, QueuedEvent const& right) const
+        {
+            if (left.execTime != right.execTime)
+                return left.execTime > right.execTime;
+            return left.sequence > right.sequence;
+        }
+    };
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_sequence = 0;
     m_aborting = false;
 }
 
@@ -34,12 +51,11 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
+        BasicEvent* event = m_events.front().event;
+        PopEvent();
 
         if (event->IsRunning())
         {
@@ -75,35 +91,42 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    EventList events;
+    EventList kept;
+    // events added by Abort() calls are handled in a next pass
+    while (!m_events.empty())
     {
-        // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
-        {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
-        }
+        events.clear();
+        events.swap(m_events);
+        // abort events in execution order
+        std::sort(events.begin(), events.end(), [](QueuedEvent const& left, QueuedEvent const& right) { return ExecutesLater()(right, left); });
 
-        // Skip non-deletable events when we are
-        // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
+        for (QueuedEvent const& queued : events)
         {
-            ++itr;
-            continue;
-        }
+            // Abort events which weren't aborted already
+            if (!queued.event->IsAborted())
+            {
+                queued.event->SetAborted();
+                queued.event->Abort(m_time);
+            }
 
-        delete itr->second;
+            // Skip non-deletable events when we are
+            // not forcing the event cancellation.
+            if (!force && !queued.event->IsDeletable())
+            {
+                kept.push_back(queued);
+                continue;
+            }
 
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
+            delete queued.event;
+        }
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    // keep the allocated storage for next events
+    events.clear();
+    m_events.swap(events);
+    m_events.insert(m_events.end(), kept.begin(), kept.end());
+    RebuildQueue();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -111,23 +134,42 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     if (set_addtime)
         Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    PushEvent(Event, e_time);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 newTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
+    for (QueuedEvent& queued : m_events)
     {
-        if (itr->second != Event)
+        if (queued.event != Event)
             continue;
 
         Event->m_execTime = newTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(newTime, Event));
+        // same as a new insertion
+        queued.execTime = newTime;
+        queued.sequence = m_sequence++;
+        RebuildQueue();
         break;
     }
 }
 
+void EventProcessor::PushEvent(BasicEvent* event, uint64 e_time)
+{
+    m_events.push_back({ e_time, m_sequence++, event });
+    std::push_heap(m_events.begin(), m_events.end(), ExecutesLater());
+}
+
+void EventProcessor::PopEvent()
+{
+    std::pop_heap(m_events.begin(), m_events.end(), ExecutesLater());
+    m_events.pop_back();
+}
+
+void EventProcessor::RebuildQueue()
+{
+    std::make_heap(m_events.begin(), m_events.end(), ExecutesLater());
+}
+
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return(m_time + t_offset);
@@ -23,7 +23,7 @@
 #include "Random.h"
 #include "advstd.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -88,7 +88,15 @@ private:
 template<typename T>
 using is_lambda_event = std::enable_if_t<!advstd::is_base_of_v<BasicEvent, std::remove_pointer_t<advstd::remove_cvref_t<T>>>>;
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+struct QueuedEvent
+{
+    uint64 execTime;
+    uint64 sequence;                                        // insertion order, events planned at the same time execute in this order
+    BasicEvent* event;
+};
+
+// Binary heap on (execTime, sequence), the next event to execute is at the front
+typedef std::vector<QueuedEvent> EventList;
 
 class TC_COMMON_API EventProcessor
 {
@@ -112,8 +120,15 @@ class TC_COMMON_API EventProcessor
         void ModifyEventTime(BasicEvent* Event, uint64 newTime);
         uint64 CalculateTime(uint64 t_offset) const;
         uint64 CalculateQueueTime(uint64 delay) const;
+        bool Empty() const { return m_events.empty(); }
     protected:
+        void PushEvent(BasicEvent* event, uint64 e_time);
+        void PopEvent();
+        // Restores events ordering after m_events was modified directly
+        void RebuildQueue();
+
         uint64 m_time;
+        uint64 m_sequence;
         EventList m_events;
         bool m_aborting;
 };
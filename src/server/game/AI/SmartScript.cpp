@@ -18,6 +18,7 @@
 #include "SmartScript.h"
 #include "CellImpl.h"
 #include "ChatTextBuilder.h"
+#include "ConditionMgr.h"
 #include "Creature.h"
 #include "CreatureTextMgr.h"
 #include "GameEventMgr.h"
@@ -213,16 +214,32 @@ void SmartScript::ResetBaseObject()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    if (e == SMART_EVENT_LINK || e >= SMART_EVENT_END || mEventIndexOffsets.empty()) //links have special handling
+        return;
+
+    // bounds are read again at each iteration, the index may be rebuilt by a processed event
+    for (uint32 i = mEventIndexOffsets[e]; i < mEventIndexOffsets[e + 1]; ++i)
     {
-        SMART_EVENT eventType = SMART_EVENT(i->GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+        SmartScriptHolder& holder = mEvents[mEventIndexes[i]];
+        if (IsMeetingEventConditions(holder, unit))
+            ProcessEvent(holder, unit, var0, var1, bvar, spell, gob);
+    }
+}
 
-        if (eventType == e)
-            if (sConditionMgr->IsObjectMeetingSmartEventConditions(i->entryOrGuid, i->event_id, i->source_type, unit, GetBaseObject()))
-                ProcessEvent(*i, unit, var0, var1, bvar, spell, gob);
+bool SmartScript::IsMeetingEventConditions(SmartScriptHolder& e, Unit* unit)
+{
+    uint32 const generation = sConditionMgr->GetLoadGeneration();
+    if (e.conditionsGeneration != generation) // conditions were reloaded since we resolved them
+    {
+        e.conditions = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
+        e.conditionsGeneration = generation;
     }
+
+    if (!e.conditions)
+        return true;
+
+    ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+    return sConditionMgr->IsObjectMeetToConditions(sourceInfo, *e.conditions);
 }
 
 void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
@@ -2303,7 +2320,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
     // We may want to execute action rarely and because of this if condition is not fulfilled the action will be rechecked in a long time
-    if (sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject()))
+    if (IsMeetingEventConditions(e, unit))
     {
         RecalcTimer(e, min, max);
         ProcessAction(e, unit, var0, var1, bvar, spell, gob);
@@ -3370,24 +3387,38 @@ void SmartScript::InitTimer(SmartScriptHolder& e)
         case SMART_EVENT_UPDATE:
         case SMART_EVENT_UPDATE_IC:
         case SMART_EVENT_UPDATE_OOC:
-            RecalcTimer(e, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
+            RandomizeTimer(e, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
             break;
         case SMART_EVENT_DISTANCE_CREATURE:
         case SMART_EVENT_DISTANCE_GAMEOBJECT:
-            RecalcTimer(e, e.event.distance.repeat, e.event.distance.repeat);
+            RandomizeTimer(e, e.event.distance.repeat, e.event.distance.repeat);
             break;
         default:
             e.active = true;
             break;
     }
 }
-void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
+
+/*static*/ void SmartScript::RandomizeTimer(SmartScriptHolder& e, uint32 min, uint32 max)
 {
     // min/max was checked at loading!
     e.timer = urand(min, max);
     e.active = e.timer ? false : true;
 }
 
+void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
+{
+    RandomizeTimer(e, min, max);
+
+    // timed events are always updated, others only while their cooldown is running. Stored events and timed action lists are updated separately.
+    if (!e.active && e.GetEventType() != SMART_EVENT_LINK && !IsTimedEventType(e.GetEventType()) && !mEvents.empty() && &e >= &mEvents.front() && &e <= &mEvents.back())
+    {
+        uint32 const index = uint32(&e - mEvents.data());
+        if (std::find(mCooldownEvents.begin(), mCooldownEvents.end(), index) == mCooldownEvents.end())
+            mCooldownEvents.push_back(index);
+    }
+}
+
 void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
 {
     if (e.GetEventType() == SMART_EVENT_LINK)
@@ -3428,54 +3459,61 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
         }
 
         e.active = true;//activate events with cooldown
-        switch (e.GetEventType())//process ONLY timed events
-        {
-            case SMART_EVENT_UPDATE:
-            case SMART_EVENT_UPDATE_OOC:
-            case SMART_EVENT_UPDATE_IC:
-            case SMART_EVENT_HEALTH_PCT:
-            case SMART_EVENT_TARGET_HEALTH_PCT:
-            case SMART_EVENT_MANA_PCT:
-            case SMART_EVENT_TARGET_MANA_PCT:
-            case SMART_EVENT_RANGE:
-            case SMART_EVENT_VICTIM_CASTING:
-            case SMART_EVENT_FRIENDLY_HEALTH:
-            case SMART_EVENT_FRIENDLY_IS_CC:
-            case SMART_EVENT_FRIENDLY_MISSING_BUFF:
-            case SMART_EVENT_HAS_AURA:
-            case SMART_EVENT_TARGET_BUFFED:
-            case SMART_EVENT_IS_BEHIND_TARGET:
-            case SMART_EVENT_FRIENDLY_HEALTH_PCT:
-            case SMART_EVENT_DISTANCE_CREATURE:
-            case SMART_EVENT_DISTANCE_GAMEOBJECT:
-            {
-                if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
-                {
-                    Unit* invoker = nullptr;
-                    if (me && mTimedActionListInvoker)
-                        invoker = ObjectAccessor::GetUnit(*me, mTimedActionListInvoker);
-                    ProcessEvent(e, invoker);
-                    e.enableTimed = false;//disable event if it is in an ActionList and was processed once
-                    for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+        if (IsTimedEventType(e.GetEventType()))//process ONLY timed events
+        {
+            if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
+            {
+                Unit* invoker = nullptr;
+                if (me && mTimedActionListInvoker)
+                    invoker = ObjectAccessor::GetUnit(*me, mTimedActionListInvoker);
+                ProcessEvent(e, invoker);
+                e.enableTimed = false;//disable event if it is in an ActionList and was processed once
+                for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+                {
+                    //find the first event which is not the current one and enable it
+                    if (i->event_id > e.event_id)
                     {
-                        //find the first event which is not the current one and enable it
-                        if (i->event_id > e.event_id)
-                        {
-                            i->enableTimed = true;
-                            break;
-                        }
+                        i->enableTimed = true;
+                        break;
                     }
                 }
-                else
-                    ProcessEvent(e);
-                break;
             }
+            else
+                ProcessEvent(e);
         }
     }
     else
         e.timer -= diff;
 }
 
+/*static*/ bool SmartScript::IsTimedEventType(uint32 eventType)
+{
+    switch (eventType)
+    {
+        case SMART_EVENT_UPDATE:
+        case SMART_EVENT_UPDATE_OOC:
+        case SMART_EVENT_UPDATE_IC:
+        case SMART_EVENT_HEALTH_PCT:
+        case SMART_EVENT_TARGET_HEALTH_PCT:
+        case SMART_EVENT_MANA_PCT:
+        case SMART_EVENT_TARGET_MANA_PCT:
+        case SMART_EVENT_RANGE:
+        case SMART_EVENT_VICTIM_CASTING:
+        case SMART_EVENT_FRIENDLY_HEALTH:
+        case SMART_EVENT_FRIENDLY_IS_CC:
+        case SMART_EVENT_FRIENDLY_MISSING_BUFF:
+        case SMART_EVENT_HAS_AURA:
+        case SMART_EVENT_TARGET_BUFFED:
+        case SMART_EVENT_IS_BEHIND_TARGET:
+        case SMART_EVENT_FRIENDLY_HEALTH_PCT:
+        case SMART_EVENT_DISTANCE_CREATURE:
+        case SMART_EVENT_DISTANCE_GAMEOBJECT:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool SmartScript::CheckTimer(SmartScriptHolder const& e) const
 {
     return e.active;
@@ -3489,9 +3527,38 @@ void SmartScript::InstallEvents()
             mEvents.push_back(*i);//must be before UpdateTimers
 
         mInstallEvents.clear();
+        BuildEventIndex();
     }
 }
 
+void SmartScript::BuildEventIndex()
+{
+    // counting sort of mEvents indexes by event type, keeping mEvents order within a type
+    mEventIndexOffsets.assign(SMART_EVENT_END + 1, 0);
+    for (SmartScriptHolder const& e : mEvents)
+        if (e.GetEventType() < SMART_EVENT_END)
+            ++mEventIndexOffsets[e.GetEventType() + 1];
+
+    for (uint32 type = 0; type < SMART_EVENT_END; ++type)
+        mEventIndexOffsets[type + 1] += mEventIndexOffsets[type];
+
+    std::vector<uint32> next(mEventIndexOffsets.begin(), mEventIndexOffsets.end() - 1);
+    mEventIndexes.resize(mEventIndexOffsets[SMART_EVENT_END]);
+    mTimedEvents.clear();
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+    {
+        uint32 const type = mEvents[i].GetEventType();
+        if (type >= SMART_EVENT_END)
+            continue;
+
+        mEventIndexes[next[type]++] = i;
+        if (IsTimedEventType(type))
+            mTimedEvents.push_back(i);
+    }
+
+    // events are only appended, cooldown indexes are still valid
+}
+
 void SmartScript::RemoveStoredEvent(uint32 id)
 {
     if (!mStoredEvents.empty())
@@ -3555,8 +3622,22 @@ void SmartScript::OnUpdate(uint32 const diff)
 
     InstallEvents();//before UpdateTimers
 
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
-        UpdateTimer(*i, diff);
+    // by index, processed events may add cooldowns
+    for (uint32 i = 0; i < mTimedEvents.size(); ++i)
+        UpdateTimer(mEvents[mTimedEvents[i]], diff);
+
+    for (uint32 i = 0; i < mCooldownEvents.size();)
+    {
+        SmartScriptHolder& e = mEvents[mCooldownEvents[i]];
+        UpdateTimer(e, diff);
+        if (e.active) // cooldown is over, timer updates are no-op until next RecalcTimer
+        {
+            mCooldownEvents[i] = mCooldownEvents.back();
+            mCooldownEvents.pop_back();
+        }
+        else
+            ++i;
+    }
 
     if (!mStoredEvents.empty())
     {
@@ -3639,6 +3720,8 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
         }
         mEvents.push_back((*i));//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+
+    BuildEventIndex();
 }
 
 void SmartScript::GetScript()
@@ -42,7 +42,8 @@ class TC_GAME_API SmartScript
         void ProcessEventsFor(SMART_EVENT e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
         void ProcessEvent(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
         bool CheckTimer(SmartScriptHolder const& e) const;
-        static void RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max);
+        void RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max);
+        static void RandomizeTimer(SmartScriptHolder& e, uint32 min, uint32 max);
         void UpdateTimer(SmartScriptHolder& e, uint32 const diff);
         static void InitTimer(SmartScriptHolder& e);
         void ProcessAction(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
@@ -100,6 +101,13 @@ class TC_GAME_API SmartScript
         bool IsInPhase(uint32 p) const;
 
         SmartAIEventList mEvents;
+        // mEvents indexes grouped by event type: events of type t are mEventIndexes[mEventIndexOffsets[t]] to mEventIndexes[mEventIndexOffsets[t + 1] - 1]
+        std::vector<uint32> mEventIndexes;
+        std::vector<uint32> mEventIndexOffsets;
+        // mEvents indexes of events processed by UpdateTimer
+        std::vector<uint32> mTimedEvents;
+        // mEvents indexes of other events with a cooldown running
+        std::vector<uint32> mCooldownEvents;
         SmartAIEventList mInstallEvents;
         SmartAIEventList mTimedActionList;
         ObjectGuid mTimedActionListInvoker;
@@ -125,6 +133,11 @@ class TC_GAME_API SmartScript
 
         SMARTAI_TEMPLATE mTemplate;
         void InstallEvents();
+        // Rebuild mEvents indexes, must be called whenever events are added to mEvents
+        void BuildEventIndex();
+        // Only these event types are processed when their timer expires, other events timer is a cooldown
+        static bool IsTimedEventType(uint32 eventType);
+        bool IsMeetingEventConditions(SmartScriptHolder& e, Unit* unit);
 
         void RemoveStoredEvent(uint32 id);
 };
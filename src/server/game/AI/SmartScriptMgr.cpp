@@ -16,6 +16,7 @@
  */
 
 #include "SmartScriptMgr.h"
+#include "ConditionMgr.h"
 #include "CreatureTextMgr.h"
 #include "DatabaseEnv.h"
 #include "DBCStores.h"
@@ -336,6 +337,10 @@ void SmartAIMgr::LoadSmartAIFromDB()
             SmartAIEventList eventList;
             mEventMap[source_type][temp.entryOrGuid] = eventList;
         }
+        // conditions are loaded before smart scripts
+        temp.conditions = sConditionMgr->GetConditionsForSmartEvent(temp.entryOrGuid, temp.event_id, temp.source_type);
+        temp.conditionsGeneration = sConditionMgr->GetLoadGeneration();
+
         // store the new event
         mEventMap[source_type][temp.entryOrGuid].push_back(temp);
     }
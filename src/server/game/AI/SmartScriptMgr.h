@@ -24,6 +24,9 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+struct Condition;
 
 #define SMARTAI_AI_NAME "SmartAI"
 #define SMARTAI_GOBJECT_AI_NAME "SmartGameObjectAI"
@@ -1510,7 +1513,7 @@ struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE)
         , event_id(0), link(0), event(), action(), target(), timer(0), active(false), runOnce(false)
-        , enableTimed(false) { }
+        , enableTimed(false), conditions(nullptr), conditionsGeneration(0) { }
 
     int32 entryOrGuid;
     SmartScriptType source_type;
@@ -1531,6 +1534,10 @@ struct SmartScriptHolder
     bool runOnce;
     bool enableTimed;
 
+    // conditions of this event, nullptr if none. Resolved at load and again when ConditionMgr::GetLoadGeneration() changes.
+    std::vector<Condition*> const* conditions;
+    uint32 conditionsGeneration;
+
     operator bool() const { return entryOrGuid != 0; }
 };
 
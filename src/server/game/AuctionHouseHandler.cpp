@@ -360,7 +360,7 @@ void WorldSession::HandleAuctionPlaceBid( WorldPacket & recvData )
         {
             pl->ModifyMoney( -int32(price) );
         }
-        auction->bidder = pl->GetGUID().GetCounter();
+        auctionHouse->SetBidder(auction, pl->GetGUID().GetCounter());
         auction->bid = price;
 
         // after this update we should save player's money ...
@@ -379,7 +379,7 @@ void WorldSession::HandleAuctionPlaceBid( WorldPacket & recvData )
             if (auction->bidder)                          //buyout for bidded auction ..
                 sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, GetPlayer(), trans);
         }
-        auction->bidder = pl->GetGUID().GetCounter();
+        auctionHouse->SetBidder(auction, pl->GetGUID().GetCounter());
         auction->bid = auction->buyout;
 
         sAuctionMgr->SendAuctionSalePendingMail(auction, trans);
@@ -587,10 +587,25 @@ void WorldSession::HandleAuctionListItems( WorldPacket & recvData )
 
     //TC_LOG_DEBUG("auctionHouse","Auctionhouse search guid: " UI64FMTD ", list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u", guid, listfrom, searchedname.c_str(), levelmin, levelmax, auctionSlotID, auctionMainCategory, auctionSubCategory, quality, usable);
 
-    WorldPacket data( SMSG_AUCTION_LIST_RESULT, (4+4+4) );
-    uint32 count = 0;
-    uint32 totalcount = 0;
-    data << (uint32) 0;
+    if (uint32 maxSearches = sWorld->getIntConfig(CONFIG_AUCTION_SEARCH_RATE_LIMIT))
+    {
+        time_t now = WorldGameTime::GetGameTime();
+        if (now >= _auctionSearchWindowStart + MINUTE)
+        {
+            _auctionSearchWindowStart = now;
+            _auctionSearchWindowCount = 0;
+        }
+
+        if (_auctionSearchWindowCount >= maxSearches)
+        {
+            ++_auctionSearchThrottledCount;
+            sAuctionMgr->GetSearcher().SearchThrottled();
+            TC_LOG_DEBUG("auction", "HandleAuctionListItems - Account %u exceeded %u searches per minute, search ignored", GetAccountId(), maxSearches);
+            return;
+        }
+        ++_auctionSearchWindowCount;
+    }
+    ++_auctionSearchCount;
 
     // converting string that we try to find to lower case
     std::wstring wsearchedname;
@@ -599,6 +614,31 @@ void WorldSession::HandleAuctionListItems( WorldPacket & recvData )
 
     wstrToLower(wsearchedname);
 
+    if (sAuctionMgr->GetSearcher().activated())
+    {
+        AuctionSearchParams params;
+        params.searchedName = std::move(wsearchedname);
+        params.locale = GetSessionDbLocaleIndex();
+        params.levelmin = levelmin;
+        params.levelmax = levelmax;
+        params.inventoryType = auctionSlotID;
+        params.itemClass = auctionMainCategory;
+        params.itemSubClass = auctionSubCategory;
+        params.quality = quality;
+
+        // a newer search replaces the pending one, client only displays the last result anyway
+        _auctionSearch.result = sAuctionMgr->GetSearcher().Search(auctionHouse->GetSearchSnapshot(), std::move(params));
+        _auctionSearch.auctionHouse = auctionHouse;
+        _auctionSearch.listfrom = listfrom;
+        _auctionSearch.usable = usable;
+        return;
+    }
+
+    WorldPacket data( SMSG_AUCTION_LIST_RESULT, (4+4+4) );
+    uint32 count = 0;
+    uint32 totalcount = 0;
+    data << (uint32) 0;
+
     auctionHouse->BuildListAuctionItems(data,_player,
         wsearchedname, listfrom, levelmin, levelmax, usable,
         auctionSlotID, auctionMainCategory, auctionSubCategory, quality,
@@ -610,3 +650,26 @@ void WorldSession::HandleAuctionListItems( WorldPacket & recvData )
     SendPacket(&data);
 }
 
+
+void WorldSession::ProcessAuctionSearchCallback()
+{
+    if (!_auctionSearch.result.valid() || _auctionSearch.result.wait_for(0s) != std::future_status::ready)
+        return;
+
+    std::vector<uint32> auctionIds = _auctionSearch.result.get();
+    if (!_player || !_player->IsInWorld())
+        return;
+
+    WorldPacket data( SMSG_AUCTION_LIST_RESULT, (4+4+4) );
+    uint32 count = 0;
+    uint32 totalcount = 0;
+    data << (uint32) 0;
+
+    _auctionSearch.auctionHouse->BuildListAuctionItems(data, _player, auctionIds,
+        _auctionSearch.listfrom, _auctionSearch.usable, count, totalcount);
+
+    data.put<uint32>(0, count);
+    data << (uint32) totalcount;
+    data << (uint32) 300;                                   // unk 2.3.0 const?
+    SendPacket(&data);
+}
@@ -407,6 +407,69 @@ void AuctionHouseMgr::RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::Low
     mNeutralAuctions.RemoveAllAuctionsOf(trans, ownerGUID);
 }
 
+std::wstring const& AuctionHouseMgr::GetNormalizedItemName(ItemTemplate const* proto, LocaleConstant locale) const
+{
+    if (locale >= TOTAL_LOCALES)
+        locale = DEFAULT_LOCALE;
+
+    auto itr = mNormalizedItemNames[locale].find(proto->ItemId);
+    if (itr != mNormalizedItemNames[locale].end())
+        return itr->second;
+
+    // not translated in this locale
+    if (locale != DEFAULT_LOCALE)
+    {
+        itr = mNormalizedItemNames[DEFAULT_LOCALE].find(proto->ItemId);
+        if (itr != mNormalizedItemNames[DEFAULT_LOCALE].end())
+            return itr->second;
+    }
+
+    static std::wstring const noName;
+    return noName;
+}
+
+void AuctionHouseMgr::LoadNormalizedItemNames()
+{
+    uint32 oldMSTime = GetMSTime();
+
+    auto normalize = [](std::string const& name)
+    {
+        std::wstring wname;
+        if (Utf8toWStr(name, wname))
+            wstrToLower(wname);
+        else
+            wname.clear();
+        return wname;
+    };
+
+    for (auto& names : mNormalizedItemNames)
+        names.clear();
+
+    // same name selection as WorldSession::GetLocalizedItemName
+    uint32 count = 0;
+    for (auto const& itr : sObjectMgr->GetItemTemplateStore())
+    {
+        ItemTemplate const& proto = itr.second;
+        mNormalizedItemNames[DEFAULT_LOCALE][proto.ItemId] = normalize(proto.Name1);
+        ++count;
+
+        ItemLocale const* il = sObjectMgr->GetItemLocale(proto.ItemId);
+        if (!il)
+            continue;
+
+        for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+        {
+            if (locale == DEFAULT_LOCALE || il->Name.size() <= size_t(locale) || il->Name[locale].empty())
+                continue;
+
+            mNormalizedItemNames[locale][proto.ItemId] = normalize(il->Name[locale]);
+            ++count;
+        }
+    }
+
+    TC_LOG_INFO("server.loading", ">> Normalized %u item names for auction searches in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
+}
+
 AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(uint32 factionTemplateId)
 {
     uint32 houseid = 7; // goblin auction house
@@ -447,41 +510,139 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(uint32 factionTem
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+void AuctionHouseObject::IndexInsert(AuctionsByGuidMap& index, uint32 key, uint32 id)
+{
+    index[key].insert(id);
+}
+
+void AuctionHouseObject::IndexErase(AuctionsByGuidMap& index, uint32 key, uint32 id)
+{
+    auto itr = index.find(key);
+    if (itr == index.end())
+        return;
+
+    itr->second.erase(id);
+    if (itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouseObject::AddAuction(AuctionEntry *ah)
+{
+    ASSERT( ah );
+    ASSERT( AuctionsMap.find(ah->Id) == AuctionsMap.end() );
+    AuctionsMap[ah->Id] = ah;
+
+    _expiryQueue.emplace(ah->expire_time, ah->Id);
+    IndexInsert(_auctionsByOwner, ah->owner, ah->Id);
+    if (ah->bidder)
+        IndexInsert(_auctionsByBidder, ah->bidder, ah->Id);
+
+    if (ItemTemplate const* proto = sObjectMgr->GetItemTemplate(ah->itemEntry))
+    {
+        _auctionsByClass[std::make_pair(proto->Class, proto->SubClass)].insert(ah->Id);
+        _auctionsByLevel[proto->RequiredLevel].insert(ah->Id);
+        _dirtySearchBuckets.insert(GetSearchBucketKey(proto));
+    }
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    auto itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    AuctionEntry const* ah = itr->second;
+    // expiry queue entry is dropped lazily in Update
+    IndexErase(_auctionsByOwner, ah->owner, id);
+    if (ah->bidder)
+        IndexErase(_auctionsByBidder, ah->bidder, id);
+
+    if (ItemTemplate const* proto = sObjectMgr->GetItemTemplate(ah->itemEntry))
+    {
+        auto classItr = _auctionsByClass.find(std::make_pair(proto->Class, proto->SubClass));
+        if (classItr != _auctionsByClass.end())
+        {
+            classItr->second.erase(id);
+            if (classItr->second.empty())
+                _auctionsByClass.erase(classItr);
+        }
+
+        auto levelItr = _auctionsByLevel.find(proto->RequiredLevel);
+        if (levelItr != _auctionsByLevel.end())
+        {
+            levelItr->second.erase(id);
+            if (levelItr->second.empty())
+                _auctionsByLevel.erase(levelItr);
+        }
+
+        _dirtySearchBuckets.insert(GetSearchBucketKey(proto));
+    }
+
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::SetBidder(AuctionEntry* auction, uint32 bidder)
+{
+    ASSERT(auction);
+    if (auction->bidder == bidder)
+        return;
+
+    if (AuctionsMap.find(auction->Id) != AuctionsMap.end())
+    {
+        if (auction->bidder)
+            IndexErase(_auctionsByBidder, auction->bidder, auction->Id);
+        if (bidder)
+            IndexInsert(_auctionsByBidder, bidder, auction->Id);
+    }
+
+    auction->bidder = bidder;
+}
+
+void AuctionHouseObject::CloseAuction(AuctionEntry* auction, SQLTransaction& trans)
+{
+    ///- Either cancel the auction if there was no bidder
+    if (auction->bidder == 0)
+    {
+        sAuctionMgr->SendAuctionExpiredMail(auction, trans);
+    }
+    ///- Or perform the transaction
+    else
+    {
+        //we should send an "item sold" message if the seller is online
+        //we send the item to the winner
+        //we send the money to the seller
+        sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
+        sAuctionMgr->SendAuctionWonMail(auction, trans);
+    }
+
+    ///- In any case clear the auction
+    auction->DeleteFromDB(trans);
+
+    sAuctionMgr->RemoveAItem(auction->itemGUIDLow);
+    RemoveAuction(auction->Id);
+    delete auction;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = WorldGameTime::GetGameTime();
+    if (_expiryQueue.empty() || curTime <= _expiryQueue.top().first)
+        return;
+
     ///- Handle expired auctions
-    AuctionEntryMap::iterator next;
     SQLTransaction trans = CharacterDatabase.BeginTransaction();
-    for (auto itr = AuctionsMap.begin(); itr != AuctionsMap.end();itr = next)
+    while (!_expiryQueue.empty() && curTime > _expiryQueue.top().first)
     {
-        next = itr;
-        ++next;
-        if (curTime > (itr->second->expire_time))
-        {
-            ///- Either cancel the auction if there was no bidder
-            if (itr->second->bidder == 0)
-            {
-                sAuctionMgr->SendAuctionExpiredMail(itr->second, trans);
-            }
-            ///- Or perform the transaction
-            else
-            {
-                //we should send an "item sold" message if the seller is online
-                //we send the item to the winner
-                //we send the money to the seller
-                sAuctionMgr->SendAuctionSuccessfulMail(itr->second, trans);
-                sAuctionMgr->SendAuctionWonMail(itr->second, trans);
-            }
+        ExpiryEntry const top = _expiryQueue.top();
+        _expiryQueue.pop();
 
-            ///- In any case clear the auction
-            itr->second->DeleteFromDB(trans);
+        // auction may have been bought or cancelled since it was queued
+        AuctionEntry* auction = GetAuction(top.second);
+        if (!auction || auction->expire_time != top.first)
+            continue;
 
-            sAuctionMgr->RemoveAItem(itr->second->itemGUIDLow);
-            delete itr->second;
-            itr->second = nullptr;
-            RemoveAuction(itr->first);
-        }
+        CloseAuction(auction, trans);
     }
     if(trans->GetSize()) //Sun: don't commit empty transaction
         CharacterDatabase.CommitTransaction(trans);
@@ -490,81 +651,92 @@ void AuctionHouseObject::Update()
 // NOT threadsafe!
 void AuctionHouseObject::RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::LowType ownerGUID)
 {
-    AuctionEntryMap::iterator next;
-    for (auto itr = AuctionsMap.begin(); itr != AuctionsMap.end();itr = next)
-    {
-        next = itr;
-        ++next;
-        if (itr->second->owner == ownerGUID)
-        {
-            ///- Either cancel the auction if there was no bidder
-            if (itr->second->bidder == 0)
-            {
-                sAuctionMgr->SendAuctionExpiredMail(itr->second, trans);
-            }
-            ///- Or perform the transaction
-            else
-            {
-                //we should send an "item sold" message if the seller is online
-                //we send the item to the winner
-                //we send the money to the seller
-                sAuctionMgr->SendAuctionSuccessfulMail(itr->second, trans);
-                sAuctionMgr->SendAuctionWonMail(itr->second, trans);
-            }
-
-            ///- In any case clear the auction
-            itr->second->DeleteFromDB(trans);
-
-            sAuctionMgr->RemoveAItem(itr->second->itemGUIDLow);
-            delete itr->second;
-            itr->second = nullptr;
+    auto itr = _auctionsByOwner.find(ownerGUID);
+    if (itr == _auctionsByOwner.end())
+        return;
 
-            RemoveAuction(itr->first);
-        }
-    }
+    // copy, CloseAuction alters the index
+    std::vector<uint32> ids(itr->second.begin(), itr->second.end());
+    for (uint32 id : ids)
+        if (AuctionEntry* auction = GetAuction(id))
+            CloseAuction(auction, trans);
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin();itr != AuctionsMap.end();++itr)
+    auto itr = _auctionsByBidder.find(player->GetGUID().GetCounter());
+    if (itr == _auctionsByBidder.end())
+        return;
+
+    for (uint32 id : itr->second)
     {
-        AuctionEntry *Aentry = itr->second;
-        if( Aentry && Aentry->bidder == player->GetGUID().GetCounter() )
-        {
-            if (itr->second->BuildAuctionInfo(data))
-                ++count;
-            ++totalcount;
-        }
+        AuctionEntry *Aentry = GetAuction(id);
+        if (!Aentry)
+            continue;
+
+        if (Aentry->BuildAuctionInfo(data))
+            ++count;
+        ++totalcount;
     }
 }
 
 void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin();itr != AuctionsMap.end();++itr)
+    auto itr = _auctionsByOwner.find(player->GetGUID().GetCounter());
+    if (itr == _auctionsByOwner.end())
+        return;
+
+    for (uint32 id : itr->second)
     {
-        AuctionEntry *Aentry = itr->second;
-        if( Aentry && Aentry->owner == player->GetGUID().GetCounter() )
-        {
-            if(Aentry->BuildAuctionInfo(data))
-                ++count;
-            ++totalcount;
+        AuctionEntry *Aentry = GetAuction(id);
+        if (!Aentry)
+            continue;
 
-            if(totalcount >= MAX_AUCTIONS) //avoid client crash
-                break;
-        }
+        if(Aentry->BuildAuctionInfo(data))
+            ++count;
+        ++totalcount;
+
+        if(totalcount >= MAX_AUCTIONS) //avoid client crash
+            break;
     }
 }
 
 uint32 AuctionHouseObject::GetAuctionsCount(Player* player)
 {
-    uint32 totalcount = 0;
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin();itr != AuctionsMap.end();++itr)
+    auto itr = _auctionsByOwner.find(player->GetGUID().GetCounter());
+    return itr != _auctionsByOwner.end() ? uint32(itr->second.size()) : 0;
+}
+
+bool AuctionHouseObject::GetSearchCandidates(std::vector<uint32>& candidates, uint32 levelmin, uint32 levelmax, uint32 itemClass, uint32 itemSubClass) const
+{
+    if (itemClass != (0xffffffff))
+    {
+        if (itemSubClass != (0xffffffff))
+        {
+            auto itr = _auctionsByClass.find(std::make_pair(itemClass, itemSubClass));
+            if (itr != _auctionsByClass.end())
+                candidates.assign(itr->second.begin(), itr->second.end());
+            return true;
+        }
+
+        auto begin = _auctionsByClass.lower_bound(std::make_pair(itemClass, uint32(0)));
+        auto end = _auctionsByClass.upper_bound(std::make_pair(itemClass, uint32(0xffffffff)));
+        for (auto itr = begin; itr != end; ++itr)
+            candidates.insert(candidates.end(), itr->second.begin(), itr->second.end());
+    }
+    else if (levelmin || levelmax)
     {
-        AuctionEntry *Aentry = itr->second;
-        if( Aentry && Aentry->owner == player->GetGUID().GetCounter() )
-            ++totalcount;
+        auto begin = _auctionsByLevel.lower_bound(levelmin);
+        auto end = levelmax ? _auctionsByLevel.upper_bound(levelmax) : _auctionsByLevel.end();
+        for (auto itr = begin; itr != end; ++itr)
+            candidates.insert(candidates.end(), itr->second.begin(), itr->second.end());
     }
-    return totalcount;
+    else
+        return false;
+
+    // several buckets were merged, restore id order so that listfrom keeps pointing at the same results
+    std::sort(candidates.begin(), candidates.end());
+    return true;
 }
 
 void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
@@ -572,50 +744,135 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
     uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
     uint32& count, uint32& totalcount)
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin();itr != AuctionsMap.end();++itr)
+    AuctionSearchParams params;
+    params.searchedName = wsearchedname;
+    params.locale = player->GetSession()->GetSessionDbLocaleIndex();
+    params.levelmin = levelmin;
+    params.levelmax = levelmax;
+    params.inventoryType = inventoryType;
+    params.itemClass = itemClass;
+    params.itemSubClass = itemSubClass;
+    params.quality = quality;
+
+    auto checkAuction = [&](AuctionEntry* Aentry)
     {
-        AuctionEntry *Aentry = itr->second;
         Item *item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
         if (!item)
-            continue;
+            return;
 
-        ItemTemplate const *proto = item->GetTemplate();
+        if (!params.Match(item->GetTemplate()))
+            return;
 
-        if (itemClass != (0xffffffff) && proto->Class != itemClass)
-            continue;
+        AddSearchResult(data, player, Aentry, item, listfrom, usable, count, totalcount);
+    };
 
-        if (itemSubClass != (0xffffffff) && proto->SubClass != itemSubClass)
-            continue;
+    std::vector<uint32> candidates;
+    if (GetSearchCandidates(candidates, levelmin, levelmax, itemClass, itemSubClass))
+    {
+        for (uint32 id : candidates)
+            if (AuctionEntry* Aentry = GetAuction(id))
+                checkAuction(Aentry);
+    }
+    else
+    {
+        for (auto const& itr : AuctionsMap)
+            checkAuction(itr.second);
+    }
+}
 
-        if (inventoryType != (0xffffffff) && proto->InventoryType != inventoryType)
+void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player, std::vector<uint32> const& auctionIds,
+    uint32 listfrom, uint32 usable, uint32& count, uint32& totalcount)
+{
+    for (uint32 id : auctionIds)
+    {
+        AuctionEntry* Aentry = GetAuction(id);
+        if (!Aentry)
             continue;
 
-        if (quality != (0xffffffff) && proto->Quality != quality)
+        Item *item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
+        if (!item)
             continue;
 
-        if(    ( levelmin && (proto->RequiredLevel < levelmin) )
-            || ( levelmax && (proto->RequiredLevel > levelmax) ) 
-          )
-            continue;
+        AddSearchResult(data, player, Aentry, item, listfrom, usable, count, totalcount);
+    }
+}
 
-        if( usable != (0x00) && player->CanUseItem( item ) != EQUIP_ERR_OK )
-            continue;
+void AuctionHouseObject::AddSearchResult(WorldPacket& data, Player* player, AuctionEntry* auction, Item* item, uint32 listfrom, uint32 usable, uint32& count, uint32& totalcount)
+{
+    if( usable != (0x00) && player->CanUseItem( item ) != EQUIP_ERR_OK )
+        return;
 
-        std::string name = player->GetSession()->GetLocalizedItemName(proto);
-        if(name.empty())
-            continue;
+    if ((count < 50) && (totalcount >= listfrom))
+    {
+        ++count;
+        auction->BuildAuctionInfo(data);
+    }
 
-        if( !wsearchedname.empty() && !Utf8FitTo(name, wsearchedname) )
-            continue;
+    ++totalcount;
+}
+
+AuctionSearchSnapshot::BucketKey AuctionHouseObject::GetSearchBucketKey(ItemTemplate const* proto)
+{
+    return AuctionSearchSnapshot::BucketKey(proto->Class, proto->SubClass, proto->RequiredLevel);
+}
+
+std::shared_ptr<AuctionSearchSnapshot const> AuctionHouseObject::GetSearchSnapshot()
+{
+    if (_searchSnapshot && _dirtySearchBuckets.empty())
+        return _searchSnapshot;
+
+    std::shared_ptr<AuctionSearchSnapshot> snapshot;
+    if (_searchSnapshot)
+        snapshot = std::make_shared<AuctionSearchSnapshot>(*_searchSnapshot); // buckets are shared, not copied
+    else
+    {
+        snapshot = std::make_shared<AuctionSearchSnapshot>();
+        for (auto const& itr : AuctionsMap)
+            if (ItemTemplate const* proto = sObjectMgr->GetItemTemplate(itr.second->itemEntry))
+                _dirtySearchBuckets.insert(GetSearchBucketKey(proto));
+    }
 
-        if ((count < 50) && (totalcount >= listfrom))
+    // rebuild changed buckets from the class index, which holds each class/subclass auctions by ascending id
+    std::map<AuctionSearchSnapshot::BucketKey, std::shared_ptr<AuctionSearchSnapshot::Bucket>> rebuilt;
+    for (AuctionSearchSnapshot::BucketKey const& key : _dirtySearchBuckets)
+        rebuilt[key] = std::make_shared<AuctionSearchSnapshot::Bucket>();
+
+    for (auto bucketItr = rebuilt.begin(); bucketItr != rebuilt.end();)
+    {
+        uint32 const itemClass = std::get<0>(bucketItr->first);
+        uint32 const itemSubClass = std::get<1>(bucketItr->first);
+        auto classItr = _auctionsByClass.find(std::make_pair(itemClass, itemSubClass));
+        if (classItr != _auctionsByClass.end())
         {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
+            for (uint32 id : classItr->second)
+            {
+                AuctionEntry const* auction = GetAuction(id);
+                ItemTemplate const* proto = auction ? sObjectMgr->GetItemTemplate(auction->itemEntry) : nullptr;
+                if (!proto)
+                    continue;
+
+                auto target = rebuilt.find(GetSearchBucketKey(proto));
+                if (target != rebuilt.end())
+                    target->second->push_back({ id, proto });
+            }
         }
 
-        ++totalcount;
+        // skip the other dirty buckets of this class/subclass, they were filled above
+        while (bucketItr != rebuilt.end() && std::get<0>(bucketItr->first) == itemClass && std::get<1>(bucketItr->first) == itemSubClass)
+            ++bucketItr;
     }
+
+    for (auto& itr : rebuilt)
+    {
+        if (itr.second->empty())
+            snapshot->buckets.erase(itr.first);
+        else
+            snapshot->buckets[itr.first] = std::move(itr.second);
+    }
+
+    _searchSnapshot = std::move(snapshot);
+    _dirtySearchBuckets.clear();
+    return _searchSnapshot;
 }
 
 //this function inserts to WorldPacket auction's data
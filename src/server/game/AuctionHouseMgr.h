@@ -1,8 +1,14 @@
 #ifndef _AUCTION_HOUSE_MGR_H
 #define _AUCTION_HOUSE_MGR_H
 
+#include "AuctionHouseSearcher.h"
+#include <memory>
+#include <queue>
+#include <set>
+
 class Item;
 class Player;
+struct ItemTemplate;
 class WorldPacket;
 struct AuctionHouseEntry;
 
@@ -67,6 +73,9 @@ struct AuctionEntry
 };
 
 //this class is used as auctionhouse instance
+//Auctions are indexed by expiry time, owner, bidder, item class/subclass and item required level so that
+//expiration and client queries only visit matching auctions. Every change of owner, bidder or expiry time
+//on a stored auction must go through this class to keep the indexes in sync.
 class AuctionHouseObject
 {
   public:
@@ -84,11 +93,7 @@ class AuctionHouseObject
     AuctionEntryMap::iterator GetAuctionsBegin() {return AuctionsMap.begin();}
     AuctionEntryMap::iterator GetAuctionsEnd() {return AuctionsMap.end();}
 
-    void AddAuction(AuctionEntry *ah)
-    {
-        ASSERT( ah );
-        AuctionsMap[ah->Id] = ah;
-    }
+    void AddAuction(AuctionEntry *ah);
 
     AuctionEntry* GetAuction(uint32 id) const
     {
@@ -96,10 +101,9 @@ class AuctionHouseObject
         return itr != AuctionsMap.end() ? itr->second : nullptr;
     }
 
-    bool RemoveAuction(uint32 id)
-    {
-        return AuctionsMap.erase(id) ? true : false;
-    }
+    bool RemoveAuction(uint32 id);
+    //change bidder of an auction stored in this house
+    void SetBidder(AuctionEntry* auction, uint32 bidder);
     
     void RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::LowType ownerGUID);
 
@@ -112,9 +116,47 @@ class AuctionHouseObject
         std::wstring const& searchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
         uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
         uint32& count, uint32& totalcount);
+    //Same as above for auctions found by an AuctionSearcher. Auctions removed since the search are skipped.
+    void BuildListAuctionItems(WorldPacket& data, Player* player, std::vector<uint32> const& auctionIds,
+        uint32 listfrom, uint32 usable, uint32& count, uint32& totalcount);
+
+    //Copy of this house auctions for AuctionSearcher threads. A new copy is made on first call after auctions were added or removed,
+    //searches still running keep the previous one. Only buckets holding added or removed auctions are copied again.
+    std::shared_ptr<AuctionSearchSnapshot const> GetSearchSnapshot();
 
   private:
+    typedef std::set<uint32> AuctionIdSet; //ordered by id, so that lists are sent in the same order as AuctionsMap
+    typedef std::unordered_map<uint32, AuctionIdSet> AuctionsByGuidMap;
+    typedef std::map<std::pair<uint32 /*class*/, uint32 /*subclass*/>, AuctionIdSet> AuctionsByClassMap;
+    typedef std::map<uint32 /*required level*/, AuctionIdSet> AuctionsByLevelMap;
+    //expiry time + auction id, smallest expiry time on top
+    typedef std::pair<time_t, uint32> ExpiryEntry;
+    typedef std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<ExpiryEntry>> ExpiryQueue;
+
+    //Mail and delete an expired or owner removed auction. Auction is removed from the house and deleted.
+    void CloseAuction(AuctionEntry* auction, SQLTransaction& trans);
+    //Fill candidates with ids of auctions possibly matching given class/level filters, in ascending order
+    //Return false if no index can be used and every auction has to be checked
+    bool GetSearchCandidates(std::vector<uint32>& candidates, uint32 levelmin, uint32 levelmax, uint32 itemClass, uint32 itemSubClass) const;
+    //Add auction to search result if player can see it and it's in requested page
+    static void AddSearchResult(WorldPacket& data, Player* player, AuctionEntry* auction, Item* item, uint32 listfrom, uint32 usable, uint32& count, uint32& totalcount);
+
+    static AuctionSearchSnapshot::BucketKey GetSearchBucketKey(ItemTemplate const* proto);
+    static void IndexInsert(AuctionsByGuidMap& index, uint32 key, uint32 id);
+    static void IndexErase(AuctionsByGuidMap& index, uint32 key, uint32 id);
+
     AuctionEntryMap AuctionsMap;
+
+    //Removed auctions are not erased from the queue, they're dropped when they reach the top
+    ExpiryQueue _expiryQueue;
+    AuctionsByGuidMap _auctionsByOwner;
+    AuctionsByGuidMap _auctionsByBidder;
+    AuctionsByClassMap _auctionsByClass;
+    AuctionsByLevelMap _auctionsByLevel;
+
+    std::shared_ptr<AuctionSearchSnapshot const> _searchSnapshot;
+    //snapshot buckets with auctions added or removed since _searchSnapshot was made
+    std::set<AuctionSearchSnapshot::BucketKey> _dirtySearchBuckets;
 };
 
 class TC_GAME_API AuctionHouseMgr
@@ -152,11 +194,19 @@ class TC_GAME_API AuctionHouseMgr
         void SendAuctionOutbiddedMail(AuctionEntry * auction, uint32 newPrice, Player* newBidder, SQLTransaction& trans);
         void SendAuctionCancelledToBidderMail(AuctionEntry* auction, SQLTransaction& trans);
 
+        AuctionSearcher& GetSearcher() { return mSearcher; }
+
         static uint32 GetAuctionDeposit(AuctionHouseEntry const* entry, uint32 time, Item *pItem);
         static AuctionHouseEntry const* GetAuctionHouseEntry(uint32 factionTemplateId);
         void RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::LowType ownerGUID);
 
+        //Lowercase item name in given locale, as used for auction searches. Names are converted at load, see LoadNormalizedItemNames.
+        //Return an empty string if the item has no valid name. Read only, used by AuctionSearcher threads without locking.
+        std::wstring const& GetNormalizedItemName(ItemTemplate const* proto, LocaleConstant locale) const;
+
     public:
+      //convert every item name for auction searches, once item templates and locales are loaded
+      void LoadNormalizedItemNames();
       //load first auction items, because of check if item exists, when loading
       void LoadAuctionItems();
       void LoadAuctions();
@@ -172,6 +222,11 @@ class TC_GAME_API AuctionHouseMgr
       AuctionHouseObject mNeutralAuctions;
 
       ItemMap mAitems;
+
+      //localized names only hold items translated in that locale, others use DEFAULT_LOCALE name
+      std::unordered_map<uint32 /*item entry*/, std::wstring> mNormalizedItemNames[TOTAL_LOCALES];
+
+      AuctionSearcher mSearcher;
 };
 
 #define sAuctionMgr AuctionHouseMgr::instance()
@@ -0,0 +1,153 @@
+#include "AuctionHouseSearcher.h"
+#include "AuctionHouseMgr.h"
+#include "ItemTemplate.h"
+#include <algorithm>
+
+bool AuctionSearchParams::Match(ItemTemplate const* proto) const
+{
+    if (itemClass != (0xffffffff) && proto->Class != itemClass)
+        return false;
+
+    if (itemSubClass != (0xffffffff) && proto->SubClass != itemSubClass)
+        return false;
+
+    if (inventoryType != (0xffffffff) && proto->InventoryType != inventoryType)
+        return false;
+
+    if (quality != (0xffffffff) && proto->Quality != quality)
+        return false;
+
+    if (   ( levelmin && (proto->RequiredLevel < levelmin) )
+        || ( levelmax && (proto->RequiredLevel > levelmax) )
+       )
+        return false;
+
+    std::wstring const& name = sAuctionMgr->GetNormalizedItemName(proto, locale);
+    if (name.empty())
+        return false;
+
+    if (!searchedName.empty() && name.find(searchedName) == std::wstring::npos)
+        return false;
+
+    return true;
+}
+
+AuctionSearcher::~AuctionSearcher()
+{
+    deactivate();
+}
+
+void AuctionSearcher::activate(size_t num_threads)
+{
+    _cancelationToken = false;
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&AuctionSearcher::WorkerThread, this));
+}
+
+void AuctionSearcher::deactivate()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& thread : _workerThreads)
+        if (thread.joinable())
+            thread.join();
+    _workerThreads.clear();
+
+    // don't leave sessions waiting on a search that will never run
+    std::deque<SearchTask> remaining;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        remaining.swap(_queue);
+    }
+    for (SearchTask& task : remaining)
+        task();
+}
+
+AuctionSearchFuture AuctionSearcher::Search(std::shared_ptr<AuctionSearchSnapshot const> snapshot, AuctionSearchParams params)
+{
+    SearchTask task([snapshot = std::move(snapshot), params = std::move(params)]()
+    {
+        return Execute(*snapshot, params);
+    });
+    AuctionSearchFuture result = task.get_future();
+
+    ++_searchCount;
+    if (!activated())
+    {
+        task();
+        return result;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _queue.push_back(std::move(task));
+    }
+    _workCondition.notify_one();
+    return result;
+}
+
+std::vector<uint32> AuctionSearcher::Execute(AuctionSearchSnapshot const& snapshot, AuctionSearchParams const& params)
+{
+    typedef AuctionSearchSnapshot::BucketKey BucketKey;
+    auto begin = snapshot.buckets.begin();
+    auto end = snapshot.buckets.end();
+    if (params.itemClass != (0xffffffff))
+    {
+        uint32 const subClassMin = params.itemSubClass != (0xffffffff) ? params.itemSubClass : 0;
+        uint32 const subClassMax = params.itemSubClass != (0xffffffff) ? params.itemSubClass : 0xffffffff;
+        begin = snapshot.buckets.lower_bound(BucketKey(params.itemClass, subClassMin, 0));
+        end = snapshot.buckets.upper_bound(BucketKey(params.itemClass, subClassMax, 0xffffffff));
+    }
+
+    std::vector<uint32> result;
+    uint32 matchedBuckets = 0;
+    for (auto itr = begin; itr != end; ++itr)
+    {
+        uint32 const requiredLevel = std::get<2>(itr->first);
+        if ((params.levelmin && requiredLevel < params.levelmin) || (params.levelmax && requiredLevel > params.levelmax))
+            continue;
+
+        size_t const previousSize = result.size();
+        for (AuctionSearchSnapshot::Entry const& entry : *itr->second)
+            if (params.Match(entry.proto))
+                result.push_back(entry.auctionId);
+
+        if (result.size() > previousSize)
+            ++matchedBuckets;
+    }
+
+    // several buckets were merged, restore id order so that listfrom keeps pointing at the same results
+    if (matchedBuckets > 1)
+        std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+uint32 AuctionSearcher::GetQueuedCount()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return uint32(_queue.size());
+}
+
+void AuctionSearcher::WorkerThread()
+{
+    while (true)
+    {
+        SearchTask task;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _workCondition.wait(lock, [this] { return _cancelationToken || !_queue.empty(); });
+            if (_cancelationToken)
+                return;
+
+            task = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        task();
+    }
+}
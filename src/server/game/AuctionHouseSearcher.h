@@ -0,0 +1,96 @@
+
+#ifndef _AUCTION_HOUSE_SEARCHER_H
+#define _AUCTION_HOUSE_SEARCHER_H
+
+#include "Define.h"
+#include "Common.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+struct ItemTemplate;
+
+//Item template filters of a CMSG_AUCTION_LIST_ITEMS query. The "usable" filter depends on player state and is checked by the caller.
+struct AuctionSearchParams
+{
+    std::wstring searchedName; //lowercase
+    LocaleConstant locale = DEFAULT_LOCALE;
+    uint32 levelmin = 0;
+    uint32 levelmax = 0;
+    uint32 inventoryType = 0xffffffff;
+    uint32 itemClass = 0xffffffff;
+    uint32 itemSubClass = 0xffffffff;
+    uint32 quality = 0xffffffff;
+
+    bool Match(ItemTemplate const* proto) const;
+};
+
+//Immutable copy of an auction house content, shared between the world thread and AuctionSearcher threads.
+//Auctions are split in buckets by item class, subclass and required level, like the auction house indexes. A new snapshot
+//only copies the buckets that changed since the previous one and shares the others with it.
+struct AuctionSearchSnapshot
+{
+    struct Entry
+    {
+        uint32 auctionId;
+        ItemTemplate const* proto;
+    };
+    typedef std::vector<Entry> Bucket; //ascending auction id
+    typedef std::tuple<uint32 /*class*/, uint32 /*subclass*/, uint32 /*required level*/> BucketKey;
+
+    std::map<BucketKey, std::shared_ptr<Bucket const>> buckets;
+};
+
+//ascending ids of auctions matching a search
+typedef std::future<std::vector<uint32>> AuctionSearchFuture;
+
+/**
+Run auction house browse queries on worker threads, against a snapshot of the auction house. Sessions keep the
+returned future and build the result packet from live auctions once it is ready, see WorldSession::ProcessAuctionSearchCallback.
+*/
+class TC_GAME_API AuctionSearcher
+{
+public:
+    AuctionSearcher() : _cancelationToken(false), _searchCount(0), _throttledCount(0) {}
+    ~AuctionSearcher();
+
+    void activate(size_t num_threads);
+    //Searches still queued are executed on the calling thread
+    void deactivate();
+    bool activated() const { return !_workerThreads.empty(); }
+
+    AuctionSearchFuture Search(std::shared_ptr<AuctionSearchSnapshot const> snapshot, AuctionSearchParams params);
+
+    //Searches matching auctions in the snapshot buckets allowed by the class, subclass and level filters
+    static std::vector<uint32> Execute(AuctionSearchSnapshot const& snapshot, AuctionSearchParams const& params);
+
+    void SearchThrottled() { ++_throttledCount; }
+
+    uint32 GetQueuedCount();
+    uint64 GetSearchCount() const { return _searchCount; }
+    uint64 GetThrottledCount() const { return _throttledCount; }
+
+private:
+    typedef std::packaged_task<std::vector<uint32>()> SearchTask;
+
+    void WorkerThread();
+
+    std::mutex _lock;
+    std::condition_variable _workCondition;
+    std::deque<SearchTask> _queue;
+    std::vector<std::thread> _workerThreads;
+    bool _cancelationToken;
+
+    std::atomic<uint64> _searchCount;
+    std::atomic<uint64> _throttledCount;
+};
+
+#endif //_AUCTION_HOUSE_SEARCHER_H
@@ -23,10 +23,7 @@ void ThreatReference::AddThreat(float amount)
     if (amount == 0.0f)
         return;
     _baseAmount = std::max<float>(_baseAmount + amount, 0.0f);
-    if (amount > 0.0f)
-        HeapNotifyIncreased();
-    else
-        HeapNotifyDecreased();
+    ListNotifyChanged();
     _mgr._needClientUpdate = true;
 }
 
@@ -35,10 +32,7 @@ void ThreatReference::ScaleThreat(float factor)
     if (factor == 1.0f)
         return;
     _baseAmount *= factor;
-    if (factor > 1.0f)
-        HeapNotifyIncreased();
-    else
-        HeapNotifyDecreased();
+    ListNotifyChanged();
     _mgr._needClientUpdate = true;
 }
 
@@ -51,13 +45,13 @@ void ThreatReference::UpdateOffline()
     if (shouldBeOffline)
     {
         _online = ONLINE_STATE_OFFLINE;
-        HeapNotifyDecreased();
+        ListNotifyChanged();
         _mgr.SendRemoveToClients(_victim);
     }
     else
     {
         _online = ShouldBeSuppressed() ? ONLINE_STATE_SUPPRESSED : ONLINE_STATE_ONLINE;
-        HeapNotifyIncreased();
+        ListNotifyChanged();
         _mgr.RegisterForAIUpdate(this);
     }
 }
@@ -112,12 +106,8 @@ void ThreatReference::UpdateTauntState(TauntState state)
     if (state == _taunted)
         return;
 
-    std::swap(state, _taunted);
-
-    if (_taunted < state)
-        HeapNotifyDecreased();
-    else
-        HeapNotifyIncreased();
+    _taunted = state;
+    ListNotifyChanged();
 
     _mgr._needClientUpdate = true;
 }
@@ -154,7 +144,7 @@ void ThreatReference::UnregisterAndFree()
     return true;
 }
 
-ThreatManager::ThreatManager(Unit* owner) : _owner(owner), _ownerCanHaveThreatList(false), _ownerEngaged(false), _needClientUpdate(false), _updateTimer(THREAT_UPDATE_INTERVAL), _currentVictimRef(nullptr), _fixateRef(nullptr)
+ThreatManager::ThreatManager(Unit* owner) : _owner(owner), _ownerCanHaveThreatList(false), _ownerEngaged(false), _needClientUpdate(false), _updateTimer(THREAT_UPDATE_INTERVAL), _sortedThreatListDirty(false), _currentVictimRef(nullptr), _fixateRef(nullptr)
 {
     for (int8 i = 0; i < MAX_SPELL_SCHOOL; ++i)
         _singleSchoolModifiers[i] = 1.0f;
@@ -220,27 +210,28 @@ bool ThreatManager::IsThreatListEmpty(bool includeOffline) const
 
 bool ThreatManager::IsThreatenedBy(ObjectGuid const& who, bool includeOffline) const
 {
-    auto it = _myThreatListEntries.find(who);
-    if (it == _myThreatListEntries.end())
+    ThreatReference const* ref = GetRef(_myThreatListEntries, who);
+    if (!ref)
         return false;
-    return (includeOffline || it->second->IsAvailable());
+    return (includeOffline || ref->IsAvailable());
 }
 bool ThreatManager::IsThreatenedBy(Unit const* who, bool includeOffline) const { return IsThreatenedBy(who->GetGUID(), includeOffline); }
 
 float ThreatManager::GetThreat(Unit const* who, bool includeOffline) const
 {
-    auto it = _myThreatListEntries.find(who->GetGUID());
-    if (it == _myThreatListEntries.end())
+    ThreatReference const* ref = GetRef(_myThreatListEntries, who->GetGUID());
+    if (!ref)
         return 0.0f;
-    return (includeOffline || it->second->IsAvailable()) ? it->second->GetThreat() : 0.0f;
+    return (includeOffline || ref->IsAvailable()) ? ref->GetThreat() : 0.0f;
 }
 
 std::vector<ThreatReference*> ThreatManager::GetModifiableThreatList()
 {
+    SortThreatList();
     std::vector<ThreatReference*> list;
-    list.reserve(_myThreatListEntries.size());
-    for (auto it = _sortedThreatList.ordered_begin(), end = _sortedThreatList.ordered_end(); it != end; ++it)
-        list.push_back(const_cast<ThreatReference*>(*it));
+    list.reserve(_sortedThreatList.size());
+    for (ThreatReference const* ref : _sortedThreatList)
+        list.push_back(const_cast<ThreatReference*>(ref));
     return list;
 }
 
@@ -256,10 +247,10 @@ bool ThreatManager::IsThreateningAnyone(bool includeOffline) const
 
 bool ThreatManager::IsThreateningTo(ObjectGuid const& who, bool includeOffline) const
 {
-    auto it = _threatenedByMe.find(who);
-    if (it == _threatenedByMe.end())
+    ThreatReference const* ref = GetRef(_threatenedByMe, who);
+    if (!ref)
         return false;
-    return (includeOffline || it->second->IsAvailable());
+    return (includeOffline || ref->IsAvailable());
 }
 bool ThreatManager::IsThreateningTo(Unit const* who, bool includeOffline) const { return IsThreateningTo(who->GetGUID(), includeOffline); }
 
@@ -271,12 +262,12 @@ void ThreatManager::EvaluateSuppressed(bool canExpire)
         if (pair.second->IsOnline() && shouldBeSuppressed)
         {
             pair.second->_online = ThreatReference::ONLINE_STATE_SUPPRESSED;
-            pair.second->HeapNotifyDecreased();
+            pair.second->ListNotifyChanged();
         }
         else if (canExpire && pair.second->IsSuppressed() && !shouldBeSuppressed)
         {
             pair.second->_online = ThreatReference::ONLINE_STATE_ONLINE;
-            pair.second->HeapNotifyIncreased();
+            pair.second->ListNotifyChanged();
         }
     }
 }
@@ -340,9 +331,8 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
             {
                 auto const pair = redirInfo[i]; // (victim,pct)
                 Unit* redirTarget = nullptr;
-                auto it = _myThreatListEntries.find(pair.first); // try to look it up in our threat list first (faster)
-                if (it != _myThreatListEntries.end())
-                    redirTarget = it->second->_victim;
+                if (ThreatReference* ref = GetRef(_myThreatListEntries, pair.first)) // try to look it up in our threat list first (faster)
+                    redirTarget = ref->_victim;
                 else
                     redirTarget = ObjectAccessor::GetUnit(*_owner, pair.first);
 
@@ -362,16 +352,14 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
 
     // ok, now we actually apply threat
     // check if we already have an entry - if we do, just increase threat for that entry and we're done
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
+    if (ThreatReference* const ref = GetRef(_myThreatListEntries, target->GetGUID()))
     {
-        ThreatReference* const ref = it->second;
         // SUPPRESSED threat states don't go back to ONLINE until threat is caused by them (retail behavior)
         if (ref->GetOnlineState() == ThreatReference::ONLINE_STATE_SUPPRESSED)
             if (!ref->ShouldBeSuppressed())
             {
                 ref->_online = ThreatReference::ONLINE_STATE_ONLINE;
-                ref->HeapNotifyIncreased();
+                ref->ListNotifyChanged();
             }
 
         if (ref->IsOnline())
@@ -396,9 +384,8 @@ void ThreatManager::AddThreat(Unit* target, float amount, SpellInfo const* spell
 
 void ThreatManager::ScaleThreat(Unit* target, float factor)
 {
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
-        it->second->ScaleThreat(std::max<float>(factor,0.0f));
+    if (ThreatReference* ref = GetRef(_myThreatListEntries, target->GetGUID()))
+        ref->ScaleThreat(std::max<float>(factor,0.0f));
 }
 
 void ThreatManager::MatchUnitThreatToHighestThreat(Unit* target)
@@ -406,7 +393,8 @@ void ThreatManager::MatchUnitThreatToHighestThreat(Unit* target)
     if (_sortedThreatList.empty())
         return;
 
-    auto it = _sortedThreatList.ordered_begin(), end = _sortedThreatList.ordered_end();
+    SortThreatList();
+    auto it = _sortedThreatList.begin(), end = _sortedThreatList.end();
     ThreatReference const* highest = *it;
     if (!highest->IsAvailable())
         return;
@@ -423,7 +411,7 @@ void ThreatManager::MatchUnitThreatToHighestThreat(Unit* target)
 
 void ThreatManager::TauntUpdate()
 {
-    std::list<AuraEffect*> const& tauntEffects = _owner->GetAuraEffectsByType(SPELL_AURA_MOD_TAUNT);
+    Unit::AuraEffectList const& tauntEffects = _owner->GetAuraEffectsByType(SPELL_AURA_MOD_TAUNT);
 
     uint32 state = ThreatReference::TAUNT_STATE_TAUNT;
     std::unordered_map<ObjectGuid, ThreatReference::TauntState> tauntStates;
@@ -452,9 +440,8 @@ void ThreatManager::ResetAllThreat()
 
 void ThreatManager::ClearThreat(Unit* target)
 {
-    auto it = _myThreatListEntries.find(target->GetGUID());
-    if (it != _myThreatListEntries.end())
-        ClearThreat(it->second);
+    if (ThreatReference* ref = GetRef(_myThreatListEntries, target->GetGUID()))
+        ClearThreat(ref);
 }
 
 void ThreatManager::ClearThreat(ThreatReference* ref)
@@ -481,10 +468,9 @@ void ThreatManager::FixateTarget(Unit* target)
 {
     if (target)
     {
-        auto it = _myThreatListEntries.find(target->GetGUID());
-        if (it != _myThreatListEntries.end())
+        if (ThreatReference* ref = GetRef(_myThreatListEntries, target->GetGUID()))
         {
-            _fixateRef = it->second;
+            _fixateRef = ref;
             return;
         }
     }
@@ -522,6 +508,8 @@ ThreatReference const* ThreatManager::ReselectVictim()
     for (auto const& pair : _myThreatListEntries)
         pair.second->UpdateOffline();
 
+    SortThreatList();
+
     // fixated target is always preferred
     if (_fixateRef && _fixateRef->IsAvailable())
         return _fixateRef;
@@ -530,7 +518,7 @@ ThreatReference const* ThreatManager::ReselectVictim()
     if (oldVictimRef && oldVictimRef->IsOffline())
         oldVictimRef = nullptr;
     // in 99% of cases - we won't need to actually look at anything beyond the first element
-    ThreatReference const* highest = _sortedThreatList.top();
+    ThreatReference const* highest = _sortedThreatList.front();
     // if the highest reference is offline, the entire list is offline, and we indicate this
     if (!highest->IsAvailable())
         return nullptr;
@@ -547,8 +535,8 @@ ThreatReference const* ThreatManager::ReselectVictim()
     if (_owner->IsWithinMeleeRange(highest->_victim))
         return highest;
     // If we get here, highest threat is ranged, but below 130% of current - there might be a melee that breaks 110% below us somewhere, so now we need to actually look at the next highest element
-    // luckily, this is a heap, so getting the next highest element is O(log n), and we're just gonna do that repeatedly until we've seen enough targets (or find a target)
-    auto it = _sortedThreatList.ordered_begin(), end = _sortedThreatList.ordered_end();
+    // the list is sorted, so we just walk it until we've seen enough targets (or find a target)
+    auto it = _sortedThreatList.begin(), end = _sortedThreatList.end();
     while (it != end)
     {
         ThreatReference const* next = *it;
@@ -690,14 +678,10 @@ void ThreatManager::UpdateMyTempModifiers()
         return;
 
     auto it = _threatenedByMe.begin();
-    bool const isIncrease = (it->second->_tempModifier < mod);
     do
     {
         it->second->_tempModifier = mod;
-        if (isIncrease)
-            it->second->HeapNotifyIncreased();
-        else
-            it->second->HeapNotifyDecreased();
+        it->second->ListNotifyChanged();
     } while ((++it) != _threatenedByMe.end());
 }
 
@@ -758,6 +742,7 @@ void ThreatManager::SendRemoveToClients(Unit const* victim) const
 void ThreatManager::SendThreatListToClients(bool newHighest) const
 {
 #ifdef LICH_KING
+    SortThreatList();
     WorldPacket data(newHighest ? SMSG_HIGHEST_THREAT_UPDATE : SMSG_THREAT_UPDATE, (_sortedThreatList.size() + 2) * 8); // guess
     data << _owner->GetPackGUID();
     if (newHighest)
@@ -781,20 +766,21 @@ void ThreatManager::SendThreatListToClients(bool newHighest) const
 void ThreatManager::PutThreatListRef(ObjectGuid const& guid, ThreatReference* ref)
 {
     _needClientUpdate = true;
-    auto& inMap = _myThreatListEntries[guid];
-    ASSERT(!inMap, "Duplicate threat reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
-    inMap = ref;
-    ref->_handle = _sortedThreatList.push(ref);
+    ASSERT(!GetRef(_myThreatListEntries, guid), "Duplicate threat reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
+    _myThreatListEntries.emplace_back(guid, ref);
+    _sortedThreatList.push_back(ref);
+    _sortedThreatListDirty = true;
 }
 
 void ThreatManager::PurgeThreatListRef(ObjectGuid const& guid)
 {
-    auto it = _myThreatListEntries.find(guid);
+    auto it = FindRef(_myThreatListEntries, guid);
     if (it == _myThreatListEntries.end())
         return;
     ThreatReference* ref = it->second;
-    _myThreatListEntries.erase(it);
-    _sortedThreatList.erase(ref->_handle);
+    EraseRef(_myThreatListEntries, it);
+    // keep remaining entries order, list stays sorted if it was
+    _sortedThreatList.erase(std::find(_sortedThreatList.begin(), _sortedThreatList.end(), ref));
 
     if (_fixateRef == ref)
         _fixateRef = nullptr;
@@ -802,18 +788,53 @@ void ThreatManager::PurgeThreatListRef(ObjectGuid const& guid)
         _currentVictimRef = nullptr;
 }
 
+void ThreatManager::SortThreatList() const
+{
+    if (!_sortedThreatListDirty)
+        return;
+
+    for (size_t i = 1; i < _sortedThreatList.size(); ++i)
+    {
+        ThreatReference const* ref = _sortedThreatList[i];
+        size_t j = i;
+        for (; j > 0 && CompareReferencesLT(_sortedThreatList[j - 1], ref, 1.0f); --j)
+            _sortedThreatList[j] = _sortedThreatList[j - 1];
+        _sortedThreatList[j] = ref;
+    }
+    _sortedThreatListDirty = false;
+}
+
+/*static*/ ThreatManager::threat_ref_map::const_iterator ThreatManager::FindRef(threat_ref_map const& refs, ObjectGuid const& guid)
+{
+    return std::find_if(refs.begin(), refs.end(), [&guid](threat_ref_map::value_type const& pair) { return pair.first == guid; });
+}
+
+/*static*/ ThreatReference* ThreatManager::GetRef(threat_ref_map const& refs, ObjectGuid const& guid)
+{
+    auto it = FindRef(refs, guid);
+    return it != refs.end() ? it->second : nullptr;
+}
+
+/*static*/ void ThreatManager::EraseRef(threat_ref_map& refs, threat_ref_map::const_iterator it)
+{
+    // these maps are unordered, move last entry in place of the erased one
+    auto pos = refs.begin() + (it - refs.cbegin());
+    if (pos != refs.end() - 1)
+        *pos = refs.back();
+    refs.pop_back();
+}
+
 void ThreatManager::PutThreatenedByMeRef(ObjectGuid const& guid, ThreatReference* ref)
 {
-    auto& inMap = _threatenedByMe[guid];
-    ASSERT(!inMap, "Duplicate threatened-by-me reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
-    inMap = ref;
+    ASSERT(!GetRef(_threatenedByMe, guid), "Duplicate threatened-by-me reference at %p being inserted on %s for %s - memory leak!", ref, _owner->GetGUID().ToString().c_str(), guid.ToString().c_str());
+    _threatenedByMe.emplace_back(guid, ref);
 }
 
 void ThreatManager::PurgeThreatenedByMeRef(ObjectGuid const& guid)
 {
-    auto it = _threatenedByMe.find(guid);
+    auto it = FindRef(_threatenedByMe, guid);
     if (it != _threatenedByMe.end())
-        _threatenedByMe.erase(it);
+        EraseRef(_threatenedByMe, it);
 }
 
 void ThreatManager::UpdateRedirectInfo()
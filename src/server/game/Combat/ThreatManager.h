@@ -6,7 +6,6 @@
 #include "IteratorPair.h"
 #include "ObjectGuid.h"
 #include "SharedDefines.h"
-#include <boost/heap/fibonacci_heap.hpp>
 #include <array>
 #include <unordered_map>
 #include <vector>
@@ -35,8 +34,9 @@ class SpellInfo;
  *  - Adding threat will also create a combat reference between the units if one doesn't exist yet (even if the owner can't have a threat list!)        *
  *  - Ending combat between two units will also delete any threat references that may exist between them.                                               *
  *                                                                                                                                                      *
- * To manage a creature's threat list, ThreatManager maintains a heap of threat reference const pointers.                                               *
- * This heap is kept well-structured in all methods that modify ThreatReference, and is used to select the next target.                                 *
+ * To manage a creature's threat list, ThreatManager maintains a contiguous list of threat reference const pointers, used to select the next target.    *
+ * Methods modifying a ThreatReference only flag this list as unsorted, it is sorted again when next needed (victim selection or sorted access).        *
+ * Threat list and threatened-by-me entries are small flat maps (vectors of guid/reference pairs), usually holding a few dozens of entries at most.     *
  *                                                                                                                                                      *
  * Selection uses the following properties on ThreatReference, in order:                                                                                *
  * - Online state (one of ONLINE, SUPPRESSED, OFFLINE):                                                                                                 *
@@ -53,7 +53,7 @@ class SpellInfo;
  * The current (= last selected) victim can be accessed using GetCurrentVictim.                                                                         *
  * Beyond that, ThreatManager has a variety of helpers and notifiers, which are documented inline below.                                                *
  *                                                                                                                                                      *
- * SPECIAL NOTE: Please be aware that any iterator may be invalidated if you modify a ThreatReference. The heap holds const pointers for a reason, but  *
+ * SPECIAL NOTE: Please be aware that any iterator may be invalidated if you modify a ThreatReference. The list holds const pointers for a reason, but  *
  *                 that doesn't mean you're scot free. A variety of actions (casting spells, teleporting units, and so forth) can cause changes to      *
  *                 the threat list. Use with care - or default to GetModifiableThreatList(), which inherently copies entries.                           *
 \********************************************************************************************************************************************************/
@@ -69,7 +69,8 @@ struct CompareThreatLessThan
 class TC_GAME_API ThreatManager
 {
     public:
-        typedef boost::heap::fibonacci_heap<ThreatReference const*, boost::heap::compare<CompareThreatLessThan>> threat_list_heap;
+        typedef std::vector<ThreatReference const*> threat_list;
+        typedef std::vector<std::pair<ObjectGuid, ThreatReference*>> threat_ref_map;
         class ThreatListIterator;
         static const uint32 THREAT_UPDATE_INTERVAL = 1000u;
 
@@ -113,7 +114,7 @@ class TC_GAME_API ThreatManager
         // slightly slower than GetUnsorted, but, well...sorted - only use it if you need the sorted property, of course
         // this iterator pair will invalidate on any modification (even indirect) of the threat list; spell casts and similar can all induce this!
         // note: current tank is NOT guaranteed to be the first entry in this list - check GetLastVictim separately if you want that!
-        Trinity::IteratorPair<threat_list_heap::ordered_iterator> GetSortedThreatList() const { return { _sortedThreatList.ordered_begin(), _sortedThreatList.ordered_end() }; }
+        Trinity::IteratorPair<threat_list::const_iterator> GetSortedThreatList() const { SortThreatList(); return { _sortedThreatList.begin(), _sortedThreatList.end() }; }
         // slowest of the three threat list getters (by far), but lets you modify the threat references - this is also sorted
         std::vector<ThreatReference*> GetModifiableThreatList();
 
@@ -187,11 +188,18 @@ class TC_GAME_API ThreatManager
         ///== MY THREAT LIST ==
         void PutThreatListRef(ObjectGuid const& guid, ThreatReference* ref);
         void PurgeThreatListRef(ObjectGuid const& guid);
+        // sort _sortedThreatList if any reference was modified since last sort. Mostly sorted already, so this is an insertion sort.
+        void SortThreatList() const;
+
+        static threat_ref_map::const_iterator FindRef(threat_ref_map const& refs, ObjectGuid const& guid);
+        static ThreatReference* GetRef(threat_ref_map const& refs, ObjectGuid const& guid);
+        static void EraseRef(threat_ref_map& refs, threat_ref_map::const_iterator it);
 
         bool _needClientUpdate; //LK only
         uint32 _updateTimer;
-        threat_list_heap _sortedThreatList;
-        std::unordered_map<ObjectGuid, ThreatReference*> _myThreatListEntries;
+        mutable threat_list _sortedThreatList; // highest first once sorted
+        mutable bool _sortedThreatListDirty;
+        threat_ref_map _myThreatListEntries;
 
         // AI notifies are delayed to ensure we are in a consistent state before we call out to arbitrary logic
         // threat references might register themselves here when ::UpdateOffline() is called - MAKE SURE THIS IS PROCESSED JUST BEFORE YOU EXIT THREATMANAGER LOGIC
@@ -208,7 +216,7 @@ class TC_GAME_API ThreatManager
         ///== OTHERS' THREAT LISTS ==
         void PutThreatenedByMeRef(ObjectGuid const& guid, ThreatReference* ref);
         void PurgeThreatenedByMeRef(ObjectGuid const& guid);
-        std::unordered_map<ObjectGuid, ThreatReference*> _threatenedByMe; // these refs are entries for myself on other units' threat lists
+        threat_ref_map _threatenedByMe; // these refs are entries for myself on other units' threat lists
         std::array<float, MAX_SPELL_SCHOOL> _singleSchoolModifiers; // most spells are single school - we pre-calculate these and store them
         mutable std::unordered_map<std::underlying_type<SpellSchoolMask>::type, float> _multiSchoolModifiers; // these are calculated on demand
 
@@ -283,14 +291,13 @@ class TC_GAME_API ThreatReference
         void UpdateTauntState(TauntState state = TAUNT_STATE_NONE);
         Creature* const _owner;
         ThreatManager& _mgr;
-        void HeapNotifyIncreased() { _mgr._sortedThreatList.increase(_handle); }
-        void HeapNotifyDecreased() { _mgr._sortedThreatList.decrease(_handle); }
+        // our position in the threat list may have changed
+        void ListNotifyChanged() { _mgr._sortedThreatListDirty = true; }
         Unit* const _victim;
         OnlineState _online;
         float _baseAmount;
         int32 _tempModifier; // Temporary effects (auras with SPELL_AURA_MOD_TOTAL_THREAT) - set from victim's threatmanager in ThreatManager::UpdateMyTempModifiers
         TauntState _taunted;
-        ThreatManager::threat_list_heap::handle_type _handle;
 
     public:
         ThreatReference(ThreatReference const&) = delete;
@@ -787,7 +787,7 @@ std::string Condition::ToString(bool ext /*= false*/) const
     return ss.str();
 }
 
-ConditionMgr::ConditionMgr() { }
+ConditionMgr::ConditionMgr() : _loadGeneration(0) { }
 
 ConditionMgr::~ConditionMgr()
 {
@@ -843,50 +843,53 @@ uint32 ConditionMgr::GetSearcherTypeMaskForConditionList(ConditionContainer cons
     return mask;
 }
 
+bool ConditionMgr::IsObjectMeetToCondition(ConditionSourceInfo& sourceInfo, Condition* condition) const
+{
+    if (condition->ReferenceId)//handle reference
+    {
+        ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(condition->ReferenceId);
+        if (ref != ConditionReferenceStore.end())
+            return IsObjectMeetToConditionList(sourceInfo, (*ref).second);
+
+        TC_LOG_DEBUG("condition", "ConditionMgr::IsObjectMeetToCondition %s Reference template -%u not found",
+            condition->ToString().c_str(), condition->ReferenceId); // checked at loading, should never happen
+        return true;
+    }
+
+    //handle normal condition
+    return condition->Meets(sourceInfo);
+}
+
 bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const
 {
-    //     groupId, groupCheckPassed
-    std::map<uint32, bool> ElseGroupStore;
+    // conditions are ordered by ElseGroup: the list is met as soon as every condition of a group is met,
+    // and the remaining conditions of a group are skipped once one of them failed
+    bool groupFound = false;
+    bool groupPassed = false;
+    uint32 elseGroup = 0;
     for (auto condition : conditions)
     {
-        TC_LOG_DEBUG("condition", "ConditionMgr::IsObjectMeetToConditionList %s val1: %u", condition->ToString().c_str(), condition->ConditionValue1);
-        if (condition->isLoaded())
-        {
-            //! Find ElseGroup in ElseGroupStore
-            std::map<uint32, bool>::const_iterator itr = ElseGroupStore.find(condition->ElseGroup);
-            //! If not found, add an entry in the store and set to true (placeholder)
-            if (itr == ElseGroupStore.end())
-                ElseGroupStore[condition->ElseGroup] = true;
-            else if (!(*itr).second) //! If another condition in this group was unmatched before this, don't bother checking (the group is false anyway)
-                continue;
+        if (!condition->isLoaded())
+            continue;
 
-            if (condition->ReferenceId)//handle reference
-            {
-                ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(condition->ReferenceId);
-                if (ref != ConditionReferenceStore.end())
-                {
-                    if (!IsObjectMeetToConditionList(sourceInfo, (*ref).second))
-                        ElseGroupStore[condition->ElseGroup] = false;
-                }
-                else
-                {
-                    TC_LOG_DEBUG("condition", "ConditionMgr::IsObjectMeetToConditionList %s Reference template -%u not found",
-                        condition->ToString().c_str(), condition->ReferenceId); // checked at loading, should never happen
-                }
+        if (!groupFound || condition->ElseGroup != elseGroup)
+        {
+            if (groupFound && groupPassed)
+                return true;
 
-            }
-            else //handle normal condition
-            {
-                if (!condition->Meets(sourceInfo))
-                    ElseGroupStore[condition->ElseGroup] = false;
-            }
+            groupFound = true;
+            groupPassed = true;
+            elseGroup = condition->ElseGroup;
         }
+        else if (!groupPassed) // another condition in this group was unmatched before this, the group is false anyway
+            continue;
+
+        TC_LOG_DEBUG("condition", "ConditionMgr::IsObjectMeetToConditionList %s val1: %u", condition->ToString().c_str(), condition->ConditionValue1);
+        if (!IsObjectMeetToCondition(sourceInfo, condition))
+            groupPassed = false;
     }
-    for (std::map<uint32, bool>::const_iterator i = ElseGroupStore.begin(); i != ElseGroupStore.end(); ++i)
-        if (i->second)
-            return true;
 
-    return false;
+    return groupPassed;
 }
 
 bool ConditionMgr::IsObjectMeetToConditions(WorldObject* object, ConditionContainer const& conditions) const
@@ -910,6 +913,15 @@ bool ConditionMgr::IsObjectMeetToConditions(ConditionSourceInfo& sourceInfo, Con
     return IsObjectMeetToConditionList(sourceInfo, conditions);
 }
 
+void ConditionMgr::AddToConditionList(ConditionContainer& conditions, Condition* cond)
+{
+    auto itr = std::upper_bound(conditions.begin(), conditions.end(), cond, [](Condition const* left, Condition const* right)
+    {
+        return left->ElseGroup < right->ElseGroup;
+    });
+    conditions.insert(itr, cond);
+}
+
 bool ConditionMgr::CanHaveSourceGroupSet(ConditionSourceType sourceType)
 {
     return (sourceType == CONDITION_SOURCE_TYPE_CREATURE_LOOT_TEMPLATE ||
@@ -1017,6 +1029,16 @@ bool ConditionMgr::IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint
 }
 
 bool ConditionMgr::IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const
+{
+    if (ConditionContainer const* conditions = GetConditionsForSmartEvent(entryOrGuid, eventId, sourceType))
+    {
+        ConditionSourceInfo sourceInfo(unit, baseObject);
+        return IsObjectMeetToConditions(sourceInfo, *conditions);
+    }
+    return true;
+}
+
+ConditionContainer const* ConditionMgr::GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const
 {
     SmartEventConditionContainer::const_iterator itr = SmartEventConditionStore.find(std::make_pair(entryOrGuid, sourceType));
     if (itr != SmartEventConditionStore.end())
@@ -1025,11 +1047,10 @@ bool ConditionMgr::IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32
         if (i != itr->second.end())
         {
             TC_LOG_DEBUG("condition", "GetConditionsForSmartEvent: found conditions for Smart Event entry or guid %d eventId %u", entryOrGuid, eventId);
-            ConditionSourceInfo sourceInfo(unit, baseObject);
-            return IsObjectMeetToConditions(sourceInfo, i->second);
+            return &i->second;
         }
     }
-    return true;
+    return nullptr;
 }
 
 bool ConditionMgr::IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const
@@ -1053,6 +1074,7 @@ void ConditionMgr::LoadConditions(bool isReload)
     uint32 oldMSTime = GetMSTime();
 
     Clean();
+    ++_loadGeneration;
 
     //must clear all custom handled cases (groupped types) before reload
     if (isReload)
@@ -1081,7 +1103,8 @@ void ConditionMgr::LoadConditions(bool isReload)
     }
 
     QueryResult result = WorldDatabase.PQuery("SELECT SourceTypeOrReferenceId, SourceGroup, SourceEntry, SourceId, ElseGroup, ConditionTypeOrReference, ConditionTarget, "
-                                             " ConditionValue1, ConditionValue2, ConditionValue3, NegativeCondition, ErrorType, ErrorTextId, ScriptName FROM conditions WHERE ((%u >= patch_min) AND (%u <= patch_max))", sWorld->GetWowPatch(), sWorld->GetWowPatch());
+                                             " ConditionValue1, ConditionValue2, ConditionValue3, NegativeCondition, ErrorType, ErrorTextId, ScriptName FROM conditions WHERE ((%u >= patch_min) AND (%u <= patch_max))"
+                                             " ORDER BY SourceTypeOrReferenceId", sWorld->GetWowPatch(), sWorld->GetWowPatch());
 
     if (!result)
     {
@@ -1160,7 +1183,7 @@ void ConditionMgr::LoadConditions(bool isReload)
                 ConditionContainer mCondList;
                 ConditionReferenceStore[uRefId] = mCondList;
             }
-            ConditionReferenceStore[uRefId].push_back(cond);//add to reference storage
+            AddToConditionList(ConditionReferenceStore[uRefId], cond);//add to reference storage
             count++;
             continue;
         }//end of reference templates
@@ -1198,117 +1221,158 @@ void ConditionMgr::LoadConditions(bool isReload)
             cond->ErrorTextId = 0;
         }
 
-        if (cond->SourceGroup)
+        // reference templates are loaded first, a reference to a template of a single else group is replaced by the template
+        // conditions, so that it is evaluated along with the other conditions of its group instead of through a lookup
+        std::vector<Condition*> inlined;
+        if (cond->ReferenceId && InlineConditionReference(cond, cond->ReferenceId, inlined))
         {
+            delete cond;
+
             bool valid = false;
-            // handle grouped conditions
-            switch (cond->SourceType)
-            {
-                case CONDITION_SOURCE_TYPE_CREATURE_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Creature.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_DISENCHANT_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Disenchant.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_FISHING_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Fishing.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_GAMEOBJECT_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Gameobject.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_ITEM_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Item.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_MAIL_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Mail.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_MILLING_LOOT_TEMPLATE:
-//                    valid = addToLootTemplate(cond, LootTemplates_Milling.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_PICKPOCKETING_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Pickpocketing.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_PROSPECTING_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Prospecting.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_REFERENCE_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Reference.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_SKINNING_LOOT_TEMPLATE:
-                    valid = addToLootTemplate(cond, LootTemplates_Skinning.GetLootForConditionFill(cond->SourceGroup));
-                    break;
-                case CONDITION_SOURCE_TYPE_SPELL_LOOT_TEMPLATE:
-                 //   valid = addToLootTemplate(cond, LootTemplates_Spell.GetLootForConditionFill(cond->SourceGroup));
-                    valid = true;
-                    break;
-                case CONDITION_SOURCE_TYPE_GOSSIP_MENU:
-                    valid = addToGossipMenus(cond);
-                    break;
-                case CONDITION_SOURCE_TYPE_GOSSIP_MENU_OPTION:
-                    valid = addToGossipMenuItems(cond);
-                    break;
-                case CONDITION_SOURCE_TYPE_SPELL_CLICK_EVENT:
-                {
-                    SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
-                    valid = true;
-                    ++count;
-                    continue;   // do not add to m_AllocatedMemory to avoid double deleting
-                }
-                case CONDITION_SOURCE_TYPE_SPELL_IMPLICIT_TARGET:
-                    valid = addToSpellImplicitTargetConditions(cond);
-                    break;
-                case CONDITION_SOURCE_TYPE_VEHICLE_SPELL:
-                {
-                    /*
-                    VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
-                    */
-                    valid = true;
-                    ++count;
-                    continue;   // do not add to m_AllocatedMemory to avoid double deleting
-                }
-                case CONDITION_SOURCE_TYPE_SMART_EVENT:
-                {
-                    //! TODO: PAIR_32 ?
-                    std::pair<int32, uint32> key = std::make_pair(cond->SourceEntry, cond->SourceId);
-                    SmartEventConditionStore[key][cond->SourceGroup].push_back(cond);
-                    valid = true;
-                    ++count;
-                    continue;
-                }
-                case CONDITION_SOURCE_TYPE_NPC_VENDOR:
-                {
-                    NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+            for (Condition* inlinedCond : inlined)
+                if (addToConditionStores(inlinedCond))
                     valid = true;
-                    ++count;
-                    continue;
-                }
-                default:
-                    break;
-            }
 
-            if (!valid)
-            {
-                TC_LOG_ERROR("sql.sql", "%s Not handled or invalid grouped condition.", cond->ToString().c_str());
-                delete cond;
-            }
-            else
-            {
-                AllocatedMemoryStore.push_back(cond);
+            if (valid)
                 ++count;
-            }
             continue;
         }
 
-        //handle not grouped conditions
-        //add new Condition to storage based on Type/Entry
-        ConditionStore[cond->SourceType][cond->SourceEntry].push_back(cond);
-        ++count;
+        if (addToConditionStores(cond))
+            ++count;
     }
     while (result->NextRow());
 
     TC_LOG_INFO("server.loading", ">> Loaded %u conditions in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
+bool ConditionMgr::InlineConditionReference(Condition const* reference, uint32 refId, std::vector<Condition*>& inlined, uint8 depth) const
+{
+    ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(refId);
+    if (ref == ConditionReferenceStore.end() || depth >= MAX_CONDITION_REFERENCE_DEPTH)
+        return false;
+
+    // the template is ordered by ElseGroup, several else groups are alternatives and it is kept resolved at evaluation
+    ConditionContainer const& conditions = ref->second;
+    if (conditions.empty() || conditions.front()->ElseGroup != conditions.back()->ElseGroup)
+        return false;
+
+    for (Condition const* condition : conditions)
+    {
+        if (condition->ReferenceId && InlineConditionReference(reference, condition->ReferenceId, inlined, depth + 1))
+            continue;
+
+        auto inlinedCond = new Condition(*condition);
+        inlinedCond->SourceType = reference->SourceType;
+        inlinedCond->SourceGroup = reference->SourceGroup;
+        inlinedCond->SourceEntry = reference->SourceEntry;
+        inlinedCond->SourceId = reference->SourceId;
+        inlinedCond->ElseGroup = reference->ElseGroup;
+        inlined.push_back(inlinedCond);
+    }
+
+    return true;
+}
+
+bool ConditionMgr::addToConditionStores(Condition* cond)
+{
+    if (cond->SourceGroup)
+    {
+        bool valid = false;
+        // handle grouped conditions
+        switch (cond->SourceType)
+        {
+            case CONDITION_SOURCE_TYPE_CREATURE_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Creature.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_DISENCHANT_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Disenchant.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_FISHING_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Fishing.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_GAMEOBJECT_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Gameobject.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_ITEM_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Item.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_MAIL_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Mail.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_MILLING_LOOT_TEMPLATE:
+//                    valid = addToLootTemplate(cond, LootTemplates_Milling.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_PICKPOCKETING_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Pickpocketing.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_PROSPECTING_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Prospecting.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_REFERENCE_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Reference.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_SKINNING_LOOT_TEMPLATE:
+                valid = addToLootTemplate(cond, LootTemplates_Skinning.GetLootForConditionFill(cond->SourceGroup));
+                break;
+            case CONDITION_SOURCE_TYPE_SPELL_LOOT_TEMPLATE:
+             //   valid = addToLootTemplate(cond, LootTemplates_Spell.GetLootForConditionFill(cond->SourceGroup));
+                valid = true;
+                break;
+            case CONDITION_SOURCE_TYPE_GOSSIP_MENU:
+                valid = addToGossipMenus(cond);
+                break;
+            case CONDITION_SOURCE_TYPE_GOSSIP_MENU_OPTION:
+                valid = addToGossipMenuItems(cond);
+                break;
+            case CONDITION_SOURCE_TYPE_SPELL_CLICK_EVENT:
+            {
+                AddToConditionList(SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
+                return true;    // do not add to m_AllocatedMemory to avoid double deleting
+            }
+            case CONDITION_SOURCE_TYPE_SPELL_IMPLICIT_TARGET:
+                valid = addToSpellImplicitTargetConditions(cond);
+                break;
+            case CONDITION_SOURCE_TYPE_VEHICLE_SPELL:
+            {
+                /*
+                AddToConditionList(VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
+                */
+                return true;    // do not add to m_AllocatedMemory to avoid double deleting
+            }
+            case CONDITION_SOURCE_TYPE_SMART_EVENT:
+            {
+                //! TODO: PAIR_32 ?
+                std::pair<int32, uint32> key = std::make_pair(cond->SourceEntry, cond->SourceId);
+                AddToConditionList(SmartEventConditionStore[key][cond->SourceGroup], cond);
+                return true;
+            }
+            case CONDITION_SOURCE_TYPE_NPC_VENDOR:
+            {
+                AddToConditionList(NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry], cond);
+                return true;
+            }
+            default:
+                break;
+        }
+
+        if (!valid)
+        {
+            TC_LOG_ERROR("sql.sql", "%s Not handled or invalid grouped condition.", cond->ToString().c_str());
+            delete cond;
+            return false;
+        }
+
+        AllocatedMemoryStore.push_back(cond);
+        return true;
+    }
+
+    //handle not grouped conditions
+    //add new Condition to storage based on Type/Entry
+    AddToConditionList(ConditionStore[cond->SourceType][cond->SourceEntry], cond);
+    return true;
+}
+
 bool ConditionMgr::addToLootTemplate(Condition* cond, LootTemplate* loot) const
 {
     if (!loot)
@@ -1334,7 +1398,7 @@ bool ConditionMgr::addToGossipMenus(Condition* cond) const
         {
             if ((*itr).second.MenuID == cond->SourceGroup && (*itr).second.TextID == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1353,7 +1417,7 @@ bool ConditionMgr::addToGossipMenuItems(Condition* cond) const
         {
             if ((*itr).second.MenuID == cond->SourceGroup && (*itr).second.OptionID == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1470,7 +1534,7 @@ bool ConditionMgr::addToSpellImplicitTargetConditions(Condition* cond) const
                 }
             }
             if(sharedList)
-                sharedList->push_back(cond);
+                AddToConditionList(*sharedList, cond);
             break;
         }
     }
@@ -9,6 +9,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 class Creature;
 class Player;
@@ -158,6 +159,8 @@ enum MaxConditionTargets
     MAX_CONDITION_TARGETS = 3
 };
 
+#define MAX_CONDITION_REFERENCE_DEPTH 8 // nested reference templates inlined at load
+
 struct ConditionSourceInfo
 {
     WorldObject const* mConditionTargets[MAX_CONDITION_TARGETS]; // an array of targets available for conditions
@@ -216,12 +219,13 @@ struct Condition
     std::string ToString(bool ext = false) const; /// For logging purpose
 };
 
+// Conditions are kept ordered by ElseGroup (see ConditionMgr::AddToConditionList), so that they are evaluated group by group in a single pass
 typedef std::vector<Condition*> ConditionContainer;
-typedef std::map<uint32 /*SourceEntry*/, ConditionContainer> ConditionsByEntryMap;
+typedef std::unordered_map<uint32 /*SourceEntry*/, ConditionContainer> ConditionsByEntryMap;
 typedef std::array<ConditionsByEntryMap, CONDITION_SOURCE_TYPE_MAX> ConditionEntriesByTypeArray;
-typedef std::map<uint32, ConditionsByEntryMap> ConditionEntriesByCreatureIdMap;
-typedef std::map<std::pair<int32, uint32 /*SAI source_type*/>, ConditionsByEntryMap> SmartEventConditionContainer;
-typedef std::map<uint32, ConditionContainer> ConditionReferenceContainer;//only used for references
+typedef std::unordered_map<uint32, ConditionsByEntryMap> ConditionEntriesByCreatureIdMap;
+typedef std::unordered_map<std::pair<int32, uint32 /*SAI source_type*/>, ConditionsByEntryMap> SmartEventConditionContainer;
+typedef std::unordered_map<uint32, ConditionContainer> ConditionReferenceContainer;//only used for references
 
 class TC_GAME_API ConditionMgr
 {
@@ -244,6 +248,8 @@ class TC_GAME_API ConditionMgr
         bool IsObjectMeetToConditions(WorldObject* object, ConditionContainer const& conditions) const;
         bool IsObjectMeetToConditions(WorldObject* object1, WorldObject* object2, ConditionContainer const& conditions) const;
         bool IsObjectMeetToConditions(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
+        // Insert keeping conditions ordered by ElseGroup, every condition list must be filled through it
+        static void AddToConditionList(ConditionContainer& conditions, Condition* cond);
         static bool CanHaveSourceGroupSet(ConditionSourceType sourceType);
         static bool CanHaveSourceIdSet(ConditionSourceType sourceType);
         bool IsObjectMeetingNotGroupedConditions(ConditionSourceType sourceType, uint32 entry, ConditionSourceInfo& sourceInfo) const;
@@ -253,6 +259,10 @@ class TC_GAME_API ConditionMgr
         ConditionContainer const* GetConditionsForSpellClickEvent(uint32 creatureId, uint32 spellId) const;
         bool IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint32 spellId, Player* player, Unit* vehicle) const;
         bool IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const;
+        // nullptr if the smart event has no conditions
+        ConditionContainer const* GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const;
+        // Incremented each time conditions are loaded. Containers returned by GetConditionsFor* are only valid until next load.
+        uint32 GetLoadGeneration() const { return _loadGeneration; }
         bool IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const;
 
         struct ConditionTypeInfo
@@ -271,7 +281,11 @@ class TC_GAME_API ConditionMgr
         bool addToGossipMenus(Condition* cond) const;
         bool addToGossipMenuItems(Condition* cond) const;
         bool addToSpellImplicitTargetConditions(Condition* cond) const;
+        bool addToConditionStores(Condition* cond);
+        // Copies the conditions of a reference template of a single else group into the else group of the reference
+        bool InlineConditionReference(Condition const* reference, uint32 refId, std::vector<Condition*>& inlined, uint8 depth = 0) const;
         bool IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
+        bool IsObjectMeetToCondition(ConditionSourceInfo& sourceInfo, Condition* condition) const;
 
         static void LogUselessConditionValue(Condition* cond, uint8 index, uint32 value);
 
@@ -284,6 +298,8 @@ class TC_GAME_API ConditionMgr
         ConditionEntriesByCreatureIdMap   SpellClickEventConditionStore;
         ConditionEntriesByCreatureIdMap   NpcVendorConditionContainerStore;
         SmartEventConditionContainer      SmartEventConditionStore;
+
+        uint32 _loadGeneration;
 };
 
 #define sConditionMgr ConditionMgr::instance()
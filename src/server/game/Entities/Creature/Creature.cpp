@@ -863,6 +863,32 @@ void Creature::Update(uint32 diff)
     }
 }
 
+bool Creature::CanUpdateInParallel() const
+{
+    // respawn, corpse removal and group loot rolls reach the map stores and other players
+    if (m_deathState != ALIVE || m_triggerJustAppeared)
+        return false;
+
+    // combat, spells, targets and owners may reach any unit on the map
+    if (IsInCombat() || IsNonMeleeSpellCast(false) || GetCharmerOrOwnerGUID() || GetVictim() || GetTarget() || _spellFocusInfo.Delay)
+        return false;
+
+    // aura expiry and periodic effects may trigger on their casters or other units
+    if (!GetOwnedAuras().empty() || !GetAppliedAuras().empty())
+        return false;
+
+    // scripted AIs may cast or talk out of combat, formations move their members together
+    if (GetScriptId() || !m_creatureInfo->AIName.empty() || m_formation)
+        return false;
+
+    // changing keep active state updates the map active objects, events may do anything
+    if (m_keepActiveTimer || !m_Events.Empty())
+        return false;
+
+    // movement generators use the map shared nav mesh query and launch splines broadcast to players
+    return GetMotionMaster()->GetCurrentMovementGeneratorType() == IDLE_MOTION_TYPE && movespline->Finalized();
+}
+
 void Creature::Regenerate(Powers power)
 {
     if(m_disabledRegen)
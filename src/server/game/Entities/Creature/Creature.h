@@ -86,6 +86,8 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         std::string const& GetTitle() const { return GetCreatureTemplate()->Title; }
 
         void Update( uint32 time ) override;
+        // True if Update can only touch this creature and its own grid (used by parallel grids update)
+        bool CanUpdateInParallel() const;
         void GetRespawnPosition(float &x, float &y, float &z, float* ori = nullptr, float* dist =nullptr) const;
         bool IsSpawnedOnTransport() const;
 
@@ -103,6 +103,7 @@ QuaternionData QuaternionData::fromEulerAnglesZYX(float Z, float Y, float X)
 GameObject::GameObject() : WorldObject(false), MapObject(),
     m_AI(nullptr), 
     m_model(nullptr), 
+    m_modelSpawned(true),
     m_goValue(),
     m_respawnTime(0),
     m_respawnDelayTime(25),
@@ -505,8 +506,32 @@ bool GameObject::Create(ObjectGuid::LowType guidlow, uint32 name_id, Map *map, u
     return true;
 }
 
+bool GameObject::CanUpdateInParallel() const
+{
+    // traps and spell objects cast on units around them
+    if (GetGoType() == GAMEOBJECT_TYPE_TRAP || GetOwnerGUID() || GetSpellId())
+        return false;
+
+    // despawn, respawn, pools and group loot rolls reach the map stores and other players
+    if (m_lootState != GO_READY || m_respawnTime || m_despawnDelay || m_groupLootTimer)
+        return false;
+
+    // scripted AIs and events may do anything
+    if (GetScriptId() || !GetGOInfo()->AIName.empty() || !m_Events.Empty())
+        return false;
+
+    return true;
+}
+
 void GameObject::Update(uint32 diff)
 {
+    // model collision is ignored while despawned (see GameObjectModelOwnerImpl::IsSpawned), drop cached results when it changes
+    if (m_model && m_modelSpawned != isSpawned())
+    {
+        m_modelSpawned = !m_modelSpawned;
+        GetMap()->InvalidateLineOfSightCache(*m_model);
+    }
+
     m_Events.Update(diff);
 
     if (AI())
@@ -1198,8 +1223,14 @@ void GameObject::SetPhaseMask(uint32 newPhaseMask, bool update)
 {
     WorldObject::SetPhaseMask(newPhaseMask, update);
 
-    if (m_model && m_model->isEnabled())
+    if (!m_model)
+        return;
+
+    // cached line of sight results around the model were computed for its previous phases, EnableCollision drops them too
+    if (m_model->isEnabled())
         EnableCollision(true);
+    else if (IsInWorld())
+        GetMap()->InvalidateLineOfSightCache(*m_model);
 }
 
 void GameObject::EnableCollision(bool enable)
@@ -1208,6 +1239,8 @@ void GameObject::EnableCollision(bool enable)
         return;
 
     m_model->enable(enable);
+    if (IsInWorld())
+        GetMap()->InvalidateLineOfSightCache(*m_model);
 }
 
 void GameObject::UpdateModel()
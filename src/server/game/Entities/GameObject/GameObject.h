@@ -121,6 +121,8 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
 
         virtual bool Create(ObjectGuid::LowType guidlow, uint32 name_id, Map *map, uint32 phaseMask, Position const& pos, QuaternionData const& rotation, uint32 animprogress, GOState go_state, uint32 ArtKit = 0, bool dynamic = false, uint32 spawnid = 0);
         void Update(uint32 diff) override;
+        // True if Update can only touch this gameobject and its own grid (used by parallel grids update)
+        bool CanUpdateInParallel() const;
         static GameObject* GetGameObject(WorldObject& object, ObjectGuid guid);
         GameObjectTemplate const* GetGOInfo() const;
         GameObjectData const* GetGameObjectData() const { return m_goData; }
@@ -290,6 +292,7 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
         void SwitchDoorOrButton(bool activate, bool alternative = false);
         
         GameObjectModel * m_model;
+        bool m_modelSpawned; // isSpawned() at last update, see Update
         void GetRespawnPosition(float &x, float &y, float &z, float* ori = nullptr) const;
         
         float GetInteractionDistance() const;
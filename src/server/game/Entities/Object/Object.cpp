@@ -1106,22 +1106,35 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, LineOfSightChecks ch
 {
     if(IsInWorld())
     {
-        oz += GetCollisionHeight();
-        float x, y, z;
-        if (GetTypeId() == TYPEID_PLAYER)
-        {
-            GetPosition(x, y, z);
-            z += GetCollisionHeight();
-        }
-        else
-            GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
-        
-        return GetMap()->isInLineOfSight(x, y, z + 2.0f, ox, oy, oz + 2.0f, GetPhaseMask(), checks, ignoreFlags);
+        VMAP::LineOfSightRay ray;
+        GetLOSRayTo(ox, oy, oz, ray);
+        return GetMap()->isInLineOfSight(ray.x1, ray.y1, ray.z1, ray.x2, ray.y2, ray.z2, GetPhaseMask(), checks, ignoreFlags);
    }
     
     return true;
 }
 
+void WorldObject::GetLOSRayTo(float ox, float oy, float oz, VMAP::LineOfSightRay& ray) const
+{
+    oz += GetCollisionHeight();
+    float x, y, z;
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        GetPosition(x, y, z);
+        z += GetCollisionHeight();
+    }
+    else
+        GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
+
+    ray.x1 = x;
+    ray.y1 = y;
+    ray.z1 = z + 2.0f;
+    ray.x2 = ox;
+    ray.y2 = oy;
+    ray.z2 = oz + 2.0f;
+    ray.inLineOfSight = true;
+}
+
 Position WorldObject::GetHitSpherePointFor(Position const& dest) const
 {
     G3D::Vector3 vThis(GetPositionX(), GetPositionY(), GetPositionZ() + GetCollisionHeight());
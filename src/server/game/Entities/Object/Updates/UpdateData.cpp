@@ -6,6 +6,7 @@
 #include "Log.h"
 #include "Opcodes.h"
 #include "World.h"
+#include "Monitor.h"
 #include "zlib.h"
 
 UpdateData::UpdateData() : m_blockCount(0) { }
@@ -26,29 +27,78 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+// zlib stream kept for the whole thread life, reset between packets instead of being allocated and initialized for each of them
+class UpdateDataCompressionStream
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+    public:
+        UpdateDataCompressionStream() : m_initialized(false), m_level(0) { }
+        ~UpdateDataCompressionStream()
+        {
+            if (m_initialized)
+                deflateEnd(&m_stream);
+        }
+
+        // Returns a stream ready for a new packet, nullptr on failure
+        z_stream* Get(int level)
+        {
+            // compression level changed since init
+            if (m_initialized && m_level != level)
+            {
+                deflateEnd(&m_stream);
+                m_initialized = false;
+            }
+
+            if (m_initialized)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return &m_stream;
+
+                TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                deflateEnd(&m_stream);
+                m_initialized = false;
+            }
+
+            m_stream.zalloc = (alloc_func)nullptr;
+            m_stream.zfree = (free_func)nullptr;
+            m_stream.opaque = (voidpf)nullptr;
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return nullptr;
+            }
+
+            m_initialized = true;
+            m_level = level;
+            return &m_stream;
+        }
+
+    private:
+        z_stream m_stream;
+        bool m_initialized;
+        int m_level;
+};
+
+static thread_local UpdateDataCompressionStream t_compressionStream;
 
+void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = t_compressionStream.Get(sWorld->getConfig(CONFIG_COMPRESSION));
+    if (!c_stream)
     {
-        TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate) Error code: %i (%s)",z_res,zError(z_res));
@@ -56,14 +106,14 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)",z_res,zError(z_res));
@@ -71,15 +121,7 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
@@ -104,8 +146,10 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (m_data.size() > 100 )
+    if (m_data.size() > sWorld->getConfig(CONFIG_COMPRESSION_THRESHOLD))
     {
+        auto const startTime = std::chrono::steady_clock::now();
+
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
 
@@ -114,6 +158,17 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
         if (destsize == 0)
             return false;
 
+        sMonitor->UpdatePacketCompressed(pSize, destsize + sizeof(uint32), uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count()));
+
+        // data did not compress well, send it as is
+        if (destsize + sizeof(uint32) >= pSize)
+        {
+            packet->clear();
+            packet->append(buf);
+            packet->SetOpcode( SMSG_UPDATE_OBJECT );
+            return true;
+        }
+
         packet->resize( destsize + sizeof(uint32) );
         packet->SetOpcode( SMSG_COMPRESSED_UPDATE_OBJECT );
     }
@@ -1501,7 +1501,9 @@ void Pet::_SaveSpells(SQLTransaction& trans)
 void Pet::_LoadAuras(uint32 timediff)
 {
     for (auto & m_modAura : m_modAuras)
-        m_modAura.clear();
+        if (m_modAura)
+            m_modAura->clear();
+    m_modAurasToCompact.clear();
 
     // all aura related fields
     for(int i = UNIT_FIELD_AURA; i <= UNIT_FIELD_AURASTATE; ++i)
@@ -74,6 +74,7 @@
 #include "PoolMgr.h"
 #include "WorldStatePackets.h"
 #include "TicketMgr.h"
+#include "Monitor.h"
 
 #ifdef PLAYERBOT
 #include "PlayerbotAI.h"
@@ -190,6 +191,8 @@ Player::Player(WorldSession *session) :
     m_zoneUpdateTimer(0),
     m_areaUpdateId(0),
     m_spellModTakingSpell(nullptr),
+    m_spellModCacheHits(0),
+    m_spellModCacheMisses(0),
     m_trade(nullptr),
 #ifdef LICH_KING
     m_IsBGRandomWinner(false),
@@ -1211,6 +1214,13 @@ void Player::Update( uint32 p_time )
     Unit::Update(p_time);
     SetCanDelayTeleport(false);
 
+    if (m_spellModCacheHits || m_spellModCacheMisses)
+    {
+        sMonitor->SpellModCacheQueried(m_spellModCacheHits, m_spellModCacheMisses);
+        m_spellModCacheHits = 0;
+        m_spellModCacheMisses = 0;
+    }
+
     time_t now = GetMap()->GetGameTime();
 
     UpdatePvPFlag(now);
@@ -6198,6 +6208,11 @@ void Player::SendDirectMessage(WorldPacket const* data) const
     GetSession()->SendPacket(data);
 }
 
+void Player::SendDirectMessage(std::shared_ptr<WorldPacket const> const& data) const
+{
+    GetSession()->SendPacket(data);
+}
+
 void Player::SendCinematicStart(uint32 CinematicSequenceId) const
 {
     WorldPacket data(SMSG_TRIGGER_CINEMATIC, 4);
@@ -18840,8 +18855,14 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T &basevalue, Spell* s
     if (!spellInfo)
         return;
 
-    float totalmul = 1.0f;
-    int32 totalflat = 0;
+    // Drop charges for triggering spells instead of triggered ones
+    if (m_spellModTakingSpell)
+        spell = m_spellModTakingSpell;
+
+    SpellModCacheEntry const& cache = GetSpellModCacheEntry(spellInfo, op);
+
+    float totalmul = cache.totalMultiplier;
+    int32 totalflat = cache.totalFlat;
 
     auto calculateSpellMod = [&](SpellModifier* mod)
     {
@@ -18862,24 +18883,21 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T &basevalue, Spell* s
         Player::ApplyModToSpell(mod, spell);
     };
 
-    // Drop charges for triggering spells instead of triggered ones
-    if (m_spellModTakingSpell)
-        spell = m_spellModTakingSpell;
+    if (spell)
+        for (SpellModifier* mod : cache.mods)
+            Player::ApplyModToSpell(mod, spell);
+
+    for (SpellModifier* mod : cache.instantCastMods)
+        calculateSpellMod(mod);
 
     SpellModifier* chargedMod = nullptr;
-    for (SpellModifier* mod : m_spellMods[op])
+    for (SpellModifier* mod : cache.chargedMods)
     {
         if (!IsAffectedBySpellmod(spellInfo, mod, spell))
             continue;
 
-        if (mod->ownerAura->IsUsingCharges())
-        {
-            if (!chargedMod || (chargedMod->ownerAura->GetSpellInfo()->Priority < mod->ownerAura->GetSpellInfo()->Priority))
-                chargedMod = mod;
-            continue;
-        }
-
-        calculateSpellMod(mod);
+        if (!chargedMod || (chargedMod->ownerAura->GetSpellInfo()->Priority < mod->ownerAura->GetSpellInfo()->Priority))
+            chargedMod = mod;
     }
 
     if (chargedMod)
@@ -18888,6 +18906,45 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T &basevalue, Spell* s
     basevalue = T(float(basevalue + totalflat) * totalmul);
 }
 
+SpellModCacheEntry const& Player::GetSpellModCacheEntry(SpellInfo const* spellInfo, SpellModOp op)
+{
+    auto itr = m_spellModCache[op].find(spellInfo->Id);
+    if (itr != m_spellModCache[op].end())
+    {
+        ++m_spellModCacheHits;
+        return itr->second;
+    }
+
+    ++m_spellModCacheMisses;
+    SpellModCacheEntry& cache = m_spellModCache[op][spellInfo->Id];
+    for (SpellModifier* mod : m_spellMods[op])
+    {
+        // without spell, only checks not depending on the cast
+        if (!IsAffectedBySpellmod(spellInfo, mod))
+            continue;
+
+        if (mod->ownerAura->IsUsingCharges())
+            cache.chargedMods.push_back(mod);
+        else if (op == SPELLMOD_CASTING_TIME && mod->type == SPELLMOD_PCT && mod->value <= -100)
+            cache.instantCastMods.push_back(mod);
+        else
+        {
+            if (mod->type == SPELLMOD_FLAT)
+                cache.totalFlat += mod->value;
+            else
+                cache.totalMultiplier += CalculatePct(1.0f, mod->value);
+            cache.mods.push_back(mod);
+        }
+    }
+    return cache;
+}
+
+void Player::InvalidateSpellModCache()
+{
+    for (SpellModCache& cache : m_spellModCache)
+        cache.clear();
+}
+
 template TC_GAME_API void Player::ApplySpellMod(uint32 spellId, SpellModOp op, int32& basevalue, Spell* spell);
 template TC_GAME_API void Player::ApplySpellMod(uint32 spellId, SpellModOp op, uint32& basevalue, Spell* spell);
 template TC_GAME_API void Player::ApplySpellMod(uint32 spellId, SpellModOp op, float& basevalue, Spell* spell);
@@ -18951,6 +19008,8 @@ void Player::AddSpellMod(SpellModifier*& mod, bool apply)
         m_spellMods[mod->op].insert(mod);
     else
         m_spellMods[mod->op].erase(mod);
+
+    m_spellModCache[mod->op].clear();
 }
 
 void Player::ApplyModToSpell(SpellModifier* mod, Spell* spell)
@@ -115,6 +115,18 @@ struct SpellModifier
 typedef std::unordered_map<uint16, PlayerSpell*> PlayerSpellMap;
 typedef std::unordered_set<SpellModifier*> SpellModContainer;
 
+// Spell modifiers of one op affecting one spell, see Player::ApplySpellMod
+struct SpellModCacheEntry
+{
+    int32 totalFlat = 0;
+    float totalMultiplier = 1.0f;
+    std::vector<SpellModifier*> mods;            // included in totals, only registered in the spell
+    std::vector<SpellModifier*> chargedMods;     // depend on charges left, evaluated at each call
+    std::vector<SpellModifier*> instantCastMods; // depend on the base casting time, evaluated at each call
+};
+
+typedef std::unordered_map<uint32 /*spellId*/, SpellModCacheEntry> SpellModCache;
+
 struct SpellCooldown
 {
     time_t end;
@@ -1691,6 +1703,8 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void ApplySpellMod(uint32 spellId, SpellModOp op, T &basevalue, Spell* spell = nullptr);
         static void ApplyModToSpell(SpellModifier* mod, Spell* spell);
         void SetSpellModTakingSpell(Spell* spell, bool apply);
+        // Must be called when a spell mod changes without going through AddSpellMod (aura starting or stopping to use charges)
+        void InvalidateSpellModCache();
 
 #ifdef LICH_KING
         static uint32 const ARENA_MAX_COOLDOWN = 10 * MINUTE * IN_MILLISECONDS;
@@ -2068,6 +2082,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SendInitWorldStates(uint32 zoneid, uint32 areaid);
 		void SendUpdateWorldState(uint32 variable, uint32 value) const;
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(std::shared_ptr<WorldPacket const> const& data) const;
 
         void SendAuraDurationsForTarget(Unit* target);
 
@@ -2558,7 +2573,12 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         float m_auraBaseFlatMod[BASEMOD_END];
         float m_auraBasePctMod[BASEMOD_END];
         int16 m_baseRatingValue[MAX_COMBAT_RATING];
+        SpellModCacheEntry const& GetSpellModCacheEntry(SpellInfo const* spellInfo, SpellModOp op);
         SpellModContainer m_spellMods[MAX_SPELLMOD];
+        SpellModCache m_spellModCache[MAX_SPELLMOD];
+        // since last report to Monitor
+        uint32 m_spellModCacheHits;
+        uint32 m_spellModCacheMisses;
         EnchantDurationList m_enchantDuration;
         ItemDurationList m_itemDuration;
 
@@ -56,6 +56,8 @@
 #include <math.h>
 #include <array>
 
+Unit::AuraEffectList const Unit::EmptyAuraEffectList;
+
 float baseMoveSpeed[MAX_MOVE_TYPE] =
 {
     2.5f,                                                   // MOVE_WALK
@@ -3536,6 +3538,11 @@ void Unit::_DeleteRemovedAuras()
 
 void Unit::_UpdateSpells(uint32 diff)
 {
+    // nothing iterates over aura effects at this point
+    for (AuraType type : m_modAurasToCompact)
+        m_modAuras[type]->Compact();
+    m_modAurasToCompact.clear();
+
     if(GetCurrentSpell(CURRENT_AUTOREPEAT_SPELL))
         _UpdateAutoRepeatSpell();
 
@@ -10819,21 +10826,21 @@ void Unit::RestoreDisplayId()
 
     if (!transforms.empty())
     {
-        // iterate over already applied transform auras - from newest to oldest
-        for (auto i = transforms.rbegin(); i != transforms.rend(); ++i)
+        // iterate over already applied transform auras - from oldest to newest, keep the newest one
+        AuraEffect* handledNegativeAura = nullptr;
+        for (AuraEffect* aurEff : transforms)
         {
-            if (AuraApplication const* aurApp = (*i)->GetBase()->GetApplicationOfTarget(GetGUID()))
+            if (AuraApplication const* aurApp = aurEff->GetBase()->GetApplicationOfTarget(GetGUID()))
             {
-                if (!handledAura)
-                    handledAura = (*i);
+                handledAura = aurEff;
                 // prefer negative auras
                 if (!aurApp->IsPositive())
-                {
-                    handledAura = (*i);
-                    break;
-                }
+                    handledNegativeAura = aurEff;
             }
         }
+
+        if (handledNegativeAura)
+            handledAura = handledNegativeAura;
     }
     
     // transform aura was found
@@ -12980,10 +12987,27 @@ void Unit::_RemoveNoStackAurasDueToAura(Aura* aura, bool checkStrongerAura /*= f
 
 void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
 {
+    AuraType const type = aurEff->GetAuraType();
+    std::unique_ptr<AuraEffectList>& effects = m_modAuras[type];
     if (apply)
-        m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
-    else
-        m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+    {
+        if (!effects)
+            effects = std::make_unique<AuraEffectList>();
+        effects->push_back(aurEff);
+    }
+    else if (effects)
+    {
+        bool const wasCompact = !effects->NeedsCompact();
+        effects->remove(aurEff);
+        if (wasCompact && effects->NeedsCompact())
+            m_modAurasToCompact.push_back(type);
+    }
+}
+
+void Unit::_InvalidateAuraEffectAggregates(AuraType type)
+{
+    if (m_modAuras[type])
+        m_modAuras[type]->InvalidateAggregates();
 }
 
 // All aura base removes should go through this function!
@@ -13191,7 +13215,8 @@ void Unit::RemoveOwnedAuras(uint32 spellId, std::function<bool(Aura const*)> con
 
 void Unit::RemoveAurasByType(AuraType auraType, std::function<bool(AuraApplication const*)> const& check)
 {
-    for (AuraEffectList::iterator iter = m_modAuras[auraType].begin(); iter != m_modAuras[auraType].end();)
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    for (AuraEffectList::iterator iter = effects.begin(); iter != effects.end();)
     {
         Aura* aura = (*iter)->GetBase();
         AuraApplication * aurApp = aura->GetApplicationOfTarget(GetGUID());
@@ -13203,7 +13228,7 @@ void Unit::RemoveAurasByType(AuraType auraType, std::function<bool(AuraApplicati
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp);
             if (m_removedAurasCount > removedAuras + 1)
-                iter = m_modAuras[auraType].begin();
+                iter = effects.begin();
         }
     }
 }
@@ -13375,7 +13400,8 @@ void Unit::RemoveAurasDueToItemSpell(uint32 spellId, ObjectGuid castItemGuid)
 
 void Unit::RemoveAurasByType(AuraType auraType, ObjectGuid casterGUID, Aura* except, bool negative, bool positive)
 {
-    for (AuraEffectList::iterator iter = m_modAuras[auraType].begin(); iter != m_modAuras[auraType].end();)
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    for (AuraEffectList::iterator iter = effects.begin(); iter != effects.end();)
     {
         Aura* aura = (*iter)->GetBase();
         AuraApplication * aurApp = aura->GetApplicationOfTarget(GetGUID());
@@ -13388,7 +13414,7 @@ void Unit::RemoveAurasByType(AuraType auraType, ObjectGuid casterGUID, Aura* exc
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp);
             if (m_removedAurasCount > removedAuras + 1)
-                iter = m_modAuras[auraType].begin();
+                iter = effects.begin();
         }
     }
 }
@@ -14008,7 +14034,7 @@ bool Unit::HasAura(uint32 spellId, ObjectGuid casterGUID, ObjectGuid itemCasterG
 
 bool Unit::HasAuraType(AuraType auraType) const
 {
-    return (!m_modAuras[auraType].empty());
+    return !GetAuraEffectsByType(auraType).empty();
 }
 
 bool Unit::HasAuraTypeWithCaster(AuraType auraType, ObjectGuid caster) const
@@ -14195,24 +14221,65 @@ int32 Unit::GetMaxNegativeAuraModifier(AuraType auraType, std::function<bool(Aur
     return modifier;
 }
 
+// Aggregates over all effects of a type are cached in the effect list until an effect is applied, removed or changed
 int32 Unit::GetTotalAuraModifier(AuraType auraType) const
 {
-    return GetTotalAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    if (effects.empty())
+        return 0;
+
+    int32 modifier;
+    if (!effects.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, modifier))
+    {
+        modifier = GetTotalAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+        effects.SetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, modifier);
+    }
+    return modifier;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auraType) const
 {
-    return GetTotalAuraMultiplier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    if (effects.empty())
+        return 1.0f;
+
+    float multiplier;
+    if (!effects.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MULTIPLIER, multiplier))
+    {
+        multiplier = GetTotalAuraMultiplier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+        effects.SetAggregate(AuraEffectList::AGGREGATE_TOTAL_MULTIPLIER, multiplier);
+    }
+    return multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auraType) const
 {
-    return GetMaxPositiveAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    if (effects.empty())
+        return 0;
+
+    int32 modifier;
+    if (!effects.GetAggregate(AuraEffectList::AGGREGATE_MAX_POSITIVE_MODIFIER, modifier))
+    {
+        modifier = GetMaxPositiveAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+        effects.SetAggregate(AuraEffectList::AGGREGATE_MAX_POSITIVE_MODIFIER, modifier);
+    }
+    return modifier;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auraType) const
 {
-    return GetMaxNegativeAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    AuraEffectList const& effects = GetAuraEffectsByType(auraType);
+    if (effects.empty())
+        return 0;
+
+    int32 modifier;
+    if (!effects.GetAggregate(AuraEffectList::AGGREGATE_MAX_NEGATIVE_MODIFIER, modifier))
+    {
+        modifier = GetMaxNegativeAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+        effects.SetAggregate(AuraEffectList::AGGREGATE_MAX_NEGATIVE_MODIFIER, modifier);
+    }
+    return modifier;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auraType, uint32 miscMask) const
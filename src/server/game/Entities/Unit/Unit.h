@@ -5,6 +5,7 @@
 #include "Object.h"
 #include "Opcodes.h"
 #include "SpellAuraDefines.h"
+#include "AuraEffectList.h"
 #include "UpdateFields.h"
 #include "SharedDefines.h"
 #include "ThreatManager.h"
@@ -19,6 +20,7 @@
 #include "UnitDefines.h"
 #include "Optional.h"
 
+#include <array>
 #include <list>
 #include <stack>
 
@@ -826,7 +828,7 @@ class TC_GAME_API Unit : public WorldObject
         typedef std::multimap<AuraStateType, AuraApplication*> AuraStateAurasMap;
         typedef std::pair<AuraStateAurasMap::const_iterator, AuraStateAurasMap::const_iterator> AuraStateAurasMapBounds;
 
-        typedef std::list<AuraEffect*> AuraEffectList;
+        typedef ::AuraEffectList AuraEffectList;
         typedef std::list<Aura*> AuraList;
         typedef std::list<AuraApplication*> AuraApplicationList;
 
@@ -1379,6 +1381,8 @@ class TC_GAME_API Unit : public WorldObject
         void _UnapplyAura(AuraApplication* aurApp, AuraRemoveMode removeMode);
         void _RemoveNoStackAurasDueToAura(Aura* aura, bool checkStrongerAura = false);
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        // Must be called when the amount of an applied effect changes outside of ChangeAmount
+        void _InvalidateAuraEffectAggregates(AuraType type);
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras() { return m_ownedAuras; }
@@ -1443,7 +1447,7 @@ class TC_GAME_API Unit : public WorldObject
         void _RemoveAllAuraStatMods();
         void _ApplyAllAuraStatMods();
 
-        AuraEffectList const& GetAuraEffectsByType(AuraType type) const { return m_modAuras[type]; }
+        AuraEffectList const& GetAuraEffectsByType(AuraType type) const { return m_modAuras[type] ? *m_modAuras[type] : EmptyAuraEffectList; }
         AuraList      & GetSingleCastAuras() { return m_scAuras; }
         AuraList const& GetSingleCastAuras() const { return m_scAuras; }
 
@@ -1995,7 +1999,9 @@ class TC_GAME_API Unit : public WorldObject
         AuraMap::iterator m_auraUpdateIterator; //m_ownedAuras iterator
         uint32 m_removedAurasCount; //count how much auras were removed (does not reset at each update)
 
-        AuraEffectList m_modAuras[TOTAL_AURAS]; //all aura effects applied on this unit
+        std::array<std::unique_ptr<AuraEffectList>, TOTAL_AURAS> m_modAuras; //all aura effects applied on this unit, allocated on first use of each type
+        std::vector<AuraType> m_modAurasToCompact; //types with removed aura effects, compacted at next spells update
+        static AuraEffectList const EmptyAuraEffectList;
         AuraList m_scAuras;                     // casted singlecast auras. List auras casted on other units with the flag SPELL_ATTR5_SINGLE_TARGET_SPELL, such as polymorph
         AuraApplicationList m_interruptableAuras;          // auras on this unit with an AuraInterruptFlags
         AuraApplicationList m_ccAuras; //crowd control aura with a chance of being interrupted by damage
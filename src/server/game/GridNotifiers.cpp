@@ -84,7 +84,7 @@ void VisibleNotifier::SendToSelf()
     if (!buildResult)
         ASSERT(false); //should never happen, lack of memory?
         
-    i_player.GetSession()->SendPacket(&packet);
+    i_player.GetSession()->SendPacket(std::move(packet));
 
     for (std::set<Unit*>::const_iterator it = i_visibleNow.begin(); it != i_visibleNow.end(); ++it)
         i_player.SendInitialVisiblePackets(*it);
@@ -348,6 +348,44 @@ ObjectUpdater::Visit(GridRefManager<T> &m)
 template void ObjectUpdater::Visit<GameObject>(GameObjectMapType &);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType &);
 
+void ParallelObjectUpdater::Visit(CreatureMapType &m)
+{
+    for (auto& ref : m)
+    {
+        Creature* creature = ref.GetSource();
+        if (!creature->IsInWorld())
+            continue;
+
+        if (!creature->CanUpdateInParallel())
+            i_deferred.push_back(creature);
+        else
+            creature->Update(i_timeDiff);
+    }
+}
+
+void ParallelObjectUpdater::Visit(GameObjectMapType &m)
+{
+    for (auto& ref : m)
+    {
+        GameObject* go = ref.GetSource();
+        if (!go->IsInWorld())
+            continue;
+
+        if (!go->CanUpdateInParallel())
+            i_deferred.push_back(go);
+        else
+            go->Update(i_timeDiff);
+    }
+}
+
+void ParallelObjectUpdater::Visit(DynamicObjectMapType &m)
+{
+    //dynamic objects are spell areas, always update them serially
+    for (auto& ref : m)
+        if (ref.GetSource()->IsInWorld())
+            i_deferred.push_back(ref.GetSource());
+}
+
 bool CannibalizeObjectCheck::operator()(Corpse* u)
 {
     // ignore bones
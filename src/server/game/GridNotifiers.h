@@ -106,6 +106,8 @@ namespace Trinity
 	{
 		WorldObject const* i_source;
 		WorldPacket const* i_message;
+		// copy of i_message made for the first recipient, payload is then shared by every recipient socket
+		std::shared_ptr<WorldPacket const> i_sharedMessage;
 		uint32 i_phaseMask;
 		float i_distSq;
 		Team team;
@@ -133,7 +135,10 @@ namespace Trinity
 			if (!player->HaveAtClient(i_source))
 				return;
 
-			player->GetSession()->SendPacket(i_message);
+			if (!i_sharedMessage)
+				i_sharedMessage = std::make_shared<WorldPacket>(*i_message);
+
+			player->GetSession()->SendPacket(i_sharedMessage);
 		}
 	};
 
@@ -147,6 +152,19 @@ namespace Trinity
         void Visit(CreatureMapType &);
     };
 
+    // Used by Map parallel grids update. Objects which may interact with other grids are not updated but stored in i_deferred.
+    struct TC_GAME_API ParallelObjectUpdater
+    {
+        uint32 i_timeDiff;
+        std::vector<WorldObject*>& i_deferred;
+        explicit ParallelObjectUpdater(const uint32 &diff, std::vector<WorldObject*>& deferred) : i_timeDiff(diff), i_deferred(deferred) {}
+        template<class T> void Visit(GridRefManager<T> &) {}
+        void Visit(CreatureMapType &);
+        void Visit(GameObjectMapType &);
+        void Visit(DynamicObjectMapType &);
+        void Visit(CorpseMapType &) {}
+    };
+
     // SEARCHERS & LIST SEARCHERS & WORKERS
 
     // WorldObject searchers & workers
@@ -705,7 +705,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
         {
             if (Entrie->itemid == uint32(cond->SourceEntry))
             {
-                Entrie->conditions.push_back(cond);
+                ConditionMgr::AddToConditionList(Entrie->conditions, cond);
                 return true;
             }
         }
@@ -725,7 +725,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
                 {
                     if (i->itemid == uint32(cond->SourceEntry))
                     {
-                        i->conditions.push_back(cond);
+                        ConditionMgr::AddToConditionList(i->conditions, cond);
                         return true;
                     }
                 }
@@ -738,7 +738,7 @@ bool LootTemplate::addConditionItem(Condition* cond)
                 {
                     if (i->itemid == uint32(cond->SourceEntry))
                     {
-                        i->conditions.push_back(cond);
+                        ConditionMgr::AddToConditionList(i->conditions, cond);
                         return true;
                     }
                 }
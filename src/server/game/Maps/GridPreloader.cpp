@@ -0,0 +1,220 @@
+#include "GridPreloader.h"
+#include "GridMap.h"
+#include "Log.h"
+#include "Monitor.h"
+#include "Timer.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include "World.h"
+#include <algorithm>
+
+// Grids read but not taken after this delay are dropped
+uint32 const GRID_PRELOAD_EXPIRE_TIME = 60 * IN_MILLISECONDS;
+uint32 const GRID_PRELOAD_EXPIRE_CHECK_INTERVAL = 5 * IN_MILLISECONDS;
+// Oldest requests are dropped when more requests than this are waiting
+size_t const GRID_PRELOAD_MAX_QUEUED = 256;
+
+PreloadedGrid::PreloadedGrid(uint32 _mapId, int32 _gx, int32 _gy) : mapId(_mapId), gx(_gx), gy(_gy)
+{
+}
+
+PreloadedGrid::~PreloadedGrid()
+{
+    if (vmapModels.empty())
+        return;
+
+    if (VMAP::VMapManager2* vmgr = dynamic_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager()))
+        for (std::string const& model : vmapModels)
+            vmgr->releaseModelInstance(model);
+}
+
+GridPreloader::~GridPreloader()
+{
+    deactivate();
+}
+
+void GridPreloader::activate(size_t num_threads)
+{
+    _cancelationToken = false;
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&GridPreloader::WorkerThread, this));
+}
+
+void GridPreloader::deactivate()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& thread : _workerThreads)
+        if (thread.joinable())
+            thread.join();
+    _workerThreads.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _queue.clear();
+        _entries.clear();
+    }
+    _readyCondition.notify_all();
+}
+
+void GridPreloader::RequestGrid(uint32 mapId, int32 gx, int32 gy)
+{
+    uint64 const key = MakeKey(mapId, gx, gy);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_entries.emplace(key, Entry()).second)
+            return; //already requested
+
+        _queue.push_back(key);
+        if (_queue.size() > GRID_PRELOAD_MAX_QUEUED)
+        {
+            _entries.erase(_queue.front());
+            _queue.pop_front();
+        }
+    }
+    _workCondition.notify_one();
+}
+
+std::unique_ptr<PreloadedGrid> GridPreloader::TakeGrid(uint32 mapId, int32 gx, int32 gy)
+{
+    uint64 const key = MakeKey(mapId, gx, gy);
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto itr = _entries.find(key);
+    if (itr == _entries.end())
+    {
+        sMonitor->GridPreloaded(GRID_PRELOAD_MISS);
+        return nullptr;
+    }
+
+    switch (itr->second.state)
+    {
+        case STATE_PENDING:
+            // not started yet, just load it ourselves
+            _queue.erase(std::find(_queue.begin(), _queue.end(), key));
+            _entries.erase(itr);
+            sMonitor->GridPreloaded(GRID_PRELOAD_MISS);
+            return nullptr;
+        case STATE_LOADING:
+            _readyCondition.wait(lock, [&] {
+                itr = _entries.find(key);
+                return itr == _entries.end() || itr->second.state == STATE_READY;
+            });
+            if (itr == _entries.end()) // preloader was deactivated meanwhile
+                return nullptr;
+            sMonitor->GridPreloaded(GRID_PRELOAD_LATE);
+            break;
+        case STATE_READY:
+            sMonitor->GridPreloaded(GRID_PRELOAD_HIT);
+            break;
+    }
+
+    std::unique_ptr<PreloadedGrid> grid = std::move(itr->second.grid);
+    _entries.erase(itr);
+    return grid;
+}
+
+void GridPreloader::Update(uint32 diff)
+{
+    _expireTimer += diff;
+    if (_expireTimer < GRID_PRELOAD_EXPIRE_CHECK_INTERVAL)
+        return;
+    _expireTimer = 0;
+
+    // release expired grids outside of lock, this may free vmap models
+    std::vector<std::unique_ptr<PreloadedGrid>> expired;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        uint32 const now = GetMSTime();
+        for (auto itr = _entries.begin(); itr != _entries.end();)
+        {
+            if (itr->second.state == STATE_READY && GetMSTimeDiff(itr->second.readyTime, now) > GRID_PRELOAD_EXPIRE_TIME)
+            {
+                expired.push_back(std::move(itr->second.grid));
+                itr = _entries.erase(itr);
+            }
+            else
+                ++itr;
+        }
+    }
+
+    for (size_t i = 0; i < expired.size(); ++i)
+        sMonitor->GridPreloaded(GRID_PRELOAD_EXPIRED);
+}
+
+uint32 GridPreloader::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return uint32(_queue.size());
+}
+
+void GridPreloader::Load(PreloadedGrid& grid)
+{
+    std::string const dataPath = sWorld->GetDataPath();
+
+    // terrain, same as Map::LoadMap
+    std::string mapFile = Trinity::StringFormat("%smaps/%03u%02u%02u.map", dataPath.c_str(), grid.mapId, grid.gx, grid.gy);
+    grid.gridMap = std::make_unique<GridMap>();
+    if (!grid.gridMap->loadData(&mapFile[0]))
+        TC_LOG_ERROR("maps", "GridPreloader: ERROR loading map file: %s", mapFile.c_str());
+
+    // vmap models, the tile itself is small and is read again when loading the grid
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (vmgr->isMapLoadingEnabled())
+        if (VMAP::VMapManager2* vmgr2 = dynamic_cast<VMAP::VMapManager2*>(vmgr))
+            vmgr2->preloadTileModels((dataPath + "vmaps").c_str(), grid.mapId, grid.gx, grid.gy, grid.vmapModels);
+
+    // mmap tile, only bring it in system file cache. Detour tiles cannot be built outside of their navmesh.
+    std::string mmapFile = Trinity::StringFormat("%smmaps/%03u%02u%02u.mmtile", dataPath.c_str(), grid.mapId, grid.gx, grid.gy);
+    if (FILE* file = fopen(mmapFile.c_str(), "rb"))
+    {
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+            ;
+        fclose(file);
+    }
+}
+
+void GridPreloader::WorkerThread()
+{
+    while (true)
+    {
+        uint64 key;
+        std::unique_ptr<PreloadedGrid> grid;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _workCondition.wait(lock, [this] { return _cancelationToken || !_queue.empty(); });
+            if (_cancelationToken)
+                return;
+
+            key = _queue.front();
+            _queue.pop_front();
+
+            auto itr = _entries.find(key);
+            if (itr == _entries.end())
+                continue;
+
+            itr->second.state = STATE_LOADING;
+            grid = std::make_unique<PreloadedGrid>(uint32(key >> 32), int32((key >> 16) & 0xFFFF), int32(key & 0xFFFF));
+        }
+
+        Load(*grid);
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            auto itr = _entries.find(key);
+            if (itr != _entries.end())
+            {
+                itr->second.state = STATE_READY;
+                itr->second.readyTime = GetMSTime();
+                itr->second.grid = std::move(grid);
+            }
+        }
+        _readyCondition.notify_all();
+        // grid is released here if preloader was deactivated meanwhile
+    }
+}
@@ -0,0 +1,89 @@
+
+#ifndef _GRID_PRELOADER_H_INCLUDED
+#define _GRID_PRELOADER_H_INCLUDED
+
+#include "Define.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class GridMap;
+
+// Interval at which maps look for grids their players are about to enter
+uint32 const GRID_PRELOAD_REQUEST_INTERVAL = 500;
+
+// Grid files read ahead of time, to be linked in a map by Map::LoadMapAndVMap
+struct PreloadedGrid
+{
+    PreloadedGrid(uint32 _mapId, int32 _gx, int32 _gy);
+    ~PreloadedGrid(); //release vmap models references
+
+    uint32 const mapId;
+    int32 const gx;
+    int32 const gy;
+
+    std::unique_ptr<GridMap> gridMap;
+    // vmap models acquired while preloading, the tile holds its own references once loaded
+    std::vector<std::string> vmapModels;
+};
+
+/**
+Read grids terrain, vmap models and mmap tiles on I/O threads before the grid is actually needed.
+Maps request grids their players are about to reach, and take the result when loading the grid. Only the base
+maps load grids files, so grid coordinates are always for the base map of given map id.
+*/
+class GridPreloader
+{
+public:
+    GridPreloader() : _cancelationToken(false) {}
+    ~GridPreloader();
+
+    void activate(size_t num_threads);
+    void deactivate();
+    bool activated() const { return !_workerThreads.empty(); }
+
+    // Queue grid files reading if not already requested. Can be called from any map thread.
+    void RequestGrid(uint32 mapId, int32 gx, int32 gy);
+    // Returns preloaded grid files, or nullptr if grid was not requested. Wait for the files if they are being read.
+    std::unique_ptr<PreloadedGrid> TakeGrid(uint32 mapId, int32 gx, int32 gy);
+    // Drop preloaded grids that were never taken. Called from world thread.
+    void Update(uint32 diff);
+
+    uint32 GetPendingCount();
+
+private:
+    enum State
+    {
+        STATE_PENDING,
+        STATE_LOADING,
+        STATE_READY,
+    };
+
+    struct Entry
+    {
+        State state = STATE_PENDING;
+        uint32 readyTime = 0;
+        std::unique_ptr<PreloadedGrid> grid;
+    };
+
+    static uint64 MakeKey(uint32 mapId, int32 gx, int32 gy) { return (uint64(mapId) << 32) | (uint32(gx) << 16) | uint32(gy); }
+    static void Load(PreloadedGrid& grid);
+
+    void WorkerThread();
+
+    std::mutex _lock;
+    std::condition_variable _workCondition;
+    std::condition_variable _readyCondition;
+    std::unordered_map<uint64, Entry> _entries;
+    std::deque<uint64> _queue;
+    std::vector<std::thread> _workerThreads;
+    bool _cancelationToken;
+    uint32 _expireTimer = 0;
+};
+
+#endif //_GRID_PRELOADER_H_INCLUDED
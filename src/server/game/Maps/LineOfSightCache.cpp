@@ -0,0 +1,145 @@
+#include "LineOfSightCache.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+bool LineOfSightCache::Key::operator==(Key const& other) const
+{
+    return std::equal(std::begin(coords), std::end(coords), std::begin(other.coords))
+        && phaseMask == other.phaseMask && flags == other.flags;
+}
+
+void LineOfSightCache::SetSize(uint32 size)
+{
+    _entries.clear();
+    _regions.clear();
+    _mask = 0;
+    if (!size)
+        return;
+
+    uint32 capacity = 1;
+    while (capacity < size)
+        capacity <<= 1;
+
+    _entries.resize(capacity);
+    for (Entry& entry : _entries)
+        entry.stamp = 0;
+    _mask = capacity - 1;
+    _regions.assign(LOS_CACHE_REGION_SLOTS, 0);
+}
+
+LineOfSightCache::Key LineOfSightCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 flags)
+{
+    float const scale = 1.0f / LOS_CACHE_PRECISION;
+    int32 start[3] = { int32(std::floor(x1 * scale)), int32(std::floor(y1 * scale)), int32(std::floor(z1 * scale)) };
+    int32 end[3] = { int32(std::floor(x2 * scale)), int32(std::floor(y2 * scale)), int32(std::floor(z2 * scale)) };
+
+    // a ray and its reverse share the same key
+    if (std::lexicographical_compare(std::begin(end), std::end(end), std::begin(start), std::end(start)))
+        std::swap(start, end);
+
+    Key key;
+    std::copy(std::begin(start), std::end(start), key.coords);
+    std::copy(std::begin(end), std::end(end), key.coords + 3);
+    key.phaseMask = phaseMask;
+    key.flags = flags;
+    return key;
+}
+
+LineOfSightCache::Entry& LineOfSightCache::GetEntry(Key const& key)
+{
+    // FNV-1a over the key values
+    uint64 hash = 14695981039346656037ULL;
+    for (int32 coord : key.coords)
+        hash = (hash ^ uint32(coord)) * 1099511628211ULL;
+    hash = (hash ^ key.phaseMask) * 1099511628211ULL;
+    hash = (hash ^ key.flags) * 1099511628211ULL;
+
+    return _entries[size_t(hash ^ (hash >> 32)) & _mask];
+}
+
+uint32 LineOfSightCache::GetRegionSlot(int32 regionX, int32 regionY)
+{
+    uint32 const hash = (uint32(regionX) * 73856093u) ^ (uint32(regionY) * 19349663u);
+    return hash & (LOS_CACHE_REGION_SLOTS - 1);
+}
+
+bool LineOfSightCache::GetRegions(Key const& key, int32& minX, int32& minY, int32& maxX, int32& maxY)
+{
+    // key coords are in LOS_CACHE_PRECISION units
+    float const regionScale = LOS_CACHE_PRECISION / LOS_CACHE_REGION_SIZE;
+    minX = int32(std::floor(std::min(key.coords[0], key.coords[3]) * regionScale));
+    maxX = int32(std::floor(std::max(key.coords[0], key.coords[3]) * regionScale));
+    minY = int32(std::floor(std::min(key.coords[1], key.coords[4]) * regionScale));
+    maxY = int32(std::floor(std::max(key.coords[1], key.coords[4]) * regionScale));
+    return maxX - minX < LOS_CACHE_MAX_REGION_SPAN && maxY - minY < LOS_CACHE_MAX_REGION_SPAN;
+}
+
+bool LineOfSightCache::Get(Key const& key, bool& inLineOfSight)
+{
+    Entry& entry = GetEntry(key);
+    int32 minX, minY, maxX, maxY;
+    if (entry.stamp < _validFrom || !(entry.key == key) || !GetRegions(key, minX, minY, maxX, maxY))
+    {
+        ++_misses;
+        return false;
+    }
+
+    // collision changed in a region crossed by the ray since it was stored
+    for (int32 x = minX; x <= maxX; ++x)
+    {
+        for (int32 y = minY; y <= maxY; ++y)
+        {
+            if (_regions[GetRegionSlot(x, y)] > entry.stamp)
+            {
+                ++_misses;
+                return false;
+            }
+        }
+    }
+
+    ++_hits;
+    inLineOfSight = entry.inLineOfSight;
+    return true;
+}
+
+void LineOfSightCache::Store(Key const& key, bool inLineOfSight)
+{
+    int32 minX, minY, maxX, maxY;
+    if (!GetRegions(key, minX, minY, maxX, maxY))
+        return;
+
+    Entry& entry = GetEntry(key);
+    entry.key = key;
+    entry.stamp = _clock;
+    entry.inLineOfSight = inLineOfSight;
+}
+
+void LineOfSightCache::Invalidate(float minX, float minY, float maxX, float maxY)
+{
+    if (!IsEnabled())
+        return;
+
+    int32 const regionMinX = int32(std::floor(minX / LOS_CACHE_REGION_SIZE));
+    int32 const regionMinY = int32(std::floor(minY / LOS_CACHE_REGION_SIZE));
+    int32 const regionMaxX = int32(std::floor(maxX / LOS_CACHE_REGION_SIZE));
+    int32 const regionMaxY = int32(std::floor(maxY / LOS_CACHE_REGION_SIZE));
+    if (regionMaxX - regionMinX >= LOS_CACHE_MAX_REGION_SPAN || regionMaxY - regionMinY >= LOS_CACHE_MAX_REGION_SPAN)
+    {
+        Invalidate();
+        return;
+    }
+
+    uint64 const stamp = ++_clock;
+    for (int32 x = regionMinX; x <= regionMaxX; ++x)
+        for (int32 y = regionMinY; y <= regionMaxY; ++y)
+            _regions[GetRegionSlot(x, y)] = stamp;
+}
+
+void LineOfSightCache::TakeCounters(uint32& hits, uint32& misses)
+{
+    hits = _hits;
+    misses = _misses;
+    _hits = 0;
+    _misses = 0;
+}
@@ -0,0 +1,79 @@
+#ifndef _LINE_OF_SIGHT_CACHE_H_INCLUDED
+#define _LINE_OF_SIGHT_CACHE_H_INCLUDED
+
+#include "Define.h"
+#include <vector>
+
+// Rays endpoints are rounded to this many yards before lookup
+#define LOS_CACHE_PRECISION 0.25f
+// Collision changes only drop the results of rays crossing the regions (squares of this many yards) they touch
+#define LOS_CACHE_REGION_SIZE 32.0f
+// Regions are hashed into this many invalidation slots, a power of 2
+#define LOS_CACHE_REGION_SLOTS 4096
+// Rays or bounds spanning more regions than this along an axis are not cached / drop the whole cache
+#define LOS_CACHE_MAX_REGION_SPAN 8
+
+/**
+Short lived cache of a map line of sight results.
+Rays endpoints are quantized (see LOS_CACHE_PRECISION) and ordered, so that rays cast back and forth between nearly the
+same positions share the same entry. Each ray has a single slot in the cache, a new result replaces the one stored there.
+Invalidate(minX, minY, maxX, maxY) drops the results of rays crossing the regions of a gameobject model whose collision
+changed, Invalidate() drops all results at regular interval.
+Not thread safe, see Map::isInLineOfSight.
+*/
+class TC_GAME_API LineOfSightCache
+{
+public:
+    struct Key
+    {
+        int32 coords[6];
+        uint32 phaseMask;
+        uint32 flags; // checks and model ignore flags
+
+        bool operator==(Key const& other) const;
+    };
+
+    LineOfSightCache() : _mask(0), _clock(1), _validFrom(1), _hits(0), _misses(0) {}
+
+    // Number of results held, rounded up to a power of 2. 0 disables the cache.
+    void SetSize(uint32 size);
+    bool IsEnabled() const { return !_entries.empty(); }
+
+    static Key MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 flags);
+
+    // Returns false if ray result is not known
+    bool Get(Key const& key, bool& inLineOfSight);
+    void Store(Key const& key, bool inLineOfSight);
+    void Invalidate() { _validFrom = ++_clock; }
+    // Drop results of rays crossing this area
+    void Invalidate(float minX, float minY, float maxX, float maxY);
+
+    // Hits and misses since last call
+    void TakeCounters(uint32& hits, uint32& misses);
+
+private:
+    struct Entry
+    {
+        Key key;
+        uint64 stamp; // _clock when stored
+        bool inLineOfSight;
+    };
+
+    Entry& GetEntry(Key const& key);
+    static uint32 GetRegionSlot(int32 regionX, int32 regionY);
+    // Region range crossed by a ray, false if too large to be cached
+    static bool GetRegions(Key const& key, int32& minX, int32& minY, int32& maxX, int32& maxY);
+
+    std::vector<Entry> _entries;
+    uint32 _mask;
+    // _clock value of the last invalidation of each region slot
+    std::vector<uint64> _regions;
+    // incremented at each invalidation
+    uint64 _clock;
+    // entries stored before this are outdated
+    uint64 _validFrom;
+    uint32 _hits;
+    uint32 _misses;
+};
+
+#endif //_LINE_OF_SIGHT_CACHE_H_INCLUDED
@@ -38,6 +38,9 @@
 #include "ScriptMgr.h"
 #include "GameTime.h"
 #include "PathGenerator.h"
+#include "MapGridUpdater.h"
+#include "GridPreloader.h"
+#include "Monitor.h"
 #ifdef TESTS
 #include "TestCase.h"
 #include "TestThread.h"
@@ -81,6 +84,8 @@ Map::~Map()
         sMapMgr->DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), i_InstanceId);
+
+    sMonitor->MapRemoved(*this);
 }
 
 void Map::ReloadMMap(int gx, int gy)
@@ -122,10 +127,11 @@ void Map::LoadVMap(int x,int y)
     }
 }
 
-void Map::LoadMap(int gx, int gy, bool reload)
+void Map::LoadMap(int gx, int gy, bool reload, GridMap* preloadedGridMap)
 {
     if (i_InstanceId != 0)
     {
+        delete preloadedGridMap;
         if(GridMaps[gx][gy])
             return;
 
@@ -139,7 +145,10 @@ void Map::LoadMap(int gx, int gy, bool reload)
     }
 
     if (GridMaps[gx][gy] && !reload)
+    {
+        delete preloadedGridMap;
         return;
+    }
 
     //map already load, delete it before reloading (Is it necessary? Do we really need the ability the reload maps during runtime?)
     if (GridMaps[gx][gy])
@@ -151,31 +160,44 @@ void Map::LoadMap(int gx, int gy, bool reload)
         GridMaps[gx][gy] = nullptr;
     }
 
-    // map file name
-    char *tmp = nullptr;
-    // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
-    int len = sWorld->GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
-    tmp = new char[len];
-    snprintf(tmp, len, (char *)(sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), GetId(), gx, gy);
-    TC_LOG_DEBUG("maps","Loading map %s",tmp);
-    // loading data
-    GridMaps[gx][gy] = new GridMap();
-    if (!GridMaps[gx][gy]->loadData(tmp))
-        TC_LOG_ERROR("maps","ERROR loading map file: \n %s\n", tmp);
+    if (preloadedGridMap)
+        GridMaps[gx][gy] = preloadedGridMap;
+    else
+    {
+        // map file name
+        char *tmp = nullptr;
+        // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
+        int len = sWorld->GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
+        tmp = new char[len];
+        snprintf(tmp, len, (char *)(sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), GetId(), gx, gy);
+        TC_LOG_DEBUG("maps","Loading map %s",tmp);
+        // loading data
+        GridMaps[gx][gy] = new GridMap();
+        if (!GridMaps[gx][gy]->loadData(tmp))
+            TC_LOG_ERROR("maps","ERROR loading map file: \n %s\n", tmp);
 
-    delete [] tmp;
+        delete [] tmp;
+    }
 
     sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
-    LoadMap(gx, gy);
     if (i_InstanceId == 0) //Only load data for the base map
     {
+        // files may already have been read by the grid preloader, only link them in this case
+        std::unique_ptr<PreloadedGrid> preloaded;
+        if (sMapMgr->GetGridPreloader()->activated())
+            preloaded = sMapMgr->GetGridPreloader()->TakeGrid(GetId(), gx, gy);
+
+        LoadMap(gx, gy, false, preloaded ? preloaded->gridMap.release() : nullptr);
         LoadVMap(gx, gy);
         LoadMMap(gx, gy);
+        // preloaded vmap models references are released here, tile holds its own references now
     }
+    else
+        LoadMap(gx, gy);
 }
 
 void Map::InitStateMachine()
@@ -203,9 +225,10 @@ Map::Map(MapType type, uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnM
    _transportsUpdateIter(_transports.end()),
    _defaultLight(GetDefaultMapLight(id)),
    i_mapType(type), i_gridExpiry(expiry), _respawnCheckTimer(0),
-   i_scriptLock(false), m_disableMapObjects(false), GameTime(WorldGameTime::GetGameTime()), GameMSTime(WorldGameTime::GetGameTimeMS())
+   _collectCellsToUpdate(false), _parallelUpdating(false), _gridPreloadTimer(0), _lineOfSightCacheTimer(0), _recordLineOfSightQueries(false), i_scriptLock(false), m_disableMapObjects(false), GameTime(WorldGameTime::GetGameTime()), GameMSTime(WorldGameTime::GetGameTimeMS())
 {
     m_parentMap = (_parent ? _parent : this);
+    _lineOfSightCache.SetSize(sWorld->getIntConfig(CONFIG_LOS_CACHE_SIZE));
     for(uint32 idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
         for(uint32 j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
@@ -573,6 +596,8 @@ bool Map::AddToMap(T* obj, bool checkTransport)
 
     assert(obj);
 
+    auto lock = LockForParallelUpdate();
+
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -790,6 +815,12 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
 
             markCell(cell_id);
             CellCoord pair(x, y);
+            if (_collectCellsToUpdate)
+            {
+                _cellsToUpdate.push_back(pair);
+                continue;
+            }
+
             Cell cell(pair);
             cell.SetNoCreate();
             Visit(cell, gridVisitor);
@@ -798,6 +829,80 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     }
 }
 
+bool Map::CanUpdateGridsInParallel() const
+{
+    if (Instanceable() || !sMapMgr->GetGridUpdater()->activated())
+        return false;
+
+    return m_mapRefManager.getSize() >= sWorld->getIntConfig(CONFIG_MAP_PARALLEL_GRIDS_MIN_PLAYERS);
+}
+
+void Map::UpdateCollectedCells(uint32 diff, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer>& gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer>& worldVisitor)
+{
+    uint32 const borderSize = sWorld->getIntConfig(CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS);
+
+    // Split cells between grids interiors (one region per grid) and grids borders
+    std::map<uint32 /*gridId*/, std::vector<Cell>> regions;
+    std::vector<Cell> borderCells;
+    for (CellCoord const& coord : _cellsToUpdate)
+    {
+        Cell cell(coord);
+        cell.SetNoCreate();
+        if (!IsGridLoaded(GridCoord(cell.GridX(), cell.GridY())))
+            continue;
+
+        // grid objects may still need to be loaded, do it now while we're alone
+        EnsureGridLoaded(cell);
+
+        bool const isBorder = cell.CellX() < borderSize || cell.CellX() >= MAX_NUMBER_OF_CELLS - borderSize
+            || cell.CellY() < borderSize || cell.CellY() >= MAX_NUMBER_OF_CELLS - borderSize;
+        if (isBorder)
+            borderCells.push_back(cell);
+        else
+            regions[cell.GridY() * MAX_NUMBER_OF_GRIDS + cell.GridX()].push_back(cell);
+    }
+
+    // Parallel phase
+    std::vector<std::vector<WorldObject*>> deferred(regions.size());
+    std::vector<MapGridUpdater::Task> tasks;
+    tasks.reserve(regions.size());
+    uint32 regionIndex = 0;
+    for (auto const& region : regions)
+    {
+        std::vector<Cell> const& cells = region.second;
+        std::vector<WorldObject*>& regionDeferred = deferred[regionIndex++];
+        tasks.push_back([this, diff, &cells, &regionDeferred]()
+        {
+            Trinity::ParallelObjectUpdater updater(diff, regionDeferred);
+            TypeContainerVisitor<Trinity::ParallelObjectUpdater, GridTypeMapContainer> visitor(updater);
+            for (Cell const& cell : cells)
+                getNGrid(cell.GridX(), cell.GridY())->VisitGrid(cell.CellX(), cell.CellY(), visitor);
+        });
+    }
+
+    _parallelUpdating = true;
+    sMapMgr->GetGridUpdater()->run(tasks);
+    _parallelUpdating = false;
+
+    // Serial phase
+    for (std::vector<WorldObject*> const& regionDeferred : deferred)
+        for (WorldObject* obj : regionDeferred)
+            if (obj->IsInWorld())
+                obj->Update(diff);
+
+    for (Cell const& cell : borderCells)
+        Visit(cell, gridVisitor);
+
+    for (CellCoord const& coord : _cellsToUpdate)
+    {
+        Cell cell(coord);
+        cell.SetNoCreate();
+        Visit(cell, worldVisitor);
+    }
+
+    _cellsToUpdate.clear();
+}
+
 void Map::DoUpdate(uint32 maxDiff, uint32 minimumTimeSinceLastUpdate /* = 0*/)
 {
     uint32 now = GetMSTime();
@@ -828,12 +933,77 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
     ++_zonePlayerCountMap[newZone];
 }
 
+void Map::RequestGridsAhead()
+{
+    // instances grids are all loaded along with their base map, only continents are worth it
+    if (Instanceable())
+        return;
+
+    GridPreloader* preloader = sMapMgr->GetGridPreloader();
+    uint32 const lookAhead = sWorld->getIntConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD);
+    std::vector<G3D::Vector3> positions;
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        positions.clear();
+        if (!player->movespline->Finalized())
+            player->movespline->GetPathAhead(int32(lookAhead), positions); // taxi flights and other splines
+        else if (player->isMoving())
+        {
+            // straight line at current speed, sampled every half grid so that we don't skip any crossed grid
+            float const distance = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * lookAhead / IN_MILLISECONDS;
+            float angle = player->GetOrientation();
+            if (player->HasUnitMovementFlag(MOVEMENTFLAG_BACKWARD))
+                angle += float(M_PI);
+
+            uint32 const steps = uint32(distance / (SIZE_OF_GRIDS / 2)) + 1;
+            for (uint32 i = 1; i <= steps; ++i)
+            {
+                float const dist = distance * i / steps;
+                positions.emplace_back(player->GetPositionX() + dist * std::cos(angle), player->GetPositionY() + dist * std::sin(angle), player->GetPositionZ());
+            }
+        }
+
+        for (G3D::Vector3 const& pos : positions)
+        {
+            GridCoord p = Trinity::ComputeGridCoord(pos.x, pos.y);
+            if (!p.IsCoordValid())
+                continue;
+
+            int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+            int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+            if (!GridMaps[gx][gy])
+                preloader->RequestGrid(GetId(), gx, gy);
+        }
+    }
+}
+
 void Map::Update(const uint32& t_diff)
 {
     GameTime = time(nullptr);
     GameMSTime = GetMSTime();
 
     _dynamicTree.update(t_diff);
+
+    _recordLineOfSightQueries = sLog->ShouldLog("maps.los", LOG_LEVEL_TRACE);
+    if (_lineOfSightCache.IsEnabled())
+    {
+        _lineOfSightCacheTimer += t_diff;
+        if (_lineOfSightCacheTimer >= sWorld->getIntConfig(CONFIG_LOS_CACHE_LIFETIME))
+        {
+            _lineOfSightCacheTimer = 0;
+            _lineOfSightCache.Invalidate();
+        }
+
+        uint32 hits, misses;
+        _lineOfSightCache.TakeCounters(hits, misses);
+        if (hits || misses)
+            sMonitor->LineOfSightCacheQueried(hits, misses);
+    }
+
     /// update worldsessions for existing players
     for(m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -844,6 +1014,11 @@ void Map::Update(const uint32& t_diff)
             MapSessionFilter updater(pSession);
 
             pSession->Update(t_diff, updater);
+
+            #ifdef PLAYERBOT
+            if (plr->GetPlayerbotAI() && !plr->IsBeingTeleported())
+                pSession->HandleBotPackets(updater);
+            #endif
         }
     }
 
@@ -856,8 +1031,22 @@ void Map::Update(const uint32& t_diff)
     else
         _respawnCheckTimer -= t_diff;
 
+    if (sMapMgr->GetGridPreloader()->activated())
+    {
+        if (_gridPreloadTimer <= t_diff)
+        {
+            RequestGridsAhead();
+            _gridPreloadTimer = GRID_PRELOAD_REQUEST_INTERVAL;
+        }
+        else
+            _gridPreloadTimer -= t_diff;
+    }
+
     resetMarkedCells();
 
+    bool const parallelGridsUpdate = CanUpdateGridsInParallel();
+    _collectCellsToUpdate = parallelGridsUpdate;
+
     Trinity::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
@@ -919,6 +1108,12 @@ void Map::Update(const uint32& t_diff)
         VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
     }
 
+    if (parallelGridsUpdate)
+    {
+        _collectCellsToUpdate = false;
+        UpdateCollectedCells(t_diff, grid_object_update, world_object_update);
+    }
+
     //update our transports
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
@@ -1186,6 +1381,8 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float ang)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1196,6 +1393,8 @@ void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1205,6 +1404,8 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, float ang)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1215,6 +1416,8 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
 
 void Map::RemoveGameObjectFromMoveList(GameObject* go)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1224,6 +1427,8 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, float z, float ang)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1234,6 +1439,8 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
 
 void Map::RemoveDynamicObjectFromMoveList(DynamicObject* dynObj)
 {
+    auto lock = LockForParallelUpdate();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -2271,13 +2478,92 @@ float Map::GetGameObjectCeil(uint32 phasemask, float x, float y, float z, float
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
+    LineOfSightCache::Key key;
+    if (_lineOfSightCache.IsEnabled())
+    {
+        key = LineOfSightCache::MakeKey(x1, y1, z1, x2, y2, z2, phasemask, uint32(checks) | (uint32(ignoreFlags) << 8));
+        bool inLineOfSight;
+        auto lock = LockForParallelUpdate();
+        if (_lineOfSightCache.Get(key, inLineOfSight))
+            return inLineOfSight;
+    }
+
+    // recorded queries can be replayed with vmap_los_bench
+    if (_recordLineOfSightQueries && (checks & LINEOFSIGHT_CHECK_VMAP))
+        TC_LOG_TRACE("maps.los", "LOS query %u %f %f %f %f %f %f", GetId(), x1, y1, z1, x2, y2, z2);
+
+    bool inLineOfSight = true;
     if ((checks & LINEOFSIGHT_CHECK_VMAP)
         && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
-        return false;
-    if (/*sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && */(checks & LINEOFSIGHT_CHECK_GOBJECT)
+        inLineOfSight = false;
+    else if (/*sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && */(checks & LINEOFSIGHT_CHECK_GOBJECT)
         && !_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask))
-        return false;
-    return true;
+        inLineOfSight = false;
+
+    if (_lineOfSightCache.IsEnabled())
+    {
+        auto lock = LockForParallelUpdate();
+        _lineOfSightCache.Store(key, inLineOfSight);
+    }
+    return inLineOfSight;
+}
+
+void Map::isInLineOfSight(VMAP::LineOfSightRay* rays, size_t count, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    uint32 const flags = uint32(checks) | (uint32(ignoreFlags) << 8);
+    // rays found in cache are marked out of line of sight to be skipped by tree queries, their result is restored afterwards
+    std::vector<std::pair<size_t, bool>> cachedResults;
+    if (_lineOfSightCache.IsEnabled())
+    {
+        auto lock = LockForParallelUpdate();
+        for (size_t i = 0; i < count; ++i)
+        {
+            VMAP::LineOfSightRay& ray = rays[i];
+            bool inLineOfSight;
+            if (_lineOfSightCache.Get(LineOfSightCache::MakeKey(ray.x1, ray.y1, ray.z1, ray.x2, ray.y2, ray.z2, phasemask, flags), inLineOfSight))
+            {
+                cachedResults.emplace_back(i, inLineOfSight);
+                ray.inLineOfSight = false;
+            }
+            else
+                ray.inLineOfSight = true;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            rays[i].inLineOfSight = true;
+    }
+
+    if (cachedResults.size() < count)
+    {
+        if (checks & LINEOFSIGHT_CHECK_VMAP)
+        {
+            for (size_t i = 0; _recordLineOfSightQueries && i < count; ++i)
+                if (rays[i].inLineOfSight)
+                    TC_LOG_TRACE("maps.los", "LOS query %u %f %f %f %f %f %f", GetId(), rays[i].x1, rays[i].y1, rays[i].z1, rays[i].x2, rays[i].y2, rays[i].z2);
+            VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), rays, count, ignoreFlags);
+        }
+        if (/*sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && */checks & LINEOFSIGHT_CHECK_GOBJECT)
+            _dynamicTree.isInLineOfSight(rays, count, phasemask);
+    }
+
+    if (!_lineOfSightCache.IsEnabled())
+        return;
+
+    auto lock = LockForParallelUpdate();
+    auto cached = cachedResults.begin();
+    for (size_t i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightRay& ray = rays[i];
+        if (cached != cachedResults.end() && cached->first == i)
+        {
+            ray.inLineOfSight = cached->second;
+            ++cached;
+        }
+        else
+            _lineOfSightCache.Store(LineOfSightCache::MakeKey(ray.x1, ray.y1, ray.z1, ray.x2, ray.y2, ray.z2, phasemask, flags), ray.inLineOfSight);
+    }
 }
 
 bool Map::IsInWater(float x, float y, float pZ, LiquidData *data) const
@@ -2435,12 +2721,11 @@ void Map::SendObjectUpdates()
         obj->BuildUpdate(update_players, player_set);
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
     for (auto & update_player : update_players)
     {
+        WorldPacket packet;
         update_player.second.BuildPacket(&packet, false);
-        update_player.first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
+        update_player.first->GetSession()->SendPacket(std::move(packet)); // moved to the socket, not copied
     }
 }
 
@@ -2492,6 +2777,8 @@ void Map::AddObjectToRemoveList(WorldObject *obj)
 {
     assert(obj->GetMapId()==GetId() && obj->GetInstanceId()==GetInstanceId());
 
+    auto lock = LockForParallelUpdate();
+
     obj->CleanupsBeforeDelete(false); 
 
     i_objectsToRemove.insert(obj);
@@ -2502,6 +2789,8 @@ void Map::AddObjectToSwitchList(WorldObject *obj, bool on)
 {
     assert(obj->GetMapId()==GetId() && obj->GetInstanceId()==GetInstanceId());
 
+    auto lock = LockForParallelUpdate();
+
     auto itr = i_objectsToSwitch.find(obj);
     if(itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2593,8 +2882,13 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket* data) const
 {
+    if (m_mapRefManager.isEmpty())
+        return;
+
+    // copy payload once for all players
+    std::shared_ptr<WorldPacket const> sharedData = std::make_shared<WorldPacket>(*data);
     for(const auto & itr : m_mapRefManager)
-        itr.GetSource()->SendDirectMessage(data);
+        itr.GetSource()->SendDirectMessage(sharedData);
 }
 
 bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
@@ -2634,6 +2928,8 @@ bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 
 void Map::AddToForceActive( Creature* c)
 {
+    auto lock = LockForParallelUpdate();
+
     AddToForceActiveHelper(c);
 
     // also not allow unloading spawn grid to prevent creating creature clone at load
@@ -2653,6 +2949,8 @@ void Map::AddToForceActive( Creature* c)
 
 void Map::RemoveFromForceActive( Creature* c)
 {
+    auto lock = LockForParallelUpdate();
+
     RemoveFromForceActiveHelper(c);
 
     // also allow unloading spawn grid
@@ -2677,26 +2975,31 @@ Player* Map::GetPlayer(ObjectGuid const& guid)
 
 Corpse* Map::GetCorpse(ObjectGuid const& guid)
 {
+    auto lock = LockForParallelUpdate();
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    auto lock = LockForParallelUpdate();
     return _objectsStore.Find<Creature>(guid);
 }
 
 GameObject* Map::GetGameObject(ObjectGuid const& guid)
 {
+    auto lock = LockForParallelUpdate();
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const& guid)
 {
+    auto lock = LockForParallelUpdate();
     return _objectsStore.Find<Pet>(guid);
 }
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid const& guid)
 {
+    auto lock = LockForParallelUpdate();
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
@@ -3633,6 +3936,8 @@ bool Map::IsBattlegroundOrArena() const { return i_mapEntry && i_mapEntry->IsBat
 
 void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 entry, time_t respawnTime, uint32 zoneId, uint32 gridId, bool writeDB, bool replace, SQLTransaction dbTrans)
 {
+    auto lock = LockForParallelUpdate();
+
     if (!respawnTime)
     {
         // Delete only
@@ -4474,6 +4779,7 @@ void Map::RemoveGameObjectModel(GameObjectModel const& model)
 { 
     TC_LOG_TRACE("maps", "Map %u - Removed model %s", GetId(), model.name.c_str());
     _dynamicTree.remove(model); 
+    InvalidateLineOfSightCache(model);
 }
 
 void Map::InsertGameObjectModel(GameObjectModel const& model) 
@@ -4481,6 +4787,17 @@ void Map::InsertGameObjectModel(GameObjectModel const& model)
     TC_LOG_TRACE("maps", "Map %u - Added model %s", GetId(), model.name.c_str());
     ASSERT(!_dynamicTree.contains(model));
     _dynamicTree.insert(model); 
+    InvalidateLineOfSightCache(model);
+}
+
+void Map::InvalidateLineOfSightCache(GameObjectModel const& model)
+{
+    if (!_lineOfSightCache.IsEnabled())
+        return;
+
+    G3D::AABox const& bounds = model.getBounds();
+    auto lock = LockForParallelUpdate();
+    _lineOfSightCache.Invalidate(bounds.low().x, bounds.low().y, bounds.high().x, bounds.high().y);
 }
 
 bool Map::ContainsGameObjectModel(GameObjectModel const& model) const 
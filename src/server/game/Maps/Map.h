@@ -9,6 +9,7 @@
 #include "MapRefManager.h"
 #include "MPSCQueue.h"
 #include "DynamicTree.h"
+#include "LineOfSightCache.h"
 #include "Models/GameObjectModel.h"
 #include <boost/heap/fibonacci_heap.hpp>
 #include "ObjectGuid.h"
@@ -193,6 +194,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T> void RemoveFromMap(T *, bool);
 
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        // Is this map big and crowded enough for its grids to be updated in parallel (see MapUpdate.ParallelGrids config)
+        bool CanUpdateGridsInParallel() const;
         //this wrap map udpates and call it with diff since last updates. If minimumTimeSinceLastUpdate, the thread will sleep until minimumTimeSinceLastUpdate is reached
         void DoUpdate(uint32 maxDiff, uint32 minimumTimeSinceLastUpdate = 0);
         virtual void Update(const uint32&);
@@ -243,14 +246,25 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
 		void AddUpdateObject(Object* obj)
 		{
+			auto lock = LockForParallelUpdate();
 			_updateObjects.insert(obj);
 		}
 
 		void RemoveUpdateObject(Object* obj)
 		{
+			auto lock = LockForParallelUpdate();
 			_updateObjects.erase(obj);
 		}
 
+		// Returns a lock on map shared containers if grids are currently updated in parallel, an empty lock otherwise
+		std::unique_lock<std::recursive_mutex> LockForParallelUpdate() const
+		{
+			if (_parallelUpdating)
+				return std::unique_lock<std::recursive_mutex>(_parallelUpdateLock);
+
+			return std::unique_lock<std::recursive_mutex>();
+		}
+
         virtual std::string GetDebugInfo() const;
 
         // some calls like isInWater should not use vmaps due to processor power
@@ -287,6 +301,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         Transport* GetTransportForPos(uint32 phase, float x, float y, float z, WorldObject* worldobject = nullptr);
 
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
+        // Same as above for several rays at once, results are written in rays
+        void isInLineOfSight(VMAP::LineOfSightRay* rays, size_t count, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
+        bool IsLineOfSightCacheEnabled() const { return _lineOfSightCache.IsEnabled(); }
+        // Drop line of sight results cached for rays crossing this model, to be called when its collision changes
+        void InvalidateLineOfSightCache(GameObjectModel const& model);
         void Balance() { _dynamicTree.balance(); }
         //get dynamic collision (gameobjects only ?)
         bool getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
@@ -450,8 +469,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint32 GetPlayersCountExceptGMs() const;
 		bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
 
-		void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-		void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+		void AddWorldObject(WorldObject* obj) { auto lock = LockForParallelUpdate(); i_worldObjects.insert(obj); }
+		void RemoveWorldObject(WorldObject* obj) { auto lock = LockForParallelUpdate(); i_worldObjects.erase(obj); }
 
 		/*
         void AddUnitToNotify(Unit* unit);
@@ -547,7 +566,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int pX, int pY);
-        void LoadMap(int gx, int gy, bool reload = false);
+        // preloadedGridMap: terrain already read by the grid preloader, Map takes its ownership
+        void LoadMap(int gx, int gy, bool reload = false, GridMap* preloadedGridMap = nullptr);
         void LoadMMap(int gx, int gy);
         GridMap* GetGrid(float x, float y);
 
@@ -656,6 +676,28 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 		//visibility calculations. Highly optimized for massive calculations
 		void ProcessRelocationNotifies(const uint32 diff);
 
+		/* Parallel grids update. Cells visited by VisitNearbyCellsOf are collected instead of being updated right away, then:
+		- cells away from their grid borders are updated in parallel, one task per grid. Objects which may interact with
+		  other grids (in combat, casting, owned, traps, dynamic objects) are deferred to the serial phase
+		- deferred objects, border cells and world containers (players, pets, ...) are then updated serially
+		*/
+		void UpdateCollectedCells(uint32 diff, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer>& gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer>& worldVisitor);
+		bool _collectCellsToUpdate;
+		std::vector<CellCoord> _cellsToUpdate;
+		// true while grids tasks are running, shared containers must then be locked with LockForParallelUpdate
+		bool _parallelUpdating;
+		mutable std::recursive_mutex _parallelUpdateLock;
+
+		// Ask the grid preloader for grids players are about to enter, from their spline path or their current direction and speed
+		void RequestGridsAhead();
+		uint32 _gridPreloadTimer;
+
+		// Line of sight results, see LineOfSight.Cache config. Must be locked with LockForParallelUpdate.
+		mutable LineOfSightCache _lineOfSightCache;
+		uint32 _lineOfSightCacheTimer;
+		// Line of sight queries are traced to "maps.los" logger, checked once per update
+		bool _recordLineOfSightQueries;
+
 		bool i_scriptLock;
         std::set<WorldObject *> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
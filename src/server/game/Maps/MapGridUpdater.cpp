@@ -0,0 +1,124 @@
+
+#include "MapGridUpdater.h"
+#include "Errors.h"
+#include <condition_variable>
+#include <mutex>
+
+class MapGridUpdateBatch
+{
+    public:
+        MapGridUpdateBatch(std::vector<MapGridUpdater::Task> const& tasks, uint32 helpers) :
+            m_tasks(tasks),
+            m_nextTask(0),
+            m_remainingTasks(tasks.size()),
+            m_remainingHelpers(helpers)
+        {
+        }
+
+        // Process tasks until none is left to start
+        void Process()
+        {
+            while (true)
+            {
+                size_t const index = m_nextTask++;
+                if (index >= m_tasks.size())
+                    return;
+
+                m_tasks[index]();
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (--m_remainingTasks == 0)
+                    m_condition.notify_all();
+            }
+        }
+
+        // Called by a pool thread once it will not touch this batch anymore
+        void HelperDone()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (--m_remainingHelpers == 0)
+                m_condition.notify_all();
+        }
+
+        // Wait until all tasks are done and no pool thread still references this batch
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this]() { return m_remainingTasks == 0 && m_remainingHelpers == 0; });
+        }
+
+    private:
+        std::vector<MapGridUpdater::Task> const& m_tasks;
+        std::atomic<size_t> m_nextTask;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        size_t m_remainingTasks;
+        uint32 m_remainingHelpers;
+};
+
+MapGridUpdater::~MapGridUpdater()
+{
+    if (activated())
+        deactivate();
+}
+
+void MapGridUpdater::activate(size_t num_threads)
+{
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapGridUpdater::WorkerThread, this));
+}
+
+void MapGridUpdater::deactivate()
+{
+    _cancelationToken = true;
+
+    // release batches no thread picked yet, Cancel() would delete them and leave their Wait() blocked
+    MapGridUpdateBatch* batch = nullptr;
+    while (_queue.Pop(batch))
+        batch->HelperDone();
+
+    _queue.Cancel();
+
+    for (auto& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+}
+
+void MapGridUpdater::run(std::vector<Task> const& tasks)
+{
+    if (tasks.empty())
+        return;
+
+    //the calling thread takes part too, so don't wake more threads than needed
+    uint32 const helpers = uint32(std::min(tasks.size() - 1, _workerThreads.size()));
+    MapGridUpdateBatch batch(tasks, helpers);
+    for (uint32 i = 0; i < helpers; ++i)
+        _queue.Push(&batch);
+
+    batch.Process();
+    batch.Wait();
+}
+
+void MapGridUpdater::WorkerThread()
+{
+    while (1)
+    {
+        MapGridUpdateBatch* batch = nullptr;
+
+        _queue.WaitAndPop(batch);
+
+        if (_cancelationToken)
+        {
+            // the caller processes the remaining tasks itself, only release our reference
+            if (batch)
+                batch->HelperDone();
+            return;
+        }
+
+        ASSERT(batch);
+        batch->Process();
+        batch->HelperDone();
+    }
+}
@@ -0,0 +1,41 @@
+
+#ifndef _MAP_GRID_UPDATER_H_INCLUDED
+#define _MAP_GRID_UPDATER_H_INCLUDED
+
+#include "Define.h"
+#include "ProducerConsumerQueue.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+class MapGridUpdateBatch;
+
+/**
+Thread pool used by maps to update independent regions of grids at the same time.
+A map update thread hands a list of tasks to run(), processes tasks itself along with the pool threads and
+returns once they are all done. Several maps can run batches at the same time.
+*/
+class MapGridUpdater
+{
+public:
+    typedef std::function<void()> Task;
+
+    MapGridUpdater() : _cancelationToken(false) {}
+    ~MapGridUpdater();
+
+    void activate(size_t num_threads);
+    void deactivate();
+    bool activated() const { return !_workerThreads.empty(); }
+
+    // Run all given tasks and wait for them to be done. Tasks must not depend on each other.
+    void run(std::vector<Task> const& tasks);
+
+private:
+    void WorkerThread();
+
+    ProducerConsumerQueue<MapGridUpdateBatch*> _queue;
+    std::vector<std::thread> _workerThreads;
+    std::atomic<bool> _cancelationToken;
+};
+
+#endif //_MAP_GRID_UPDATER_H_INCLUDED
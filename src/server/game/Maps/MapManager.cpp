@@ -34,6 +34,16 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    // Continents grids parallel update
+    uint32 gridThreads = sWorld->getIntConfig(CONFIG_MAP_PARALLEL_GRIDS_THREADS);
+    if (gridThreads > 0)
+        m_gridUpdater.activate(gridThreads);
+
+    // Grids files reading ahead of players
+    uint32 preloadThreads = sWorld->getIntConfig(CONFIG_GRID_PRELOAD_THREADS);
+    if (preloadThreads > 0)
+        m_gridPreloader.activate(preloadThreads);
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -212,6 +222,9 @@ Map::EnterState MapManager::PlayerCannotEnter(uint32 mapid, Player* player, bool
 
 void MapManager::Update(time_t diff)
 {
+    if (m_gridPreloader.activated())
+        m_gridPreloader.Update(uint32(diff));
+
     i_timer.Update(diff);
     if (!i_timer.Passed())
         return;
@@ -275,6 +288,12 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (m_gridUpdater.activated())
+        m_gridUpdater.deactivate();
+
+    if (m_gridPreloader.activated())
+        m_gridPreloader.deactivate();
+
     Map::DeleteStateMachine();
 }
 
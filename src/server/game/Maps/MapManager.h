@@ -5,6 +5,8 @@
 #include "Define.h"
 #include "Map.h"
 #include "MapUpdater.h"
+#include "MapGridUpdater.h"
+#include "GridPreloader.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
 
@@ -104,6 +106,8 @@ class TC_GAME_API MapManager
         void SetNextInstanceId(uint32 nextInstanceId) { _nextInstanceId = nextInstanceId; };
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        MapGridUpdater* GetGridUpdater() { return &m_gridUpdater; }
+        GridPreloader* GetGridPreloader() { return &m_gridPreloader; }
 
         void MapCrashed(Map& map);
 
@@ -135,6 +139,8 @@ class TC_GAME_API MapManager
         InstanceIds _instanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        MapGridUpdater m_gridUpdater;
+        GridPreloader m_gridPreloader;
 
 		// atomic op counter for active scripts amount
 		std::atomic<std::size_t> _scheduledScripts;
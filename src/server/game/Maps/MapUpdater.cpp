@@ -10,6 +10,9 @@
 
 #define MINIMUM_MAP_UPDATE_INTERVAL 30
 
+//index of the worker running on this thread, -1 if not a map updater thread
+static thread_local int32 t_currentWorkerId = -1;
+
 class MapUpdateRequest
 {
     private:
@@ -18,19 +21,31 @@ class MapUpdateRequest
         MapUpdater& m_updater;
         uint32 m_diff;
         uint32 m_loopCount;
+        bool m_loop;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d) :
+        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, bool loop) :
             m_map(m), 
             m_updater(u), 
             m_diff(d), 
-            m_loopCount(0)
+            m_loopCount(0),
+            m_loop(loop)
         {
         }
 
         Map const* getMap() { return &m_map; }
 
+        // Loop requests are kept updating until all once requests are done
+        bool IsLoop() const { return m_loop; }
+        bool HasUpdated() const { return m_loopCount > 0; }
+        // Time until MINIMUM_MAP_UPDATE_INTERVAL is elapsed since last map update
+        uint32 GetTimeUntilDue() const
+        {
+            uint32 const sinceLastUpdate = GetMSTimeDiffToNow(m_map.GetLastMapUpdateTime());
+            return sinceLastUpdate >= MINIMUM_MAP_UPDATE_INTERVAL ? 0 : MINIMUM_MAP_UPDATE_INTERVAL - sinceLastUpdate;
+        }
+
         void call()
         {
             sMonitor->MapUpdateStart(m_map);
@@ -48,32 +63,35 @@ MapUpdater::~MapUpdater()
 
 void MapUpdater::activate(size_t num_threads)
 {
-    //spawn instances & battlegrounds threads
+    _cancelationToken = false;
+
     for (size_t i = 0; i < num_threads; ++i)
-        _loop_maps_workerThreads.push_back(std::thread(&MapUpdater::LoopWorkerThread, this, &_enable_updates_loop));
+    {
+        _workers.push_back(std::make_unique<Worker>());
+        _workers.back()->id = uint32(i);
+    }
 
-    //continents threads are spawned later when request are received
+    //start threads only once all workers exist, since they may steal from each other right away
+    for (auto& worker : _workers)
+        worker->thread = std::thread(&MapUpdater::WorkerThread, this, worker.get());
 }
 
 void MapUpdater::deactivate()
 {
     _cancelationToken = true;
 
-    _loop_queue.Cancel();
-    _once_queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_workLock);
+        _workCondition.notify_all();
+    }
 
     waitUpdateOnces();
     waitUpdateLoops();
 
-    for (auto& thread : _once_maps_workerThreads)
-        thread.join();
-
-    _once_maps_workerThreads.clear();
+    for (auto& worker : _workers)
+        worker->thread.join();
 
-    for (auto& thread : _loop_maps_workerThreads)
-        thread.join();
-
-    _loop_maps_workerThreads.clear();
+    _workers.clear();
 }
 
 void MapUpdater::waitUpdateOnces()
@@ -89,6 +107,13 @@ void MapUpdater::waitUpdateOnces()
 void MapUpdater::enableUpdateLoop(bool enable)
 {
     _enable_updates_loop = enable;
+
+    //wake up workers holding deferred loop requests, so that they can release them
+    if (!enable)
+    {
+        std::lock_guard<std::mutex> lock(_workLock);
+        _workCondition.notify_all();
+    }
 }
 
 void MapUpdater::waitUpdateLoops()
@@ -101,87 +126,206 @@ void MapUpdater::waitUpdateLoops()
     lock.unlock();
 }
 
-void MapUpdater::spawnMissingOnceUpdateThreads()
-{
-    for (uint32 i = _once_maps_workerThreads.size(); i < pending_once_maps; i++)
-        _once_maps_workerThreads.push_back(std::thread(&MapUpdater::OnceWorkerThread, this));
-}
-
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
-    MapUpdateRequest* request = new MapUpdateRequest(map, *this, diff);
     // MapInstanced re schedule the instances it contains by itself, so we want to call it only once
     // Also currently test maps needs to be updated once per world update
-    if((map.Instanceable() && map.GetMapType() != MAP_TYPE_MAP_INSTANCED) || map.GetMapType() == MAP_TYPE_TEST_MAP) 
-    { 
+    bool const loop = (map.Instanceable() && map.GetMapType() != MAP_TYPE_MAP_INSTANCED) || map.GetMapType() == MAP_TYPE_TEST_MAP;
+    MapUpdateRequest* request = new MapUpdateRequest(map, *this, diff, loop);
+    if (loop)
         pending_loop_maps++;
-        _loop_queue.Push(request);
-    } 
-    else 
-    {
+    else
         pending_once_maps++;
-        _once_queue.Push(request);
-    }
 
-    spawnMissingOnceUpdateThreads();
+    //keep requests scheduled from a worker on this worker, others will steal them if idle
+    uint32 workerId = t_currentWorkerId >= 0 ? uint32(t_currentWorkerId) : (_nextWorker++ % _workers.size());
+    pushRequest(*_workers[workerId], request, map.HavePlayers());
 }
 
 bool MapUpdater::activated()
 {
-    return _loop_maps_workerThreads.size() > 0;
+    return _workers.size() > 0;
 }
 
-void MapUpdater::LoopWorkerThread(std::atomic<bool>* enable_instance_updates_loop)
+std::vector<MapUpdaterWorkerStats> MapUpdater::GetWorkersStats() const
 {
-    while (1)
+    std::vector<MapUpdaterWorkerStats> stats;
+    stats.reserve(_workers.size());
+    for (auto const& worker : _workers)
     {
-        MapUpdateRequest* request = nullptr;
-
-        _loop_queue.WaitAndPop(request);
-
-        if (_cancelationToken) 
+        MapUpdaterWorkerStats workerStats;
+        workerStats.workerId = worker->id;
+        workerStats.busyTime = worker->busyTime;
+        workerStats.updateCount = worker->updateCount;
+        workerStats.stealCount = worker->stealCount;
         {
-            if(request)
-                loopMapFinished();
-            return;
+            std::lock_guard<std::mutex> lock(worker->queueLock);
+            workerStats.queueSize = uint32(worker->queue.size());
         }
+        stats.push_back(workerStats);
+    }
+    return stats;
+}
+
+void MapUpdater::pushRequest(Worker& worker, MapUpdateRequest* request, bool priority)
+{
+    {
+        std::lock_guard<std::mutex> lock(worker.queueLock);
+        if (priority)
+            worker.queue.push_front(request);
+        else
+            worker.queue.push_back(request);
+        _queuedRequests++;
+    }
 
-        ASSERT(request);
-        request->call();
+    //lock to make sure a worker is not between its check and its wait
+    std::lock_guard<std::mutex> lock(_workLock);
+    _workCondition.notify_one();
+}
 
-        //repush at end of queue, or delete if loop has been disabled by MapManager
-        if(!(*enable_instance_updates_loop))
+MapUpdateRequest* MapUpdater::popOrSteal(Worker& worker)
+{
+    {
+        std::lock_guard<std::mutex> lock(worker.queueLock);
+        if (!worker.queue.empty())
         {
-            delete request;
-            loopMapFinished();
-        } else {
-            _loop_queue.Push(request);
+            MapUpdateRequest* request = worker.queue.front();
+            worker.queue.pop_front();
+            _queuedRequests--;
+            return request;
         }
     }
+
+    if (!_queuedRequests)
+        return nullptr;
+
+    for (size_t i = 1; i < _workers.size(); ++i)
+    {
+        Worker& victim = *_workers[(worker.id + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(victim.queueLock);
+        if (victim.queue.empty())
+            continue;
+
+        MapUpdateRequest* request = victim.queue.back();
+        victim.queue.pop_back();
+        _queuedRequests--;
+        worker.stealCount++;
+        return request;
+    }
+
+    return nullptr;
 }
 
-void MapUpdater::OnceWorkerThread()
+void MapUpdater::processRequest(Worker& worker, MapUpdateRequest* request)
 {
-    while (1)
+    uint32 const startTime = GetMSTime();
+    request->call();
+    worker.busyTime += GetMSTimeDiffToNow(startTime);
+    worker.updateCount++;
+
+    //repush at end of queue, or delete if loop has been disabled by MapManager
+    if (request->IsLoop() && _enable_updates_loop)
+        pushRequest(worker, request, false);
+    else
+        finishRequest(request);
+}
+
+void MapUpdater::finishRequest(MapUpdateRequest* request)
+{
+    bool const loop = request->IsLoop();
+    delete request;
+    if (loop)
+        loopMapFinished();
+    else
+        onceMapFinished();
+}
+
+void MapUpdater::waitForWork(uint32 timeout, bool hasDeferred)
+{
+    std::unique_lock<std::mutex> lock(_workLock);
+    auto workAvailable = [&]()
     {
-        MapUpdateRequest* request = nullptr;
+        return _queuedRequests > 0 || _cancelationToken || (hasDeferred && !_enable_updates_loop);
+    };
 
-        _once_queue.WaitAndPop(request);
+    if (timeout)
+        _workCondition.wait_for(lock, std::chrono::milliseconds(timeout), workAvailable);
+    else
+        _workCondition.wait(lock, workAvailable);
+}
+
+void MapUpdater::WorkerThread(Worker* worker)
+{
+    t_currentWorkerId = int32(worker->id);
+
+    //loop requests updated less than MINIMUM_MAP_UPDATE_INTERVAL ago, we keep them aside instead of sleeping on them
+    std::vector<MapUpdateRequest*> deferred;
 
-        if (_cancelationToken) 
+    while (1)
+    {
+        if (MapUpdateRequest* request = popOrSteal(*worker))
         {
-            if(request)
-                onceMapFinished();
+            if (_cancelationToken)
+            {
+                finishRequest(request);
+                continue;
+            }
+
+            //instances are only updated again while continents are still updating
+            if (request->IsLoop() && request->HasUpdated())
+            {
+                if (!_enable_updates_loop)
+                {
+                    finishRequest(request);
+                    continue;
+                }
+
+                if (request->GetTimeUntilDue())
+                {
+                    deferred.push_back(request);
+                    continue;
+                }
+            }
+
+            processRequest(*worker, request);
+            continue;
+        }
+
+        //all queues are empty at this point
+        if (_cancelationToken)
+        {
+            for (MapUpdateRequest* request : deferred)
+                finishRequest(request);
             return;
         }
 
-        ASSERT(request);
-        request->call();
+        if (deferred.empty())
+        {
+            waitForWork(0, false);
+            continue;
+        }
 
-        delete request;
-        onceMapFinished();
+        //requeue deferred requests that are due (or to be released if loop got disabled), else wait for the first one to be
+        uint32 minWait = MINIMUM_MAP_UPDATE_INTERVAL;
+        bool requeued = false;
+        for (auto itr = deferred.begin(); itr != deferred.end();)
+        {
+            uint32 const wait = (*itr)->GetTimeUntilDue();
+            if (!wait || !_enable_updates_loop)
+            {
+                pushRequest(*worker, *itr, false);
+                itr = deferred.erase(itr);
+                requeued = true;
+            }
+            else
+            {
+                minWait = std::min(minWait, wait);
+                ++itr;
+            }
+        }
+
+        if (!requeued)
+            waitForWork(minWait, true);
     }
 }
 
@@ -6,25 +6,42 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <deque>
+#include <memory>
+#include <vector>
+#include <atomic>
 
 class MapUpdateRequest;
 class Map;
 
+struct MapUpdaterWorkerStats
+{
+    uint32 workerId     = 0;
+    uint64 busyTime     = 0; //ms spent updating maps since activation
+    uint64 updateCount  = 0; //maps updated since activation
+    uint64 stealCount   = 0; //requests taken from other workers queues since activation
+    uint32 queueSize    = 0; //requests currently waiting in this worker queue
+};
+
 /**
 Two kinds of maps:
 - Maps we update only once (continents, instances base maps)
 - Maps we keep updating until the first type has finished (instances, battlegrounds)
+
+Both kinds are handled by a fixed pool of workers. Each worker owns a request deque, pops from its front and
+steals from the back of the other workers deques when its own is empty. Maps with players are pushed at the
+front of the deque so that they get updated first.
 */
 class MapUpdater
 {
 public:
 
-    MapUpdater() : _cancelationToken(false), _enable_updates_loop(false), pending_once_maps(0), pending_loop_maps(0) {}
+    MapUpdater() : _cancelationToken(false), _enable_updates_loop(false), pending_once_maps(0), pending_loop_maps(0), _queuedRequests(0), _nextWorker(0) {}
     ~MapUpdater();
 
     friend class MapUpdateRequest;
 
+    // Can be called from the world thread or from a worker thread (MapInstanced schedule its instances while being updated)
     void schedule_update(Map& map, uint32 diff);
 
     void waitUpdateOnces();
@@ -37,19 +54,39 @@ public:
     void deactivate();
 
     bool activated();
+
+    std::vector<MapUpdaterWorkerStats> GetWorkersStats() const;
 private:
+    struct Worker
+    {
+        uint32 id = 0;
+        std::thread thread;
+
+        std::mutex queueLock;
+        std::deque<MapUpdateRequest*> queue;
+
+        std::atomic<uint64> busyTime { 0 };
+        std::atomic<uint64> updateCount { 0 };
+        std::atomic<uint64> stealCount { 0 };
+    };
 
     void onceMapFinished();
     void loopMapFinished();
 
-	//this will ensure once_map_workerThreads match the pending_once_maps count
-	void spawnMissingOnceUpdateThreads();
+    // Push request in given worker queue and wake up a sleeping worker
+    void pushRequest(Worker& worker, MapUpdateRequest* request, bool priority);
+    // Pop from our own queue front, or steal from another worker queue back. Return nullptr if all queues are empty.
+    MapUpdateRequest* popOrSteal(Worker& worker);
+    // Update map and either requeue or delete the request
+    void processRequest(Worker& worker, MapUpdateRequest* request);
+    // Delete request and decrease the matching pending counter
+    void finishRequest(MapUpdateRequest* request);
+    // Sleep until any work is queued, cancelation is requested or timeout is elapsed (0 for no timeout)
+    void waitForWork(uint32 timeout, bool hasDeferred);
 
-    ProducerConsumerQueue<MapUpdateRequest*> _loop_queue;
-	ProducerConsumerQueue<MapUpdateRequest*> _once_queue;
+    void WorkerThread(Worker* worker);
 
-    std::vector<std::thread> _loop_maps_workerThreads; 
-    std::vector<std::thread> _once_maps_workerThreads; //created/deleted at each loop, one for each continent
+    std::vector<std::unique_ptr<Worker>> _workers;
     std::atomic<bool> _cancelationToken;
     std::atomic<bool> _enable_updates_loop;
 
@@ -61,12 +98,13 @@ private:
     std::atomic<uint32> pending_once_maps;
     std::atomic<uint32> pending_loop_maps;
 
-    /* Loop workers keep running and processing _loop_queue, updating maps and requeuing them afterwards.
-    When onceMapsFinished becomes true, the worker finish the current request and delete the request instead of requeuing it.
-    */
-    void LoopWorkerThread(std::atomic<bool>* onceMapsFinished);
-    //Single update, descrease pending_once_maps when done
-	void OnceWorkerThread();
+    //idle workers wait on this
+    std::mutex _workLock;
+    std::condition_variable _workCondition;
+    //requests currently waiting in any worker queue
+    std::atomic<uint32> _queuedRequests;
+    //round robin index for requests scheduled from outside the workers
+    std::atomic<uint32> _nextWorker;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -8,9 +8,21 @@
 
 Monitor::Monitor()
     : _worldTickCount(0),
-    _generalInfoTimer(0)
+    _currentWorldTickStart(0),
+    _generalInfoTimer(0),
+    _compressedPackets(0),
+    _compressionBytesIn(0),
+    _compressionBytesOut(0),
+    _compressionTime(0),
+    _socketBytesCopied(0),
+    _socketBytesShared(0),
+    _lineOfSightCacheHits(0),
+    _lineOfSightCacheMisses(0),
+    _spellModCacheHits(0),
+    _spellModCacheMisses(0)
 {
-    _worldTicksInfo.reserve(DAY * 20); //already prepare 1 day worth of 20 updates per seconds
+    for (auto& count : _gridPreloadResults)
+        count = 0;
 }
 
 void Monitor::Update(uint32 diff)
@@ -21,6 +33,89 @@ void Monitor::Update(uint32 diff)
     UpdateGeneralInfosIfExpired(diff);
 
     smoothTD.Update(diff);
+
+    _monitMapWorkers.Update(diff);
+}
+
+void Monitor::UpdatePacketCompressed(uint32 bytesIn, uint32 bytesOut, uint32 timeUs)
+{
+    _compressedPackets++;
+    _compressionBytesIn += bytesIn;
+    _compressionBytesOut += bytesOut;
+    _compressionTime += timeUs;
+}
+
+UpdateCompressionStats Monitor::GetUpdateCompressionStats() const
+{
+    UpdateCompressionStats stats;
+    stats.packets = _compressedPackets;
+    stats.bytesIn = _compressionBytesIn;
+    stats.bytesOut = _compressionBytesOut;
+    stats.time = _compressionTime;
+    return stats;
+}
+
+void Monitor::SocketPacketsQueued(uint64 bytesCopied, uint64 bytesShared)
+{
+    _socketBytesCopied += bytesCopied;
+    _socketBytesShared += bytesShared;
+}
+
+SocketWriteStats Monitor::GetSocketWriteStats() const
+{
+    SocketWriteStats stats;
+    stats.bytesCopied = _socketBytesCopied;
+    stats.bytesShared = _socketBytesShared;
+    stats.lastTickBytesCopied = _socketWriteLastTick.lastTickBytesCopied;
+    stats.lastTickBytesShared = _socketWriteLastTick.lastTickBytesShared;
+    return stats;
+}
+
+void Monitor::LineOfSightCacheQueried(uint32 hits, uint32 misses)
+{
+    _lineOfSightCacheHits += hits;
+    _lineOfSightCacheMisses += misses;
+}
+
+LineOfSightCacheStats Monitor::GetLineOfSightCacheStats() const
+{
+    LineOfSightCacheStats stats;
+    stats.hits = _lineOfSightCacheHits;
+    stats.misses = _lineOfSightCacheMisses;
+    stats.lastTickHits = _lineOfSightCacheLastTick.lastTickHits;
+    stats.lastTickMisses = _lineOfSightCacheLastTick.lastTickMisses;
+    return stats;
+}
+
+void Monitor::SpellModCacheQueried(uint32 hits, uint32 misses)
+{
+    _spellModCacheHits += hits;
+    _spellModCacheMisses += misses;
+}
+
+SpellModCacheStats Monitor::GetSpellModCacheStats() const
+{
+    SpellModCacheStats stats;
+    stats.hits = _spellModCacheHits;
+    stats.misses = _spellModCacheMisses;
+    stats.lastTickHits = _spellModCacheLastTick.lastTickHits;
+    stats.lastTickMisses = _spellModCacheLastTick.lastTickMisses;
+    return stats;
+}
+
+void Monitor::GridPreloaded(GridPreloadResult result)
+{
+    _gridPreloadResults[result]++;
+}
+
+GridPreloadStats Monitor::GetGridPreloadStats() const
+{
+    GridPreloadStats stats;
+    stats.hits = _gridPreloadResults[GRID_PRELOAD_HIT];
+    stats.late = _gridPreloadResults[GRID_PRELOAD_LATE];
+    stats.misses = _gridPreloadResults[GRID_PRELOAD_MISS];
+    stats.expired = _gridPreloadResults[GRID_PRELOAD_EXPIRED];
+    return stats;
 }
 
 void SmoothedTimeDiff::Update(uint32 diff)
@@ -52,19 +147,26 @@ void Monitor::MapUpdateStart(Map const& map)
     if (map.GetMapType() == MAP_TYPE_MAP_INSTANCED)
         return; //ignore these, not true maps
 
-    //this function can be called from several maps at the same time
-    std::lock_guard<std::mutex> lock(_currentWorldTickLock);
-    #ifdef TRINITY_DEBUG
-        auto itr = _currentlyUpdating.find(std::make_pair(map.GetId(), map.GetInstanceId()));
-        ASSERT(itr == _currentlyUpdating.end());
-        _currentlyUpdating[std::make_pair(map.GetId(), map.GetInstanceId())] = true;
-    #endif
-    InstanceTicksInfo& updateInfoListForMap = _currentWorldTickInfo.updateInfos[map.GetId()];
-    MapTicksInfo& mapsTicksInfo = updateInfoListForMap[map.GetInstanceId()];
-    mapsTicksInfo.currentTick++;
-    auto& mapTick = mapsTicksInfo.ticks[mapsTicksInfo.currentTick];
-    ASSERT(mapTick.endTime == 0);
-    mapTick.startTime = GetMSTime();
+    std::shared_ptr<MapTicksInfo> ticksInfo;
+    {
+        //this function can be called from several maps at the same time
+        std::lock_guard<std::mutex> lock(_mapTicksLock);
+        #ifdef TRINITY_DEBUG
+            auto itr = _currentlyUpdating.find(std::make_pair(map.GetId(), map.GetInstanceId()));
+            ASSERT(itr == _currentlyUpdating.end());
+            _currentlyUpdating[std::make_pair(map.GetId(), map.GetInstanceId())] = true;
+        #endif
+        std::shared_ptr<MapTicksInfo>& mapTicks = _mapTicks[uint64(&map)];
+        if (!mapTicks)
+        {
+            uint32 const capacity = std::max(sWorld->getConfig(CONFIG_MONITORING_TICK_HISTORY_SIZE), sWorld->getConfig(CONFIG_MONITORING_DYNAMIC_VIEWDIST_AVERAGE_COUNT));
+            mapTicks = std::make_shared<MapTicksInfo>(map.GetId(), map.GetInstanceId(), capacity);
+        }
+        ticksInfo = mapTicks;
+    }
+
+    ASSERT(ticksInfo->startTime == 0);
+    ticksInfo->startTime = GetMSTime();
 }
 
 void Monitor::MapUpdateEnd(Map& map)
@@ -75,27 +177,40 @@ void Monitor::MapUpdateEnd(Map& map)
     if (map.GetMapType() == MAP_TYPE_MAP_INSTANCED)
         return; //ignore these, not true maps
 
-    //this function can be called from several maps at the same time
-    _currentWorldTickLock.lock();
     #ifdef TRINITY_DEBUG
+    {
+        std::lock_guard<std::mutex> lock(_mapTicksLock);
         auto itr = _currentlyUpdating.find(std::make_pair(map.GetId(), map.GetInstanceId()));
         if(itr != _currentlyUpdating.end())
             _currentlyUpdating.erase(itr);
+    }
     #endif
-    MapTicksInfo& mapsTicksInfo = _currentWorldTickInfo.updateInfos[map.GetId()][map.GetInstanceId()];
-    auto& mapTick = mapsTicksInfo.ticks[mapsTicksInfo.currentTick];
-    if (mapTick.startTime == 0)
+
+    std::shared_ptr<MapTicksInfo> ticksInfo = GetMapTicksInfo(map);
+    if (!ticksInfo || ticksInfo->startTime == 0)
         return; //shouldn't happen unless we changed CONFIG_MONITORING_ENABLED while running
 
-    mapTick.endTime = GetMSTime();
-    uint32 diff = mapTick.endTime - mapTick.startTime;
-    _currentWorldTickLock.unlock();
+    uint32 diff = GetMSTimeDiffToNow(ticksInfo->startTime);
+    ticksInfo->startTime = 0;
+    ticksInfo->history.Add(diff);
 
     _monitDynamicLoS.UpdateForMap(map, diff);
+}
+
+void Monitor::MapRemoved(Map const& map)
+{
+    std::lock_guard<std::mutex> lock(_mapTicksLock);
+    _mapTicks.erase(uint64(&map));
+}
+
+std::shared_ptr<MapTicksInfo> Monitor::GetMapTicksInfo(Map const& map)
+{
+    std::lock_guard<std::mutex> lock(_mapTicksLock);
+    auto itr = _mapTicks.find(uint64(&map));
+    if (itr == _mapTicks.end())
+        return nullptr;
 
-    _lastMapDiffsLock.lock();
-    _lastMapDiffs[uint64(&map)] = diff;
-    _lastMapDiffsLock.unlock();
+    return itr->second;
 }
 
 void Monitor::StartedWorldLoop()
@@ -104,8 +219,7 @@ void Monitor::StartedWorldLoop()
         return;
 
     _worldTickCount++;
-    _currentWorldTickInfo.worldTick = _worldTickCount;
-    _currentWorldTickInfo.startTime = GetMSTime();
+    _currentWorldTickStart = GetMSTime();
 }
 
 void Monitor::FinishedWorldLoop()
@@ -113,20 +227,46 @@ void Monitor::FinishedWorldLoop()
     if (!sWorld->getConfig(CONFIG_MONITORING_ENABLED))
         return;
 
-    if (_currentWorldTickInfo.startTime == 0)
+    if (_currentWorldTickStart == 0)
         return; //shouldn't happen unless we changed CONFIG_MONITORING_ENABLED while running
 
-    _currentWorldTickInfo.endTime = GetMSTime();
-    _currentWorldTickInfo.diff = _currentWorldTickInfo.endTime - _currentWorldTickInfo.startTime;
-    _currentWorldTickInfo.worldTick = _worldTickCount;
-
-    _monitAutoReboot.Update(_currentWorldTickInfo.diff);
-    _monitAlert.UpdateForWorld(_currentWorldTickInfo.diff);
-
+    uint32 const diff = GetMSTimeDiffToNow(_currentWorldTickStart);
+    _currentWorldTickStart = 0;
+
+    _monitAutoReboot.Update(diff);
+    _monitAlert.UpdateForWorld(diff);
+
+    uint64 const bytesCopied = _socketBytesCopied;
+    uint64 const bytesShared = _socketBytesShared;
+    _socketWriteLastTick.lastTickBytesCopied = bytesCopied - _socketWriteLastTick.bytesCopied;
+    _socketWriteLastTick.lastTickBytesShared = bytesShared - _socketWriteLastTick.bytesShared;
+    _socketWriteLastTick.bytesCopied = bytesCopied;
+    _socketWriteLastTick.bytesShared = bytesShared;
+
+    uint64 const losHits = _lineOfSightCacheHits;
+    uint64 const losMisses = _lineOfSightCacheMisses;
+    _lineOfSightCacheLastTick.lastTickHits = losHits - _lineOfSightCacheLastTick.hits;
+    _lineOfSightCacheLastTick.lastTickMisses = losMisses - _lineOfSightCacheLastTick.misses;
+    _lineOfSightCacheLastTick.hits = losHits;
+    _lineOfSightCacheLastTick.misses = losMisses;
+
+    uint64 const spellModHits = _spellModCacheHits;
+    uint64 const spellModMisses = _spellModCacheMisses;
+    _spellModCacheLastTick.lastTickHits = spellModHits - _spellModCacheLastTick.hits;
+    _spellModCacheLastTick.lastTickMisses = spellModMisses - _spellModCacheLastTick.misses;
+    _spellModCacheLastTick.hits = spellModHits;
+    _spellModCacheLastTick.misses = spellModMisses;
+
+    if (!_worldTicks)
+    {
+        // make sure we can hold enough loops for the averages checks
+        uint32 capacity = sWorld->getConfig(CONFIG_MONITORING_TICK_HISTORY_SIZE);
+        capacity = std::max(capacity, sWorld->getConfig(CONFIG_MONITORING_LAG_AUTO_REBOOT_COUNT));
+        capacity = std::max(capacity, sWorld->getConfig(CONFIG_MONITORING_ALERT_THRESHOLD_COUNT));
+        _worldTicks = std::make_unique<MonitorTickHistory>(capacity);
+    }
 
-    //Store current world tick and reset it
-    _worldTicksInfo.push_back(std::move(_currentWorldTickInfo));
-    _currentWorldTickInfo = {};
+    _worldTicks->Add(diff);
 }
 
 void Monitor::UpdateGeneralInfosIfExpired(uint32 diff)
@@ -226,61 +366,86 @@ void Monitor::UpdateGeneralInfos(uint32 diff)
 
 uint32 Monitor::GetAverageWorldDiff(uint32 searchCount)
 {
-    if (!searchCount)
+    if (!searchCount || !_worldTicks)
         return 0;
 
-    std::lock_guard<std::mutex> lock(_worldTicksInfoLock);
-
-    if (_worldTicksInfo.size() < searchCount)
-        return 0; //not enough data yet
+    return _worldTicks->GetAverage(searchCount);
+}
 
-    uint32 sum = 0;
-    for (uint32 i = _worldTicksInfo.size() - searchCount; i != _worldTicksInfo.size(); i++)
-        sum += _worldTicksInfo[i].diff;
+uint32 Monitor::GetAverageDiffForMap(Map const& map, uint32 searchCount)
+{
+    if (!searchCount)
+        return 0;
 
-    uint32 avgTD = uint32(sum / float(searchCount));
+    std::shared_ptr<MapTicksInfo> ticksInfo = GetMapTicksInfo(map);
+    if (!ticksInfo)
+        return 0;
 
-    return avgTD;
+    return ticksInfo->history.GetAverage(searchCount);
 }
 
-uint32 Monitor::GetAverageDiffForMap(Map const& map, uint32 searchCount)
+uint32 Monitor::GetLastDiffForMap(Map const& map)
 {
-    if (!searchCount)
+    std::shared_ptr<MapTicksInfo> ticksInfo = GetMapTicksInfo(map);
+    if (!ticksInfo)
         return 0;
 
-    std::lock_guard<std::mutex> lock(_worldTicksInfoLock);
+    return ticksInfo->history.GetLast();
+}
 
-    if (_worldTicksInfo.size() < searchCount)
-        return 0; //not enough data yet
+TickPercentiles Monitor::GetPercentiles(MonitorTickHistory const& history)
+{
+    TickPercentiles percentiles;
+    percentiles.count = history.GetCount();
+    percentiles.p50 = history.GetPercentile(50.0f);
+    percentiles.p95 = history.GetPercentile(95.0f);
+    percentiles.p99 = history.GetPercentile(99.0f);
+    percentiles.max = history.GetMax();
+    return percentiles;
+}
 
-    uint32 sum = 0;
-    uint32 count = 0;
-    for (uint32 i = _worldTicksInfo.size() - searchCount; i != _worldTicksInfo.size(); i++)
-    {
-        auto ticks = _worldTicksInfo[i].updateInfos[map.GetId()][map.GetInstanceId()].ticks;
-        for (auto itr : ticks)
-        {
-            sum += itr.second.diff();
-            count++;
-        }
-    }
+TickPercentiles Monitor::GetWorldDiffPercentiles()
+{
+    if (!_worldTicks)
+        return {};
 
-    if (!count)
-        return 0;
+    return GetPercentiles(*_worldTicks);
+}
 
-    uint32 avg = uint32(sum / float(count));
+TickPercentiles Monitor::GetMapDiffPercentiles(Map const& map)
+{
+    std::shared_ptr<MapTicksInfo> ticksInfo = GetMapTicksInfo(map);
+    if (!ticksInfo)
+        return {};
 
-    return avg;
+    return GetPercentiles(ticksInfo->history);
 }
 
-uint32 Monitor::GetLastDiffForMap(Map const& map)
+std::string Monitor::DumpTickPercentiles()
 {
-    std::lock_guard<std::mutex> lock(_lastMapDiffsLock);
-    auto itr = _lastMapDiffs.find(uint64(&map));
-    if (itr == _lastMapDiffs.end())
-        return 0;
+    auto toJson = [](TickPercentiles const& percentiles)
+    {
+        return Trinity::StringFormat("\"count\":%u,\"p50\":%u,\"p95\":%u,\"p99\":%u,\"max\":%u", percentiles.count, percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+    };
 
-    return itr->second;
+    std::vector<std::shared_ptr<MapTicksInfo>> mapTicks;
+    {
+        std::lock_guard<std::mutex> lock(_mapTicksLock);
+        mapTicks.reserve(_mapTicks.size());
+        for (auto const& itr : _mapTicks)
+            mapTicks.push_back(itr.second);
+    }
+
+    std::ostringstream ss;
+    ss << "{\"tick\":" << _worldTickCount << ",\"world\":{" << toJson(GetWorldDiffPercentiles()) << "},\"maps\":[";
+    for (size_t i = 0; i < mapTicks.size(); ++i)
+    {
+        if (i)
+            ss << ",";
+        ss << "{\"map\":" << mapTicks[i]->mapId << ",\"instance\":" << mapTicks[i]->instanceId << "," << toJson(GetPercentiles(mapTicks[i]->history)) << "}";
+    }
+    ss << "]}";
+    return ss.str();
 }
 
 void MonitorAutoReboot::Update(uint32 diff)
@@ -386,3 +551,48 @@ void MonitorAlert::UpdateForWorld(uint32 diff)
     std::string msg = "/!\\ World updates have been slow for the last " + std::to_string(searchCount) + " updates with an average of " + std::to_string(avgTD);
     ChatHandler::SendGlobalGMSysMessage(msg.c_str());
 }
+
+void MonitorMapWorkersUsage::Update(uint32 diff)
+{
+    checkTimer += diff;
+    if (checkTimer < CHECK_INTERVAL)
+        return;
+
+    checkTimer = 0;
+
+    uint32 const now = GetMSTime();
+    uint32 const elapsed = GetMSTimeDiff(lastCheckTime, now);
+    lastCheckTime = now;
+
+    std::vector<MapUpdaterWorkerStats> stats = sMapMgr->GetMapUpdater()->GetWorkersStats();
+    std::vector<MapWorkerUsage> usage;
+    usage.reserve(stats.size());
+    //compare with last check, we may not have any (first check or worker count changed)
+    bool const hasLastStats = _lastStats.size() == stats.size();
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        MapUpdaterWorkerStats const& current = stats[i];
+        MapUpdaterWorkerStats const last = hasLastStats ? _lastStats[i] : MapUpdaterWorkerStats();
+
+        MapWorkerUsage workerUsage;
+        workerUsage.workerId = current.workerId;
+        workerUsage.busyPct = elapsed ? std::min<uint32>(100, uint32((current.busyTime - last.busyTime) * 100 / elapsed)) : 0;
+        workerUsage.updates = uint32(current.updateCount - last.updateCount);
+        workerUsage.steals = uint32(current.stealCount - last.stealCount);
+        workerUsage.queueSize = current.queueSize;
+        usage.push_back(workerUsage);
+    }
+    _lastStats = std::move(stats);
+
+    std::lock_guard<std::mutex> lock(_usageLock);
+    if (hasLastStats)
+        _usage = std::move(usage);
+    else
+        _usage.clear();
+}
+
+std::vector<MapWorkerUsage> MonitorMapWorkersUsage::Get()
+{
+    std::lock_guard<std::mutex> lock(_usageLock);
+    return _usage;
+}
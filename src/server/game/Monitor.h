@@ -2,6 +2,8 @@
 #define __MONITOR_H
 
 #include "Common.h"
+#include "MapUpdater.h"
+#include "MonitorTickHistory.h"
 #include <unordered_map>
 #include <mutex>
 
@@ -16,30 +18,23 @@ Ideas:
 
 typedef uint64 WorldTick;
 
-struct MapTickInfo
-{
-	uint32 startTime = 0;
-	uint32 endTime = 0;
-
-	uint32 diff() { return endTime - startTime; }
-};
-
 struct MapTicksInfo
 {
-	std::unordered_map<uint32 /*tick*/, MapTickInfo> ticks;
-	uint32 currentTick = 0;
-};
+	MapTicksInfo(uint32 _mapId, uint32 _instanceId, uint32 capacity) : mapId(_mapId), instanceId(_instanceId), history(capacity) { }
 
-typedef std::unordered_map<uint32 /*instanceId*/, MapTicksInfo> InstanceTicksInfo;
-typedef std::unordered_map<uint32 /*mapId*/, InstanceTicksInfo> MapUpdateInfos;
+	uint32 const mapId;
+	uint32 const instanceId;
+	uint32 startTime = 0; //start of the update currently running, 0 if none
+	MonitorTickHistory history;
+};
 
-struct WorldTickInfo
+struct TickPercentiles
 {
-	WorldTick worldTick   = 0;
-	MapUpdateInfos updateInfos;
-	uint32 startTime      = 0;
-	uint32 endTime        = 0;
-	uint32 diff           = 0; //value calculated from startTime and endTime
+	uint32 count = 0;
+	uint32 p50   = 0;
+	uint32 p95   = 0;
+	uint32 p99   = 0;
+	uint32 max   = 0;
 };
 
 class MonitorAutoReboot
@@ -80,6 +75,81 @@ private:
 	CheckTimer _worldCheckTimer;
 };
 
+struct MapWorkerUsage
+{
+	uint32 workerId  = 0;
+	uint32 busyPct   = 0; //percentage of time spent updating maps
+	uint32 updates   = 0;
+	uint32 steals    = 0;
+	uint32 queueSize = 0;
+};
+
+//Map updater workers usage over the last check interval
+class MonitorMapWorkersUsage
+{
+public:
+	const uint32 CHECK_INTERVAL = 10 * IN_MILLISECONDS;
+
+	void Update(uint32 diff);
+	std::vector<MapWorkerUsage> Get();
+
+private:
+	uint32 checkTimer = 0;
+	uint32 lastCheckTime = 0;
+	std::vector<MapUpdaterWorkerStats> _lastStats;
+
+	std::mutex _usageLock;
+	std::vector<MapWorkerUsage> _usage;
+};
+
+struct UpdateCompressionStats
+{
+	uint64 packets  = 0;
+	uint64 bytesIn  = 0;
+	uint64 bytesOut = 0;
+	uint64 time     = 0; //microseconds spent compressing
+};
+
+struct SocketWriteStats
+{
+	uint64 bytesCopied         = 0; //packet payload bytes copied for a single socket
+	uint64 bytesShared         = 0; //packet payload bytes referenced by sockets without copy
+	uint64 lastTickBytesCopied = 0;
+	uint64 lastTickBytesShared = 0;
+};
+
+struct LineOfSightCacheStats
+{
+	uint64 hits             = 0;
+	uint64 misses           = 0;
+	uint64 lastTickHits     = 0;
+	uint64 lastTickMisses   = 0;
+};
+
+struct SpellModCacheStats
+{
+	uint64 hits             = 0;
+	uint64 misses           = 0;
+	uint64 lastTickHits     = 0;
+	uint64 lastTickMisses   = 0;
+};
+
+enum GridPreloadResult
+{
+	GRID_PRELOAD_HIT,     // grid files were ready when grid was loaded
+	GRID_PRELOAD_LATE,    // grid files were being read when grid was loaded, map waited for them
+	GRID_PRELOAD_MISS,    // grid was loaded without having been predicted
+	GRID_PRELOAD_EXPIRED, // grid files were read but the grid was never loaded
+};
+
+struct GridPreloadStats
+{
+	uint64 hits    = 0;
+	uint64 late    = 0;
+	uint64 misses  = 0;
+	uint64 expired = 0;
+};
+
 //Smoothed value of lasts update times, updated every 5 minutes
 struct SmoothedTimeDiff
 {
@@ -99,6 +169,7 @@ class TC_GAME_API Monitor
 	friend class MapUpdater;
 	friend class World;
 	friend class MapUpdateRequest;
+	friend class Map;
 
 
 public:
@@ -110,18 +181,55 @@ public:
 
 	// Returns average world diff for the last <searchCount> loops. Return 0 if not enough loops available atm.
 	uint32 GetAverageWorldDiff(uint32 searchCount);
-	// Returns average map diff for the last <searchCount> world loops. Return 0 if not enough loops available atm.
+	// Returns average map diff for the last <searchCount> updates of this map. Return 0 if not enough updates available atm.
 	uint32 GetAverageDiffForMap(Map const& map, uint32 searchCount);
 	uint32 GetLastDiffForMap(Map const& map);
 
+	// Percentiles over the last Monitor.TickHistory.Size world loops
+	TickPercentiles GetWorldDiffPercentiles();
+	// Percentiles over the last Monitor.TickHistory.Size updates of this map
+	TickPercentiles GetMapDiffPercentiles(Map const& map);
+	// JSON dump of world and all maps percentiles
+	std::string DumpTickPercentiles();
+
 	// Flattened timediff upated every minute. This is a cached value.
 	uint32 GetSmoothTimeDiff() const { return smoothTD.Get(); }
+
+	// Usage of each map updater worker, refreshed every MonitorMapWorkersUsage::CHECK_INTERVAL. Empty if map updater is not activated.
+	std::vector<MapWorkerUsage> GetMapWorkersUsage() { return _monitMapWorkers.Get(); }
+
+	// Called from any thread each time an update packet is compressed
+	void UpdatePacketCompressed(uint32 bytesIn, uint32 bytesOut, uint32 timeUs);
+	// Totals since server start
+	UpdateCompressionStats GetUpdateCompressionStats() const;
+
+	// Called from network threads each time packets are moved to a socket write queue
+	void SocketPacketsQueued(uint64 bytesCopied, uint64 bytesShared);
+	// Totals since server start, and over the last world loop (only when monitoring is enabled)
+	SocketWriteStats GetSocketWriteStats() const;
+
+	// Called by maps at each update, with their line of sight cache counters since last update
+	void LineOfSightCacheQueried(uint32 hits, uint32 misses);
+	// Totals since server start, and over the last world loop (only when monitoring is enabled)
+	LineOfSightCacheStats GetLineOfSightCacheStats() const;
+
+	// Called by players at each update, with their spell mod cache counters since last update
+	void SpellModCacheQueried(uint32 hits, uint32 misses);
+	// Totals since server start, and over the last world loop (only when monitoring is enabled)
+	SpellModCacheStats GetSpellModCacheStats() const;
+
+	// Called from any thread by the grid preloader
+	void GridPreloaded(GridPreloadResult result);
+	// Totals since server start
+	GridPreloadStats GetGridPreloadStats() const;
 private:
 	// -- MapUpdater & World functions
 	void MapUpdateStart(Map const& map);
 	void MapUpdateEnd(Map& map);
 	void StartedWorldLoop();
 	void FinishedWorldLoop();
+	// Called at map destruction, drop its history
+	void MapRemoved(Map const& map);
 
 	void Update(uint32 diff);
 	// --
@@ -135,17 +243,19 @@ private:
 	WorldTick _worldTickCount;
 
 
-	//info about the current world tick, this get reset at FinishedWorldLoop
-	std::mutex _currentWorldTickLock;
-	WorldTickInfo _currentWorldTickInfo;
+	static TickPercentiles GetPercentiles(MonitorTickHistory const& history);
+	// Get ticks info for given map, nullptr if map was never updated
+	std::shared_ptr<MapTicksInfo> GetMapTicksInfo(Map const& map);
+
+	//start time of the current world tick, 0 if none
+	uint32 _currentWorldTickStart;
 
-	//info for all world loops since Monitor is running
-	std::mutex _worldTicksInfoLock;
-	std::vector<WorldTickInfo> _worldTicksInfo;
+	//diffs of the last world loops, only written by world thread. Created at first world loop end, once config is loaded.
+	std::unique_ptr<MonitorTickHistory> _worldTicks;
 
-	//last map diffs. This is redundant with info in _worldTicksInfo but this allows for greater speed and to avoid locking it.
-	std::unordered_map<uint64 /* map pointer*/, uint32 /* diff*/> _lastMapDiffs;
-	std::mutex _lastMapDiffsLock;
+	//diffs of the last updates for each map. Each history is only written by the thread currently updating this map.
+	std::mutex _mapTicksLock;
+	std::unordered_map<uint64 /* map pointer*/, std::shared_ptr<MapTicksInfo>> _mapTicks;
 
 	//time since last general info check
 	uint32 _generalInfoTimer;
@@ -153,8 +263,31 @@ private:
 	MonitorAutoReboot _monitAutoReboot;
 	MonitorDynamicViewDistance _monitDynamicLoS;
 	MonitorAlert      _monitAlert;
+	MonitorMapWorkersUsage _monitMapWorkers;
 
 	SmoothedTimeDiff smoothTD;
+
+	std::atomic<uint64> _compressedPackets;
+	std::atomic<uint64> _compressionBytesIn;
+	std::atomic<uint64> _compressionBytesOut;
+	std::atomic<uint64> _compressionTime;
+
+	std::atomic<uint64> _socketBytesCopied;
+	std::atomic<uint64> _socketBytesShared;
+	//world thread only
+	SocketWriteStats _socketWriteLastTick;
+
+	std::atomic<uint64> _gridPreloadResults[GRID_PRELOAD_EXPIRED + 1];
+
+	std::atomic<uint64> _lineOfSightCacheHits;
+	std::atomic<uint64> _lineOfSightCacheMisses;
+	//world thread only
+	LineOfSightCacheStats _lineOfSightCacheLastTick;
+
+	std::atomic<uint64> _spellModCacheHits;
+	std::atomic<uint64> _spellModCacheMisses;
+	//world thread only
+	SpellModCacheStats _spellModCacheLastTick;
 };
 
 #define sMonitor Monitor::instance()
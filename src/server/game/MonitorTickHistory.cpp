@@ -0,0 +1,112 @@
+#include "MonitorTickHistory.h"
+#include "Errors.h"
+#include <algorithm>
+#include <cmath>
+
+MonitorTickHistory::MonitorTickHistory(uint32 capacity)
+    : _capacity(std::max(capacity, 1u)),
+    _diffs(new std::atomic<uint32>[_capacity]),
+    _written(0)
+{
+    for (uint32 i = 0; i < _capacity; ++i)
+        _diffs[i] = 0;
+
+    for (auto& count : _histogram)
+        count = 0;
+}
+
+uint32 MonitorTickHistory::GetBucket(uint32 diff)
+{
+    if (diff < LINEAR_BUCKETS)
+        return diff;
+
+    // 32 buckets per power of two starting at 64
+    uint32 highestBit = 31;
+    while (!(diff & (1u << highestBit)))
+        --highestBit;
+
+    uint32 const subBucket = (diff >> (highestBit - 5)) & (SUB_BUCKETS - 1);
+    return LINEAR_BUCKETS + (highestBit - 6) * SUB_BUCKETS + subBucket;
+}
+
+uint32 MonitorTickHistory::GetBucketValue(uint32 bucket)
+{
+    if (bucket < LINEAR_BUCKETS)
+        return bucket;
+
+    uint32 const highestBit = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 6;
+    uint32 const subBucket = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + subBucket) << (highestBit - 5);
+}
+
+void MonitorTickHistory::Add(uint32 diff)
+{
+    uint64 const written = _written.load(std::memory_order_relaxed);
+    std::atomic<uint32>& slot = _diffs[written % _capacity];
+
+    // oldest value is overwritten once full
+    if (written >= _capacity)
+        _histogram[GetBucket(slot.load(std::memory_order_relaxed))].fetch_sub(1, std::memory_order_relaxed);
+
+    slot.store(diff, std::memory_order_relaxed);
+    _histogram[GetBucket(diff)].fetch_add(1, std::memory_order_relaxed);
+    _written.store(written + 1, std::memory_order_release);
+}
+
+uint32 MonitorTickHistory::GetCount() const
+{
+    return uint32(std::min<uint64>(_written.load(std::memory_order_acquire), _capacity));
+}
+
+uint32 MonitorTickHistory::GetLast() const
+{
+    uint64 const written = _written.load(std::memory_order_acquire);
+    if (!written)
+        return 0;
+
+    return _diffs[(written - 1) % _capacity].load(std::memory_order_relaxed);
+}
+
+uint32 MonitorTickHistory::GetAverage(uint32 searchCount) const
+{
+    if (!searchCount || searchCount > _capacity)
+        return 0;
+
+    uint64 const written = _written.load(std::memory_order_acquire);
+    if (written < searchCount)
+        return 0; //not enough data yet
+
+    uint64 sum = 0;
+    for (uint64 i = written - searchCount; i != written; ++i)
+        sum += _diffs[i % _capacity].load(std::memory_order_relaxed);
+
+    return uint32(sum / searchCount);
+}
+
+uint32 MonitorTickHistory::GetPercentile(float pct) const
+{
+    ASSERT(pct >= 0.0f && pct <= 100.0f);
+
+    uint64 total = 0;
+    std::array<uint32, BUCKET_COUNT> counts;
+    for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        counts[i] = _histogram[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (!total)
+        return 0;
+
+    // rank of the wanted value, 1 based
+    uint64 const rank = std::max<uint64>(1, uint64(std::ceil(double(pct) / 100.0 * double(total))));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return GetBucketValue(i);
+    }
+
+    return GetBucketValue(BUCKET_COUNT - 1);
+}
@@ -0,0 +1,47 @@
+#ifndef __MONITOR_TICK_HISTORY_H
+#define __MONITOR_TICK_HISTORY_H
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+/*
+Fixed capacity history of the last update diffs, along with a histogram of its content so that percentiles
+can be queried without going through all the values.
+Only one thread may Add at a time, any thread may read. Readers get values as they were at some point during the read.
+Percentiles are exact for diffs below 64ms, and within 1/32 above that.
+*/
+class TC_GAME_API MonitorTickHistory
+{
+public:
+    explicit MonitorTickHistory(uint32 capacity);
+
+    // Single writer
+    void Add(uint32 diff);
+
+    uint32 GetCapacity() const { return _capacity; }
+    // Number of diffs currently stored, up to capacity
+    uint32 GetCount() const;
+    uint32 GetLast() const;
+    // Average of the <searchCount> last diffs. Return 0 if not enough diffs stored.
+    uint32 GetAverage(uint32 searchCount) const;
+    // pct in range [0, 100], for all stored diffs. Return 0 if empty.
+    uint32 GetPercentile(float pct) const;
+    uint32 GetMax() const { return GetPercentile(100.0f); }
+
+private:
+    static uint32 const LINEAR_BUCKETS = 64;
+    static uint32 const SUB_BUCKETS = 32;
+    static uint32 const BUCKET_COUNT = LINEAR_BUCKETS + (32 - 6) * SUB_BUCKETS;
+
+    static uint32 GetBucket(uint32 diff);
+    static uint32 GetBucketValue(uint32 bucket);
+
+    uint32 const _capacity;
+    std::unique_ptr<std::atomic<uint32>[]> _diffs;
+    std::atomic<uint64> _written;
+    std::array<std::atomic<uint32>, BUCKET_COUNT> _histogram;
+};
+
+#endif // __MONITOR_TICK_HISTORY_H
@@ -23,6 +23,20 @@
 
 namespace Movement{
 
+void MoveSpline::GetPathAhead(int32 time, std::vector<Vector3>& points) const
+{
+    if (!Initialized() || Finalized())
+        return;
+
+    int32 const until = time_passed + time;
+    for (int32 i = point_Idx + 1; i <= spline.last(); ++i)
+    {
+        points.push_back(spline.getPoint(i));
+        if (spline.length(i) >= until)
+            break;
+    }
+}
+
 Location MoveSpline::ComputePosition() const
 {
     ASSERT(Initialized());
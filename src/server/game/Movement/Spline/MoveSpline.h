@@ -110,6 +110,8 @@ namespace Movement
         Vector3 FinalDestination() const { return Initialized() ? spline.getPoint(spline.last()) : Vector3(); }
         Vector3 CurrentDestination() const { return Initialized() ? spline.getPoint(point_Idx + 1) : Vector3(); }
         int32 currentPathIdx() const;
+        // Append path points reached from now to <time> ms ahead, including the first point past this time
+        void GetPathAhead(int32 time, std::vector<Vector3>& points) const;
         FacingInfo const& getFacingInfo() const { return facing; }
 
         bool onTransport;
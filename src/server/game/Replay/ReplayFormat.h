@@ -0,0 +1,37 @@
+#ifndef REPLAY_FORMAT_H
+#define REPLAY_FORMAT_H
+
+#include "Common.h"
+
+/*
+Replay file layout (all values little endian):
+- Header: magic, version, recorder guid low, start map, start x/y/z, begin time (GetMSTime at recording start)
+- Blocks: block header (magic, first/last packet time, packet count, raw size, stored size) followed by <stored size> bytes.
+  Stored data is zlib compressed if stored size differs from raw size. Raw data is a list of packets: time (ms since
+  recording start), opcode, size, content.
+- Index: one entry per block with its time range and file offset, followed by a footer pointing to the index.
+  Index is written when recording stops. If missing (server crashed while recording), it is rebuilt by walking
+  the block headers.
+*/
+
+uint32 const REPLAY_FILE_MAGIC          = 0x50524354; // "TCRP"
+uint32 const REPLAY_BLOCK_MAGIC         = 0x4B4C4254; // "TBLK"
+uint32 const REPLAY_INDEX_MAGIC         = 0x58444954; // "TIDX"
+uint32 const REPLAY_FILE_VERSION        = 2;
+
+size_t const REPLAY_HEADER_SIZE         = 4 + 4 + 4 + 4 + 3 * 4 + 4;
+size_t const REPLAY_BLOCK_HEADER_SIZE   = 6 * 4;
+size_t const REPLAY_FOOTER_SIZE         = 8 + 4;
+
+// A block is written once it reaches this size or once it covers this duration. Duration also is the seek granularity.
+size_t const REPLAY_BLOCK_MAX_SIZE      = 64 * 1024;
+uint32 const REPLAY_BLOCK_MAX_DURATION  = 5 * IN_MILLISECONDS;
+
+struct ReplayBlockInfo
+{
+    uint32 firstTime = 0;
+    uint32 lastTime  = 0;
+    uint64 offset    = 0;
+};
+
+#endif //REPLAY_FORMAT_H
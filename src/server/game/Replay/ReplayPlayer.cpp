@@ -5,6 +5,7 @@
 #include "Position.h"
 #include "Opcodes.h"
 #include "Player.h"
+#include "zlib.h"
 
 ReplayPlayer::~ReplayPlayer()
 {
@@ -18,97 +19,256 @@ void ReplayPlayer::StopRead()
     _pcktReading = nullptr;
 }
 
+void ReplayPlayer::ReportError(char const* error, uint32 opcode, uint32 size, uint32 time)
+{
+    if (_player)
+        ChatHandler(_player).PSendSysMessage("[Replay] %s [opcode %s|size %u|time %u]", error, GetOpcodeNameForLogging(static_cast<OpcodeClient>(opcode)).c_str(), size, time);
+}
+
 bool ReplayPlayer::UpdateReplay()
 {
     if (!_pcktReading)
         return false;
 
+    uint32 now = GetMSTime();
+    uint32 diff = GetMSTimeDiff(_pcktReadLastUpdate, now);
+    _pcktReadLastUpdate = now;
+    _pcktReadTimer += diff * _pcktReadSpeedRate;
+
     while (true)
     {
-        long int pos = ftell(_pcktReading);
-        uint32 nextTime = 0;
-        fscanf(_pcktReading, "%u", &nextTime);
-        if (!nextTime)
+        if (_block.rpos() >= _block.size())
         {
-            StopRead();
-            break;
+            if (_nextBlock >= _index.size())
+            {
+                StopRead();
+                break;
+            }
+            if (!LoadBlock(_nextBlock))
+                return false;
+            continue;
+        }
+
+        if (_block.size() - _block.rpos() < 4 + 2 + 4)
+        {
+            ReportError("Invalid packet (truncated header)");
+            return false;
         }
-        fseek(_pcktReading, pos, SEEK_SET);
-        uint32 now = GetMSTime();
-        uint32 diff = GetMSTimeDiff(_pcktReadLastUpdate, now);
-        _pcktReadLastUpdate = now;
-        _pcktReadTimer += diff * _pcktReadSpeedRate;
+
+        uint32 nextTime = _block.read<uint32>(_block.rpos());
         if (nextTime > _pcktReadTimer) // Stop
             break;
+
         // else, send another packet
+        uint16 opcode = 0;
         uint32 size = 0;
-        uint32 opcode = 0;
-        int32 readValue = 0;
-        if (fscanf(_pcktReading, "%u:%u:%u|%u", &nextTime, &opcode, &size, &readValue) != 4)
+        _block >> nextTime >> opcode >> size;
+        if (_block.size() - _block.rpos() < size)
+        {
+            ReportError("Invalid packet (truncated)", opcode, size, nextTime);
             return false;
-        else
+        }
+
+        WorldPacket data(opcode, size);
+        if (size)
+            data.append(_block.contents() + _block.rpos(), size);
+        _block.read_skip(size);
+        _player->GetSession()->SendPacket(&data);
+    }
+    return true;
+}
+
+bool ReplayPlayer::LoadBlock(size_t blockIndex)
+{
+    _block.clear();
+    _nextBlock = blockIndex + 1;
+
+    ReplayBlockInfo const& info = _index[blockIndex];
+    uint8 headerData[REPLAY_BLOCK_HEADER_SIZE];
+    if (fseek(_pcktReading, long(info.offset), SEEK_SET) != 0 || fread(headerData, REPLAY_BLOCK_HEADER_SIZE, 1, _pcktReading) != 1)
+    {
+        ReportError("Could not read block", 0, 0, info.firstTime);
+        return false;
+    }
+
+    ByteBuffer header;
+    header.append(headerData, REPLAY_BLOCK_HEADER_SIZE);
+    uint32 magic, firstTime, lastTime, packetCount, rawSize, storedSize;
+    header >> magic >> firstTime >> lastTime >> packetCount >> rawSize >> storedSize;
+    if (magic != REPLAY_BLOCK_MAGIC || !rawSize)
+    {
+        ReportError("Invalid block", 0, 0, info.firstTime);
+        return false;
+    }
+
+    std::vector<uint8> stored(storedSize);
+    if (fread(stored.data(), storedSize, 1, _pcktReading) != 1)
+    {
+        ReportError("Invalid block (truncated)", 0, storedSize, info.firstTime);
+        return false;
+    }
+
+    if (storedSize == rawSize)
+    {
+        _block.append(stored.data(), storedSize);
+        return true;
+    }
+
+    _block.resize(rawSize);
+    uLongf destLen = rawSize;
+    if (uncompress(_block.contents(), &destLen, stored.data(), storedSize) != Z_OK || destLen != rawSize)
+    {
+        _block.clear();
+        ReportError("Invalid block (decompression failed)", 0, storedSize, info.firstTime);
+        return false;
+    }
+    return true;
+}
+
+void ReplayPlayer::Seek(uint32 time)
+{
+    // first block still having packets at or after given time
+    auto itr = std::lower_bound(_index.begin(), _index.end(), time, [](ReplayBlockInfo const& block, uint32 time)
+    {
+        return block.lastTime < time;
+    });
+
+    if (itr == _index.end())
+    {
+        // past the end, replay will stop at next update
+        _block.clear();
+        _nextBlock = _index.size();
+        return;
+    }
+
+    if (!LoadBlock(std::distance(_index.begin(), itr)))
+        return;
+
+    // skip packets before time in this block
+    while (_block.size() - _block.rpos() >= 4 + 2 + 4)
+    {
+        if (_block.read<uint32>(_block.rpos()) >= time)
+            break;
+
+        _block.read_skip(4 + 2);
+        uint32 size = _block.read<uint32>();
+        _block.read_skip(std::min<size_t>(size, _block.size() - _block.rpos()));
+    }
+}
+
+void ReplayPlayer::SkipTime(int32 delay)
+{
+    if (!_pcktReading)
+        return;
+
+    _pcktReadTimer = uint32(std::max<int64>(int64(_pcktReadTimer) + delay, 0));
+    Seek(_pcktReadTimer);
+}
+
+bool ReplayPlayer::ReadIndex(long dataStart)
+{
+    _index.clear();
+
+    // try reading index written at recording end
+    uint8 footerData[REPLAY_FOOTER_SIZE];
+    if (fseek(_pcktReading, -long(REPLAY_FOOTER_SIZE), SEEK_END) == 0 && fread(footerData, REPLAY_FOOTER_SIZE, 1, _pcktReading) == 1)
+    {
+        ByteBuffer footer;
+        footer.append(footerData, REPLAY_FOOTER_SIZE);
+        uint64 indexOffset;
+        uint32 magic;
+        footer >> indexOffset >> magic;
+
+        uint8 indexHeaderData[4 + 4];
+        if (magic == REPLAY_INDEX_MAGIC
+            && fseek(_pcktReading, long(indexOffset), SEEK_SET) == 0
+            && fread(indexHeaderData, sizeof(indexHeaderData), 1, _pcktReading) == 1)
         {
-            WorldPacket data(opcode, size);
-            while (true)
+            ByteBuffer index;
+            index.append(indexHeaderData, sizeof(indexHeaderData));
+            uint32 indexMagic, count;
+            index >> indexMagic >> count;
+
+            size_t const entrySize = 4 + 4 + 8;
+            std::vector<uint8> entries(count * entrySize);
+            if (indexMagic == REPLAY_INDEX_MAGIC && (!count || fread(entries.data(), entries.size(), 1, _pcktReading) == 1))
             {
-                if (data.size() >= size && readValue != 256)
-                {
-                    if (_player)
-                        ChatHandler(_player).PSendSysMessage("[Replay] Invalid packet size [opcode %s|size %u|time %u]", GetOpcodeNameForLogging(static_cast<OpcodeClient>(opcode)).c_str(), size, nextTime);
-                    return false;
-                }
-                if (readValue == 256)
-                    break;
-                data << uint8(readValue);
-                int readCount = fscanf(_pcktReading, " %u", &readValue);
-                if (!readCount)
-                {
-                    if (_player)
-                        ChatHandler(_player).PSendSysMessage("[Replay] Invalid packet (truncated) [opcode %s|size %u|time %u]", GetOpcodeNameForLogging(static_cast<OpcodeClient>(opcode)).c_str(), size, nextTime);
-                    return false;
-                }
+                if (count)
+                    index.append(entries.data(), entries.size());
+                _index.resize(count);
+                for (ReplayBlockInfo& block : _index)
+                    index >> block.firstTime >> block.lastTime >> block.offset;
+                return true;
             }
-            _player->GetSession()->SendPacket(&data);
-            fscanf(_pcktReading, "\n");
         }
     }
+
+    // no index, recording was not properly stopped. Walk the blocks headers, skipping their content.
+    long offset = dataStart;
+    uint8 headerData[REPLAY_BLOCK_HEADER_SIZE];
+    while (fseek(_pcktReading, offset, SEEK_SET) == 0 && fread(headerData, REPLAY_BLOCK_HEADER_SIZE, 1, _pcktReading) == 1)
+    {
+        ByteBuffer header;
+        header.append(headerData, REPLAY_BLOCK_HEADER_SIZE);
+        uint32 magic, packetCount, rawSize, storedSize;
+        ReplayBlockInfo block;
+        block.offset = uint64(offset);
+        header >> magic >> block.firstTime >> block.lastTime >> packetCount >> rawSize >> storedSize;
+        if (magic != REPLAY_BLOCK_MAGIC)
+            break;
+
+        offset += long(REPLAY_BLOCK_HEADER_SIZE + storedSize);
+        // last block may have been partially written
+        if (fseek(_pcktReading, offset - 1, SEEK_SET) != 0 || fgetc(_pcktReading) == EOF)
+            break;
+
+        _index.push_back(block);
+    }
+
     return true;
 }
 
 bool ReplayPlayer::ReadFromFile(std::string const& file, WorldLocation& startLoc)
 {
     StopRead(); // Clean
-    _pcktReading = fopen(file.c_str(), "r");
-    if (_pcktReading)
+    _pcktReading = fopen(file.c_str(), "rb");
+    if (!_pcktReading)
+        return false;
+
+    uint8 headerData[REPLAY_HEADER_SIZE];
+    if (fread(headerData, REPLAY_HEADER_SIZE, 1, _pcktReading) != 1)
     {
-        uint32 fileTime = 0;
-        uint32 recorderGuidLow = 0;
-        if (!fscanf(_pcktReading, "BEGIN_TIME=%u\n", &fileTime))
-        {
-            StopRead();
-            return false;
-        }
-        _pcktReadTimer = fileTime;
-        _pcktReadLastUpdate = GetMSTime();
-        if (fscanf(_pcktReading, "RECORDER_LOWGUID=%u\n", &recorderGuidLow))
-            _recorderGuid = recorderGuidLow;
-        else
-            _recorderGuid = 0;
-
-        uint32 mapId = 0;
-        float x, y, z;
-        if (fscanf(_pcktReading, "START_LOC_MAP=%u\n", &mapId))
-            startLoc.m_mapId = mapId;
-        if (fscanf(_pcktReading, "START_LOC_X=%f\n", &x))
-            startLoc.m_positionX = x;
-        if (fscanf(_pcktReading, "START_LOC_Y=%f\n", &y))
-            startLoc.m_positionY = y;
-        if (fscanf(_pcktReading, "START_LOC_Z=%f\n", &z))
-            startLoc.m_positionZ = z;
+        StopRead();
+        return false;
     }
-    else
+
+    ByteBuffer header;
+    header.append(headerData, REPLAY_HEADER_SIZE);
+    uint32 magic, version, recorderGuidLow, mapId, beginTime;
+    float x, y, z;
+    header >> magic >> version >> recorderGuidLow >> mapId >> x >> y >> z >> beginTime;
+    if (magic != REPLAY_FILE_MAGIC || version != REPLAY_FILE_VERSION)
+    {
+        StopRead();
         return false;
+    }
+
+    _recorderGuid = recorderGuidLow;
+    startLoc.m_mapId = mapId;
+    startLoc.m_positionX = x;
+    startLoc.m_positionY = y;
+    startLoc.m_positionZ = z;
+
+    if (!ReadIndex(long(REPLAY_HEADER_SIZE)))
+    {
+        StopRead();
+        return false;
+    }
 
+    _block.clear();
+    _nextBlock = 0;
+    _pcktReadTimer = 0;
+    _pcktReadLastUpdate = GetMSTime();
     return true;
 }
 
@@ -3,6 +3,8 @@
 
 #include "ObjectGuid.h"
 #include "SharedDefines.h"
+#include "ByteBuffer.h"
+#include "ReplayFormat.h"
 
 class Player;
 enum Opcodes : uint16;
@@ -12,12 +14,13 @@ class ReplayPlayer
 {
 public:
 	ReplayPlayer(Player* p) :
-        _player(p),
         _pcktReading(nullptr), 
         _pcktReadSpeedRate(1.0f), 
         _pcktReadTimer(0), 
         _pcktReadLastUpdate(0),
-        _recorderGuid()
+        _recorderGuid(),
+        _nextBlock(0),
+        _player(p)
     {}
     ~ReplayPlayer();
 
@@ -26,19 +29,32 @@ public:
     static bool OpcodeAllowedWhileReplaying(Opcodes op);
 
     ObjectGuid::LowType GetRecorderGuid() const { return _recorderGuid; }
-	void SkipTime(int32 delay) { _pcktReadTimer += delay; }
+    //move forward or backward in replay using blocks index. Packets in skipped range are not sent.
+    void SkipTime(int32 delay);
 	void SetSpeedRate(float r) { _pcktReadSpeedRate = r; }
 	bool ReadFromFile(std::string const& file, WorldLocation& startLoc);
     void StopRead();
 
 private:
+    //read index from file footer, or rebuild it from blocks headers if missing
+    bool ReadIndex(long dataStart);
+    //load and decompress given block, following packets will be read from it
+    bool LoadBlock(size_t blockIndex);
+    void Seek(uint32 time);
+    void ReportError(char const* error, uint32 opcode = 0, uint32 size = 0, uint32 time = 0);
+
     FILE* _pcktReading;
     float  _pcktReadSpeedRate;
-    uint32 _pcktReadTimer;
+    uint32 _pcktReadTimer; //ms since recording start
     uint32 _pcktReadLastUpdate;
     ObjectGuid::LowType _recorderGuid;
 
+    std::vector<ReplayBlockInfo> _index;
+    //content of the block currently read
+    ByteBuffer _block;
+    size_t _nextBlock;
+
     Player* _player;
 };
 
-#endif //REPLAY_PLAYER_H
\ No newline at end of file
+#endif //REPLAY_PLAYER_H
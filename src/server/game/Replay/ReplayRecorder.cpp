@@ -1,7 +1,9 @@
 #include "ReplayRecorder.h"
 #include "Position.h"
 #include "Timer.h"
+#include "World.h"
 #include "WorldPacket.h"
+#include "zlib.h"
 #include <cstdio>
 
 ReplayRecorder::~ReplayRecorder()
@@ -12,33 +14,127 @@ ReplayRecorder::~ReplayRecorder()
 bool ReplayRecorder::StartPacketDump(std::string const& file, WorldLocation startPosition)
 {
     StopPacketDump(); // Clean
-    _pcktWriting = fopen(file.c_str(), "w+");
+    std::lock_guard<std::mutex> lock(_lock);
+    _pcktWriting = fopen(file.c_str(), "wb");
     if (!_pcktWriting)
         return false;
 
-    fprintf(_pcktWriting, "BEGIN_TIME=%u\n", GetMSTime());
-    fprintf(_pcktWriting, "RECORDER_LOWGUID=%u\n", recorderGUID);
-    fprintf(_pcktWriting, "START_LOC_MAP=%u\n", startPosition.GetMapId());
-    fprintf(_pcktWriting, "START_LOC_X=%f\n", startPosition.GetPositionX());
-    fprintf(_pcktWriting, "START_LOC_Y=%f\n", startPosition.GetPositionY());
-    fprintf(_pcktWriting, "START_LOC_Z=%f\n", startPosition.GetPositionZ());
+    _beginTime = GetMSTime();
+    _compressionLevel = sWorld->getIntConfig(CONFIG_REPLAY_COMPRESSION_LEVEL);
+    _block.clear();
+    _block.reserve(REPLAY_BLOCK_MAX_SIZE);
+    _blockPacketCount = 0;
+    _index.clear();
+
+    ByteBuffer header(REPLAY_HEADER_SIZE);
+    header << uint32(REPLAY_FILE_MAGIC);
+    header << uint32(REPLAY_FILE_VERSION);
+    header << uint32(recorderGUID);
+    header << uint32(startPosition.GetMapId());
+    header << float(startPosition.GetPositionX());
+    header << float(startPosition.GetPositionY());
+    header << float(startPosition.GetPositionZ());
+    header << uint32(_beginTime);
+
+    if (fwrite(header.contents(), header.size(), 1, _pcktWriting) != 1)
+    {
+        fclose(_pcktWriting);
+        _pcktWriting = nullptr;
+        return false;
+    }
 
     return true;
 }
 
 void ReplayRecorder::StopPacketDump()
 {
+    std::lock_guard<std::mutex> lock(_lock);
     if (_pcktWriting)
+    {
+        FlushBlock();
+        WriteIndex();
         fclose(_pcktWriting);
+    }
     _pcktWriting = nullptr;
 }
 
 void ReplayRecorder::AddPacket(WorldPacket const* packet)
 {
-    std::stringstream oss;
-    oss << GetMSTime() << ":" << packet->GetOpcode() << ":" << packet->size() << "|";
-    for (size_t i = 0; i < packet->size(); ++i)
-        oss << uint32(packet->read<uint8>(i)) << " ";
-    oss << "256\n";
-    fprintf(_pcktWriting, "%s", oss.str().c_str());
+    std::lock_guard<std::mutex> lock(_lock);
+    if (!_pcktWriting)
+        return;
+
+    uint32 const time = GetMSTimeDiffToNow(_beginTime);
+    if (_blockPacketCount && time - _blockInfo.firstTime >= REPLAY_BLOCK_MAX_DURATION)
+        FlushBlock();
+
+    if (!_blockPacketCount)
+        _blockInfo.firstTime = time;
+    _blockInfo.lastTime = time;
+    _blockPacketCount++;
+
+    _block << uint32(time);
+    _block << uint16(packet->GetOpcode());
+    _block << uint32(packet->size());
+    if (!packet->empty())
+        _block.append(packet->contents(), packet->size());
+
+    if (_block.size() >= REPLAY_BLOCK_MAX_SIZE)
+        FlushBlock();
+}
+
+void ReplayRecorder::FlushBlock()
+{
+    if (!_blockPacketCount)
+        return;
+
+    uint32 const rawSize = _block.size();
+    uint8 const* data = _block.contents();
+    uint32 storedSize = rawSize;
+
+    std::vector<uint8> compressed;
+    if (_compressionLevel)
+    {
+        uLongf destLen = compressBound(rawSize);
+        compressed.resize(destLen);
+        // keep raw data if compression failed or did not help, reader uses raw data whenever stored size == raw size
+        if (compress2(compressed.data(), &destLen, data, rawSize, _compressionLevel) == Z_OK && destLen < rawSize)
+        {
+            data = compressed.data();
+            storedSize = uint32(destLen);
+        }
+    }
+
+    _blockInfo.offset = uint64(ftell(_pcktWriting));
+
+    ByteBuffer blockHeader(REPLAY_BLOCK_HEADER_SIZE);
+    blockHeader << uint32(REPLAY_BLOCK_MAGIC);
+    blockHeader << uint32(_blockInfo.firstTime);
+    blockHeader << uint32(_blockInfo.lastTime);
+    blockHeader << uint32(_blockPacketCount);
+    blockHeader << uint32(rawSize);
+    blockHeader << uint32(storedSize);
+
+    fwrite(blockHeader.contents(), blockHeader.size(), 1, _pcktWriting);
+    fwrite(data, storedSize, 1, _pcktWriting);
+
+    _index.push_back(_blockInfo);
+    _block.clear();
+    _blockPacketCount = 0;
+}
+
+void ReplayRecorder::WriteIndex()
+{
+    uint64 const indexOffset = uint64(ftell(_pcktWriting));
+
+    ByteBuffer index(4 + 4 + _index.size() * (4 + 4 + 8) + REPLAY_FOOTER_SIZE);
+    index << uint32(REPLAY_INDEX_MAGIC);
+    index << uint32(_index.size());
+    for (ReplayBlockInfo const& block : _index)
+        index << uint32(block.firstTime) << uint32(block.lastTime) << uint64(block.offset);
+
+    index << uint64(indexOffset);
+    index << uint32(REPLAY_INDEX_MAGIC);
+
+    fwrite(index.contents(), index.size(), 1, _pcktWriting);
 }
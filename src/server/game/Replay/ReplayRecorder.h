@@ -3,6 +3,9 @@
 
 #include "ObjectGuid.h"
 #include "SharedDefines.h"
+#include "ByteBuffer.h"
+#include "ReplayFormat.h"
+#include <mutex>
 
 class WorldPacket;
 class WorldLocation;
@@ -11,8 +14,11 @@ class ReplayRecorder
 {
 public:
     ReplayRecorder(ObjectGuid::LowType recorderGUID) :
+        _pcktWriting(nullptr),
         recorderGUID(recorderGUID),
-        _pcktWriting(nullptr)
+        _beginTime(0),
+        _compressionLevel(0),
+        _blockPacketCount(0)
     {}
     ~ReplayRecorder();
 
@@ -21,8 +27,23 @@ public:
     void AddPacket(WorldPacket const* packet);
 
 private:
-	FILE* _pcktWriting;
+    // Compress current block if enabled, write it to file and register it in index
+    void FlushBlock();
+    // Write blocks index and footer at end of file
+    void WriteIndex();
+
+    // packets can be sent from both world and map threads
+    std::mutex _lock;
+    FILE* _pcktWriting;
     ObjectGuid::LowType recorderGUID;
+    uint32 _beginTime;
+    int _compressionLevel;
+
+    // packets not yet written to file
+    ByteBuffer _block;
+    ReplayBlockInfo _blockInfo;
+    uint32 _blockPacketCount;
+    std::vector<ReplayBlockInfo> _index;
 };
 
-#endif //REPLAY_RECORDER_H
\ No newline at end of file
+#endif //REPLAY_RECORDER_H
@@ -184,6 +184,24 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
 }
 
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    SendPacket(packet, nullptr);
+}
+
+/// Send a packet whose payload is shared with other recipients, sockets only reference it
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    SendPacket(packet.get(), &packet);
+}
+
+/// Send a packet built for this session only, its payload is moved to the socket
+void WorldSession::SendPacket(WorldPacket&& packet)
+{
+    std::shared_ptr<WorldPacket const> const sharedPacket = std::make_shared<WorldPacket>(std::move(packet));
+    SendPacket(sharedPacket.get(), &sharedPacket);
+}
+
+void WorldSession::SendPacket(WorldPacket const* packet, std::shared_ptr<WorldPacket const> const* sharedPacket)
 {
     ASSERT(packet->GetOpcode() != NULL_OPCODE);
 
@@ -240,7 +258,10 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     //    sScriptMgr->OnPacketSend(this, *packet);
 
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str());
-    m_Socket->SendPacket(*packet);
+    if (sharedPacket)
+        m_Socket->SendPacket(*sharedPacket);
+    else
+        m_Socket->SendPacket(*packet);
 
     // Log packet for replay
     if (m_replayRecorder)
@@ -449,7 +470,8 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     _clientControl.Update(diff);
 
     #ifdef PLAYERBOT
-    if (GetPlayer() && GetPlayer()->GetPlayerbotMgr())
+    // bots sessions are updated from World::UpdateSessions only, their thread-safe packets are handled by their map
+    if (updater.ProcessLogout() && GetPlayer() && GetPlayer()->GetPlayerbotMgr())
         GetPlayer()->GetPlayerbotMgr()->UpdateSessions(0);
     #endif
 
@@ -471,6 +493,9 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     //logout procedure should happen only in World::UpdateSessions() method!!!
     if(updater.ProcessLogout())
     {
+        // auction houses are only accessed from world thread
+        ProcessAuctionSearchCallback();
+
         ///- If necessary, log the player out
         time_t currTime = time(NULL);
         if (ShouldLogOut(currTime) && !m_playerLoading)
@@ -1634,15 +1659,17 @@ void WorldSession::HandleSpellClick(WorldPacket& recvData)
 }
 
 #ifdef PLAYERBOT
-void WorldSession::HandleBotPackets()
+bool WorldSession::HandleBotPackets(PacketFilter& updater)
 {
     WorldPacket* packet;
-    while (_recvQueue.next(packet))
+    while (_recvQueue.next(packet, updater))
     {
         ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
         opHandle->Call(this, *packet);
         delete packet;
     }
+
+    return _recvQueue.empty();
 }
 #endif
 
@@ -18,6 +18,7 @@ class PlayerAntiCheat;
 class MailItemsInfo;
 struct ItemTemplate;
 struct AuctionEntry;
+class AuctionHouseObject;
 struct DeclinedName;
 struct MovementInfo;
 class WardenBase;
@@ -234,6 +235,10 @@ class TC_GAME_API WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const* packet);
+        // packet payload is shared with other recipients instead of being copied for this session socket
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet);
+        // packet built for this session only is moved to the socket instead of being copied
+        void SendPacket(WorldPacket&& packet);
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName *declinedName);
@@ -379,6 +384,8 @@ class TC_GAME_API WorldSession
         void SendAuctionCommandResult( uint32 auctionId, uint32 Action, uint32 ErrorCode, uint32 bidError = 0);
         void SendAuctionBidderNotification( uint32 location, uint32 auctionId, uint64 bidder, uint32 bidSum, uint32 diff, uint32 item_template);
         void SendAuctionOwnerNotification( AuctionEntry * auction );
+        uint32 GetAuctionSearchCount() const { return _auctionSearchCount; }
+        uint32 GetAuctionSearchThrottledCount() const { return _auctionSearchThrottledCount; }
 
         //Item Enchantment
         void SendEnchantmentLog(ObjectGuid Target, ObjectGuid Caster, uint32 ItemID, uint32 SpellID);
@@ -829,7 +836,10 @@ class TC_GAME_API WorldSession
         void HandleReportPvPAFK( WorldPacket &recvData );
 
         #ifdef PLAYERBOT
-        void HandleBotPackets();
+        // Bot sessions have no socket, their queued packets are processed here instead of in Update.
+        // Thread-safe packets with a MapSessionFilter from the bot map update, the others with a WorldSessionFilter from the world thread.
+        // Returns true once the queue is empty.
+        bool HandleBotPackets(PacketFilter& updater);
         #endif
 
         void HandleWardenDataOpcode(WorldPacket& recvData);
@@ -919,6 +929,23 @@ class TC_GAME_API WorldSession
 
         QueryCallbackProcessor _queryProcessor;
 
+        //CMSG_AUCTION_LIST_ITEMS executed by AuctionSearcher threads, answered from world thread once the result is ready
+        struct PendingAuctionSearch
+        {
+            std::future<std::vector<uint32>> result;
+            AuctionHouseObject* auctionHouse = nullptr;
+            uint32 listfrom = 0;
+            uint32 usable = 0;
+        };
+        void ProcessAuctionSearchCallback();
+
+        PendingAuctionSearch _auctionSearch;
+        //auction searches rate limiting, see AuctionHouse.Search.RateLimit
+        time_t _auctionSearchWindowStart = 0;
+        uint32 _auctionSearchWindowCount = 0;
+        uint32 _auctionSearchCount = 0;
+        uint32 _auctionSearchThrottledCount = 0;
+
     friend class World;
     protected:
         class DosProtection
@@ -956,6 +983,9 @@ class TC_GAME_API WorldSession
 
         bool CanUseBank(ObjectGuid bankerGUID = ObjectGuid::Empty) const;
 
+        // sharedPacket is null if packet is owned by caller
+        void SendPacket(WorldPacket const* packet, std::shared_ptr<WorldPacket const> const* sharedPacket);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
         void LogUnprocessedTail(WorldPacket* packet);
@@ -10,18 +10,28 @@
 #include "DatabaseEnv.h"
 #include "AccountMgr.h"
 #include "ServerPktHeader.h"
+#include "Monitor.h"
 #include <boost/asio/ip/tcp.hpp>
 #include "LogsDatabaseAccessor.h"
 
-class EncryptablePacket : public WorldPacket
+// Payloads at least this big are not copied into socket buffers, they're sent straight from the (possibly shared) packet
+#define SHARED_PAYLOAD_MIN_SIZE 128
+
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
+    EncryptablePacket(std::shared_ptr<WorldPacket const> packet, bool encrypt, bool copied) : _packet(std::move(packet)), _encrypt(encrypt), _copied(copied) { }
 
+    WorldPacket const& GetPacket() const { return *_packet; }
+    std::shared_ptr<WorldPacket const> const& GetSharedPacket() const { return _packet; }
     bool NeedsEncryption() const { return _encrypt; }
+    // payload was copied for this socket only when queued
+    bool IsCopied() const { return _copied; }
 
 private:
+    std::shared_ptr<WorldPacket const> _packet;
     bool _encrypt;
+    bool _copied;
 };
 
 using boost::asio::ip::tcp;
@@ -79,34 +89,36 @@ void WorldSocket::CheckIpCallback(PreparedQueryResult result)
 bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
+    SocketWriteBuffer buffer{ MessageBuffer(_sendBufferSize) };
+    uint64 bytesCopied = 0;
+    uint64 bytesShared = 0;
     while (_bufferQueue.Dequeue(queued))
     {
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
+        WorldPacket const& packet = queued->GetPacket();
+        ServerPktHeader header(packet.size() + 2, packet.GetOpcode());
         if (_authCrypt && queued->NeedsEncryption())
             _authCrypt->EncryptSend(header.header, header.getHeaderLength());
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
+        // only the header is written in our buffer for big payloads, they're referenced and sent from the packet
+        bool const sharePayload = packet.size() >= SHARED_PAYLOAD_MIN_SIZE;
+        std::size_t const ownedSize = header.getHeaderLength() + (sharePayload ? 0 : packet.size());
+        if (buffer.buffer.GetRemainingSpace() < ownedSize)
         {
             QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
+            buffer = SocketWriteBuffer(MessageBuffer(std::max<std::size_t>(_sendBufferSize, ownedSize)));
         }
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
-        {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
-        }
-        else    // single packet larger than 4096 bytes
-        {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
+        buffer.Write(header.header, header.getHeaderLength());
+        if (sharePayload)
+            buffer.WriteShared(queued->GetSharedPacket(), packet.contents(), packet.size());
+        else if (!packet.empty())
+            buffer.Write(packet.contents(), packet.size());
 
-            QueuePacket(std::move(packetBuffer));
-        }
+        // payload copied once, either when queued or into our buffer
+        if (queued->IsCopied() || !sharePayload)
+            bytesCopied += packet.size();
+        else
+            bytesShared += packet.size();
 
         delete queued;
     }
@@ -114,6 +126,9 @@ bool WorldSocket::Update()
     if (buffer.GetActiveSize() > 0)
         QueuePacket(std::move(buffer));
 
+    if (bytesCopied || bytesShared)
+        sMonitor->SocketPacketsQueued(bytesCopied, bytesShared);
+
     if (!BaseSocket::Update())
         return false;
 
@@ -143,7 +158,7 @@ void WorldSocket::HandleSendAuthSession()
     packet << uint32(_authSeed);
 #endif
 
-    SendPacketAndLogOpcode(packet);
+    SendPacketAndLogOpcode(std::move(packet));
 }
 
 void WorldSocket::OnClose()
@@ -410,10 +425,10 @@ void WorldSocket::LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex
     }
 }
 
-void WorldSocket::SendPacketAndLogOpcode(WorldPacket const& packet)
+void WorldSocket::SendPacketAndLogOpcode(WorldPacket&& packet)
 {
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetRemoteIpAddress().to_string().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet.GetOpcode())).c_str());
-    SendPacket(packet);
+    SendPacket(std::move(packet));
 }
 
 void WorldSocket::SendPacket(WorldPacket const& packet)
@@ -421,20 +436,43 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     if (!IsOpen())
         return;
 
+    // caller keeps its packet, this is the only copy of the payload
+    QueueSendPacket(std::make_shared<WorldPacket>(packet), true);
+}
+
+void WorldSocket::SendPacket(WorldPacket&& packet)
+{
+    if (!IsOpen())
+        return;
+
+    QueueSendPacket(std::make_shared<WorldPacket>(std::move(packet)), false);
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    QueueSendPacket(packet, false);
+}
+
+void WorldSocket::QueueSendPacket(std::shared_ptr<WorldPacket const> packet, bool copied)
+{
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
     if (sWorld->getConfig(CONFIG_DEBUG_LOG_ALL_PACKETS))
-        sPacketLog->DumpPacket(LOG_LEVEL_TRACE, SERVER_TO_CLIENT, packet, _worldSession ? _worldSession->GetPlayerInfo() : GetRemoteIpAddress().to_string());
+        sPacketLog->DumpPacket(LOG_LEVEL_TRACE, SERVER_TO_CLIENT, *packet, _worldSession ? _worldSession->GetPlayerInfo() : GetRemoteIpAddress().to_string());
 
     if (sWorld->getConfig(CONFIG_DEBUG_LOG_LAST_PACKETS))
     {
         boost::unique_lock<boost::shared_mutex> lock(_lastPacketsSent_mutex);
         if (_lastPacketsSent.size() < 10)
-            _lastPacketsSent.push_back(packet);
+            _lastPacketsSent.push_back(*packet);
     }
 
-    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt && _authCrypt->IsInitialized()));
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt && _authCrypt->IsInitialized(), copied));
+    WakeUp();
 }
 
 void WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
@@ -647,7 +685,7 @@ void WorldSocket::SendAuthResponseError(uint8 code)
     WorldPacket packet(SMSG_AUTH_RESPONSE, 1);
     packet << uint8(code);
 
-    SendPacketAndLogOpcode(packet);
+    SendPacketAndLogOpcode(std::move(packet));
 }
 
 bool WorldSocket::HandlePing(WorldPacket& recvPacket)
@@ -708,7 +746,7 @@ bool WorldSocket::HandlePing(WorldPacket& recvPacket)
 
     WorldPacket packet(SMSG_PONG, 4);
     packet << ping;
-    SendPacketAndLogOpcode(packet);
+    SendPacketAndLogOpcode(std::move(packet));
     return true;
 }
 
@@ -0,0 +1,98 @@
+#include "AuraEffectList.h"
+#include <algorithm>
+
+AuraEffectList::AuraEffectList(AuraEffectList const& other) : AuraEffectList()
+{
+    *this = other;
+}
+
+AuraEffectList& AuraEffectList::operator=(AuraEffectList const& other)
+{
+    if (this == &other)
+        return *this;
+
+    _effects.clear();
+    _effects.reserve(other._size);
+    for (AuraEffect* aurEff : other)
+        _effects.push_back(aurEff);
+    _size = other._size;
+    InvalidateAggregates();
+    return *this;
+}
+
+void AuraEffectList::push_back(AuraEffect* aurEff)
+{
+    _effects.push_back(aurEff);
+    ++_size;
+    InvalidateAggregates();
+}
+
+void AuraEffectList::remove(AuraEffect* aurEff)
+{
+    auto itr = std::find(_effects.begin(), _effects.end(), aurEff);
+    if (itr == _effects.end())
+        return;
+
+    *itr = nullptr;
+    --_size;
+    InvalidateAggregates();
+}
+
+void AuraEffectList::clear()
+{
+    _effects.clear();
+    _size = 0;
+    InvalidateAggregates();
+}
+
+void AuraEffectList::Compact()
+{
+    _effects.erase(std::remove(_effects.begin(), _effects.end(), nullptr), _effects.end());
+}
+
+bool AuraEffectList::GetAggregate(Aggregate aggregate, int32& value) const
+{
+    if (!(_cachedAggregates & aggregate))
+        return false;
+
+    switch (aggregate)
+    {
+        case AGGREGATE_TOTAL_MODIFIER:        value = _totalModifier; break;
+        case AGGREGATE_MAX_POSITIVE_MODIFIER: value = _maxPositiveModifier; break;
+        case AGGREGATE_MAX_NEGATIVE_MODIFIER: value = _maxNegativeModifier; break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+bool AuraEffectList::GetAggregate(Aggregate aggregate, float& value) const
+{
+    if (aggregate != AGGREGATE_TOTAL_MULTIPLIER || !(_cachedAggregates & aggregate))
+        return false;
+
+    value = _totalMultiplier;
+    return true;
+}
+
+void AuraEffectList::SetAggregate(Aggregate aggregate, int32 value) const
+{
+    switch (aggregate)
+    {
+        case AGGREGATE_TOTAL_MODIFIER:        _totalModifier = value; break;
+        case AGGREGATE_MAX_POSITIVE_MODIFIER: _maxPositiveModifier = value; break;
+        case AGGREGATE_MAX_NEGATIVE_MODIFIER: _maxNegativeModifier = value; break;
+        default:
+            return;
+    }
+    _cachedAggregates |= aggregate;
+}
+
+void AuraEffectList::SetAggregate(Aggregate aggregate, float value) const
+{
+    if (aggregate != AGGREGATE_TOTAL_MULTIPLIER)
+        return;
+
+    _totalMultiplier = value;
+    _cachedAggregates |= aggregate;
+}
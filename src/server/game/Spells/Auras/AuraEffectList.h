@@ -0,0 +1,96 @@
+#ifndef TRINITY_AURAEFFECTLIST_H
+#define TRINITY_AURAEFFECTLIST_H
+
+#include "Define.h"
+#include <iterator>
+#include <vector>
+
+class AuraEffect;
+
+/**
+Aura effects of one type applied on a unit (see Unit::GetAuraEffectsByType), in application order.
+Effects are stored contiguously. Removed effects only leave a hole until the next Compact() call, so that
+effects can be applied and removed while iterating: iterators are indexes and skip holes, effects added
+during an iteration are only visited if end() is evaluated again.
+Also caches the aggregates of all effects amounts used by stat and damage formulas (see Unit::GetTotalAuraModifier),
+they are invalidated on effect apply/remove and amount change.
+*/
+class TC_GAME_API AuraEffectList
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef AuraEffect* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef AuraEffect* const* pointer;
+        typedef AuraEffect* reference;
+
+        const_iterator(AuraEffectList const* list, uint32 index) : _list(list), _index(index) { }
+
+        AuraEffect* operator*() const { return _list->_effects[_index]; }
+        const_iterator& operator++() { _index = _list->NextIndex(_index + 1); return *this; }
+        const_iterator operator++(int) { const_iterator itr = *this; ++(*this); return itr; }
+        bool operator==(const_iterator const& other) const { return _index == other._index; }
+        bool operator!=(const_iterator const& other) const { return _index != other._index; }
+
+    private:
+        AuraEffectList const* _list;
+        uint32 _index;
+    };
+    // effects are pointers, constness of the list does not apply to them
+    typedef const_iterator iterator;
+
+    enum Aggregate : uint8
+    {
+        AGGREGATE_TOTAL_MODIFIER        = 0x1,
+        AGGREGATE_TOTAL_MULTIPLIER      = 0x2,
+        AGGREGATE_MAX_POSITIVE_MODIFIER = 0x4,
+        AGGREGATE_MAX_NEGATIVE_MODIFIER = 0x8
+    };
+
+    AuraEffectList() : _size(0), _cachedAggregates(0), _totalModifier(0), _maxPositiveModifier(0), _maxNegativeModifier(0), _totalMultiplier(1.0f) { }
+    // copies are compacted, and are used to iterate over effects that may be removed
+    AuraEffectList(AuraEffectList const& other);
+    AuraEffectList& operator=(AuraEffectList const& other);
+
+    const_iterator begin() const { return const_iterator(this, NextIndex(0)); }
+    const_iterator end() const { return const_iterator(this, uint32(_effects.size())); }
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    AuraEffect* front() const { return *begin(); }
+
+    void push_back(AuraEffect* aurEff);
+    void remove(AuraEffect* aurEff);
+    void clear();
+
+    // Removes holes left by removed effects. Must not be called while iterating.
+    void Compact();
+    bool NeedsCompact() const { return _size != _effects.size(); }
+
+    void InvalidateAggregates() { _cachedAggregates = 0; }
+    bool GetAggregate(Aggregate aggregate, int32& value) const;
+    bool GetAggregate(Aggregate aggregate, float& value) const;
+    void SetAggregate(Aggregate aggregate, int32 value) const;
+    void SetAggregate(Aggregate aggregate, float value) const;
+
+private:
+    uint32 NextIndex(uint32 index) const
+    {
+        while (index < _effects.size() && !_effects[index])
+            ++index;
+        return index;
+    }
+
+    std::vector<AuraEffect*> _effects;
+    uint32 _size;
+
+    mutable uint8 _cachedAggregates;
+    mutable int32 _totalModifier;
+    mutable int32 _maxPositiveModifier;
+    mutable int32 _maxNegativeModifier;
+    mutable float _totalMultiplier;
+};
+
+#endif // TRINITY_AURAEFFECTLIST_H
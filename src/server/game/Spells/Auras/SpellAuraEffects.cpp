@@ -346,6 +346,21 @@ void AuraEffect::GetApplicationVector(Container& applicationContainer) const
     }
 }
 
+void AuraEffect::SetAmount(int32 amount)
+{
+    _amount = amount;
+    m_canBeRecalculated = false;
+    InvalidateTargetsAggregates();
+}
+
+void AuraEffect::InvalidateTargetsAggregates() const
+{
+    Aura::ApplicationMap const& targetMap = GetBase()->GetApplicationMap();
+    for (auto appIter = targetMap.begin(); appIter != targetMap.end(); ++appIter)
+        if (appIter->second->HasEffect(GetEffIndex()))
+            appIter->second->GetTarget()->_InvalidateAuraEffectAggregates(GetAuraType());
+}
+
 int32 AuraEffect::CalculateAmount(Unit* caster)
 {
     int32 amount = m_spellInfo->Effects[m_effIndex].CalcValue(caster, &m_baseAmount);
@@ -2213,6 +2228,7 @@ void AuraEffect::PeriodicDummyTick(AuraApplication* aurApp, Unit* caster, uint32
         else if (regen_pct < 0.2f) 
             regen_pct = 0.2f;
         _amount = int32(base_regen * regen_pct);
+        InvalidateTargetsAggregates();
         (m_target->ToPlayer())->UpdateManaRegen();
         return;
     }
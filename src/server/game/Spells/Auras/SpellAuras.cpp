@@ -1637,10 +1637,23 @@ void Aura::SetCharges(uint8 charges)
         return;
 
     m_procCharges = charges;
-    m_isUsingCharges = m_procCharges != 0;
+    SetUsingCharges(m_procCharges != 0);
     SetNeedClientUpdateForTargets();
 }
 
+void Aura::SetUsingCharges(bool val)
+{
+    if (m_isUsingCharges == val)
+        return;
+
+    m_isUsingCharges = val;
+
+    // charged spell mods are handled separately by players spell mod cache
+    for (ApplicationMap::const_iterator appIter = m_applications.begin(); appIter != m_applications.end(); ++appIter)
+        if (Player* player = appIter->second->GetTarget()->ToPlayer())
+            player->InvalidateSpellModCache();
+}
+
 void Aura::ModChargesDelayed(int32 num, AuraRemoveMode removeMode)
 {
     m_dropEvent = nullptr;
@@ -2415,7 +2428,7 @@ void Aura::SetLoadedState(int32 maxduration, int32 duration, int32 charges, uint
     m_maxDuration = maxduration;
     m_duration = duration;
     m_procCharges = charges;
-    m_isUsingCharges = m_procCharges != 0;
+    SetUsingCharges(m_procCharges != 0);
     m_stackAmount = stackamount;
     Unit* caster = GetCaster();
     for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
@@ -243,7 +243,7 @@ public:
     uint8 GetProcEffectMask(AuraApplication* aurApp, ProcEventInfo& eventInfo, std::chrono::steady_clock::time_point now) const;
     float CalcProcChance(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo) const;
     void TriggerProcOnEvent(uint8 procEffectMask, AuraApplication* aurApp, ProcEventInfo& eventInfo);
-    void SetUsingCharges(bool val) { m_isUsingCharges = val; }
+    void SetUsingCharges(bool val);
     bool IsUsingCharges() const { return m_isUsingCharges; }
 
     void HeartbeatResistance(uint32 diff, Unit* caster);
@@ -1283,6 +1283,8 @@ void Spell::SelectImplicitConeTargets(SpellEffIndex effIndex, SpellImplicitTarge
                 Trinity::Containers::RandomResize(targets, maxTargets);
             }
 
+            PrefetchAreaTargetsLOS(targets, effIndex, nullptr);
+
             for (auto & target : targets)
             {
                 if (Unit* newTarget = target->ToUnit())
@@ -1375,6 +1377,8 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
             Trinity::Containers::RandomResize(targets, maxTargets);
         }
 
+        PrefetchAreaTargetsLOS(targets, effIndex, center);
+
         for (auto & target : targets)
         {
             if (Unit* newTarget = target->ToUnit())
@@ -1385,6 +1389,71 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
     }
 }
 
+void Spell::PrefetchAreaTargetsLOS(std::list<WorldObject*> const& targets, SpellEffIndex effIndex, Position const* losPosition) const
+{
+    Map* map = m_caster->GetMap();
+    if (targets.size() < 2 || !map->IsLineOfSightCacheEnabled() || m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS))
+        return;
+
+    // must match the IsWithinLOS checks of CheckEffectTarget
+    Position origin;
+    VMAP::ModelIgnoreFlags ignoreFlags = VMAP::ModelIgnoreFlags::M2;
+    if (IsTriggered())
+    {
+        if (m_triggeredByAuraSpell && m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS))
+            return;
+
+        if (m_caster->GetTypeId() == TYPEID_UNIT && m_caster->ToCreature()->IsTotem() && IsPositive())
+            return;
+
+        origin = m_targets.HasDst() ? m_targets.GetDstPos()->GetPosition() : m_caster->GetPosition();
+        ignoreFlags = VMAP::ModelIgnoreFlags::Nothing;
+    }
+    else
+    {
+        switch (m_spellInfo->Effects[effIndex].Effect)
+        {
+            case SPELL_EFFECT_RESURRECT_NEW:
+            case SPELL_EFFECT_SKIN_PLAYER_CORPSE:
+                return;
+            default:
+                break;
+        }
+
+        if (losPosition)
+            origin = *losPosition;
+        else if (m_targets.HasDst())
+        {
+            origin = m_targets.GetDstPos()->GetPosition();
+            ignoreFlags = VMAP::ModelIgnoreFlags::Nothing;
+        }
+        else
+            return;
+    }
+
+    // rays are checked in the targets phase, only batch those sharing the first target phase
+    std::vector<VMAP::LineOfSightRay> rays;
+    rays.reserve(targets.size());
+    uint32 phaseMask = 0;
+    for (WorldObject* target : targets)
+    {
+        Unit* unit = target->ToUnit();
+        if (!unit || !unit->IsInWorld() || unit->GetMap() != map)
+            continue;
+
+        if (rays.empty())
+            phaseMask = unit->GetPhaseMask();
+        else if (unit->GetPhaseMask() != phaseMask)
+            continue;
+
+        rays.emplace_back();
+        unit->GetLOSRayTo(origin.GetPositionX(), origin.GetPositionY(), origin.GetPositionZ(), rays.back());
+    }
+
+    if (rays.size() >= 2)
+        map->isInLineOfSight(rays.data(), rays.size(), phaseMask, LINEOFSIGHT_ALL_CHECKS, ignoreFlags);
+}
+
 void Spell::SelectImplicitCasterDestTargets(SpellEffIndex effIndex, SpellImplicitTargetInfo const& targetType)
 {
     SpellDestination dest(*m_caster);
@@ -1162,19 +1162,21 @@ void TestCase::HandleSpellsCleanup(Unit* caster)
 {
     //Spell deletions are done in SpellEvent
     EventList& eventList = caster->m_Events.m_events;
-    for (auto itr = eventList.begin(); itr != eventList.end();)
-    {
-        if (SpellEvent* spellEvent = dynamic_cast<SpellEvent*>(itr->second))
+    std::vector<SpellEvent*> finishedEvents;
+    for (QueuedEvent const& queued : eventList)
+        if (SpellEvent* spellEvent = dynamic_cast<SpellEvent*>(queued.event))
             if (spellEvent->m_Spell->getState() == SPELL_STATE_FINISHED && spellEvent->m_Spell->IsDeletable())
-            {
-                //what we're doing here is mimicing the EventProcessor::Update + SpellEvent::Execute behavior in this case, that is -> just delete the event.
-                itr = eventList.erase(itr);
-                delete spellEvent; //SpellEvent deletion handle spell deletion
-                continue;
-            }
+                finishedEvents.push_back(spellEvent);
 
-        itr++;
+    //what we're doing here is mimicing the EventProcessor::Update + SpellEvent::Execute behavior in this case, that is -> just delete the event.
+    for (SpellEvent* spellEvent : finishedEvents)
+    {
+        eventList.erase(std::find_if(eventList.begin(), eventList.end(), [spellEvent](QueuedEvent const& queued) { return queued.event == spellEvent; }));
+        delete spellEvent; //SpellEvent deletion handle spell deletion
     }
+    //erasing events breaks the queue ordering
+    if (!finishedEvents.empty())
+        caster->m_Events.RebuildQueue();
 }
 
 void TestCase::_MaxHealth(Unit* unit, bool lowHealth /*= false*/)
@@ -607,6 +607,13 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading","Compression level (%i) must be in range 1..9. Using default compression level (1).",m_configs[CONFIG_COMPRESSION]);
         m_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_configs[CONFIG_COMPRESSION_THRESHOLD] = sConfigMgr->GetIntDefault("Compression.Threshold", 100);
+    m_configs[CONFIG_REPLAY_COMPRESSION_LEVEL] = sConfigMgr->GetIntDefault("Replay.Compression", 1);
+    if (m_configs[CONFIG_REPLAY_COMPRESSION_LEVEL] > 9)
+    {
+        TC_LOG_ERROR("server.loading", "Replay.Compression level (%u) must be in range 0..9. Using default compression level (1).", m_configs[CONFIG_REPLAY_COMPRESSION_LEVEL]);
+        m_configs[CONFIG_REPLAY_COMPRESSION_LEVEL] = 1;
+    }
     m_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfigMgr->GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfigMgr->GetIntDefault("PlayerSaveInterval", 60000);
@@ -1193,6 +1200,8 @@ void World::LoadConfigSettings(bool reload)
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
     TC_LOG_INFO("server.loading", "WORLD: VMap support included. LineOfSight:%i, getHeight:%i",enableLOS, enableHeight);
     TC_LOG_INFO("server.loading", "WORLD: VMap data directory is: %svmaps",m_dataPath.c_str());
+    m_configs[CONFIG_LOS_CACHE_SIZE] = sConfigMgr->GetIntDefault("LineOfSight.Cache.Size", 4096);
+    m_configs[CONFIG_LOS_CACHE_LIFETIME] = sConfigMgr->GetIntDefault("LineOfSight.Cache.Lifetime", 1000);
 
     m_configs[CONFIG_PREMATURE_BG_REWARD] = sConfigMgr->GetBoolDefault("Battleground.PrematureReward", true);
     m_configs[CONFIG_START_ALL_EXPLORED] = sConfigMgr->GetBoolDefault("PlayerStart.MapsExplored", false);
@@ -1208,6 +1217,18 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_NO_RESET_TALENT_COST] = sConfigMgr->GetBoolDefault("NoResetTalentsCost", false);
     m_configs[CONFIG_SHOW_KICK_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowKickInWorld", false);
     m_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 4);
+    m_configs[CONFIG_MAP_PARALLEL_GRIDS_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.ParallelGrids.Threads", 0);
+    m_configs[CONFIG_MAP_PARALLEL_GRIDS_MIN_PLAYERS] = sConfigMgr->GetIntDefault("MapUpdate.ParallelGrids.MinPlayers", 100);
+    m_configs[CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS] = sConfigMgr->GetIntDefault("MapUpdate.ParallelGrids.BorderCells", 1);
+    if (m_configs[CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS] < 1 || m_configs[CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS] > 3)
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.ParallelGrids.BorderCells (%u) must be in range 1..3. Set to 1.", m_configs[CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS]);
+        m_configs[CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS] = 1;
+    }
+    m_configs[CONFIG_GRID_PRELOAD_THREADS] = sConfigMgr->GetIntDefault("GridPreload.Threads", 0);
+    m_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = sConfigMgr->GetIntDefault("GridPreload.LookAhead", 5000);
+    m_configs[CONFIG_AUCTION_SEARCH_THREADS] = sConfigMgr->GetIntDefault("AuctionHouse.Search.Threads", 0);
+    m_configs[CONFIG_AUCTION_SEARCH_RATE_LIMIT] = sConfigMgr->GetIntDefault("AuctionHouse.Search.RateLimit", 0);
 
     m_configs[CONFIG_WORLDCHANNEL_MINLEVEL] = sConfigMgr->GetIntDefault("WorldChannel.MinLevel", 10);
     m_configs[CONFIG_TICKET_LEVEL_REQ] = sConfigMgr->GetIntDefault("LevelReq.Ticket", 1);
@@ -1219,6 +1240,12 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_MONITORING_ABNORMAL_MAP_UPDATE_DIFF] = sConfigMgr->GetIntDefault("Monitor.AbnormalDiff.Map", 400);
     m_configs[CONFIG_MONITORING_ALERT_THRESHOLD_COUNT] = sConfigMgr->GetIntDefault("Monitor.LagAlertThreshold.Count", 10);
     m_configs[CONFIG_MONITORING_LAG_AUTO_REBOOT_COUNT] = sConfigMgr->GetIntDefault("Monitor.LagAutoReboot.Count", 8000);
+    m_configs[CONFIG_MONITORING_TICK_HISTORY_SIZE] = sConfigMgr->GetIntDefault("Monitor.TickHistory.Size", 3000);
+    if (m_configs[CONFIG_MONITORING_TICK_HISTORY_SIZE] < 1)
+    {
+        TC_LOG_ERROR("server.loading", "Monitor.TickHistory.Size must be greater than 0. Setting it to default value (3000)");
+        m_configs[CONFIG_MONITORING_TICK_HISTORY_SIZE] = 3000;
+    }
     m_configs[CONFIG_MONITORING_DYNAMIC_VIEWDIST] = sConfigMgr->GetBoolDefault("Monitor.DynamicViewDist.Enable", 0);
     m_configs[CONFIG_MONITORING_DYNAMIC_VIEWDIST_MINDIST] = sConfigMgr->GetIntDefault("Monitor.DynamicViewDist.MinDistance", 60);
     if (m_configs[CONFIG_MONITORING_DYNAMIC_VIEWDIST_MINDIST] < 60)
@@ -1505,6 +1532,23 @@ void World::SetInitialWorldSettings()
     MMAP::MMapManager* mmmgr = MMAP::MMapFactory::createOrGetMMapManager();
     mmmgr->InitializeThreadUnsafe(mapIds);
 
+    std::vector<uint32> preloadMapIds;
+    Tokenizer preloadTokens(sConfigMgr->GetStringDefault("MMap.PreloadMaps", ""), ',', 0, false);
+    for (char const* token : preloadTokens)
+    {
+        uint32 mapId = atoi(token);
+        if (sMapStore.LookupEntry(mapId))
+            preloadMapIds.push_back(mapId);
+        else
+            TC_LOG_ERROR("server.loading", "MMap.PreloadMaps contains invalid map id %s, skipped", token);
+    }
+
+    if (!preloadMapIds.empty())
+    {
+        TC_LOG_INFO("server.loading", "Preloading mmaps...");
+        mmmgr->PreloadMaps(preloadMapIds);
+    }
+
     TC_LOG_INFO("server.loading","Loading Item Extended Cost Data...");
     sObjectMgr->LoadItemExtendedCost();
 
@@ -1760,8 +1804,11 @@ void World::SetInitialWorldSettings()
 
     ///- Load dynamic data tables from the database
     TC_LOG_INFO("server.loading", "Loading Auctions..." );
+    sAuctionMgr->LoadNormalizedItemNames();
     sAuctionMgr->LoadAuctionItems();
     sAuctionMgr->LoadAuctions();
+    if (uint32 searchThreads = getIntConfig(CONFIG_AUCTION_SEARCH_THREADS))
+        sAuctionMgr->GetSearcher().activate(searchThreads);
 
     TC_LOG_INFO("server.loading", "Loading Guilds..." );
     sGuildMgr->LoadGuilds();
@@ -2480,6 +2527,10 @@ void World::KickAll()
     // session not removed at kick and will removed in next update tick
     for (auto & m_session : m_sessions)
         m_session.second->KickPlayer();
+
+    #ifdef PLAYERBOT
+    sRandomPlayerbotMgr.SaveEventValues();
+    #endif
 }
 
 /// Kick (and save) all players with security level less `sec`
@@ -83,6 +83,8 @@ enum WorldTimers
 enum WorldConfigs
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_THRESHOLD,
+    CONFIG_REPLAY_COMPRESSION_LEVEL,
     CONFIG_GRID_UNLOAD,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_MAPUPDATE,
@@ -246,6 +248,15 @@ enum WorldConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PREMATURE_BG_REWARD,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_PARALLEL_GRIDS_THREADS,
+    CONFIG_MAP_PARALLEL_GRIDS_MIN_PLAYERS,
+    CONFIG_MAP_PARALLEL_GRIDS_BORDER_CELLS,
+    CONFIG_LOS_CACHE_SIZE,
+    CONFIG_LOS_CACHE_LIFETIME,
+    CONFIG_GRID_PRELOAD_THREADS,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
+    CONFIG_AUCTION_SEARCH_THREADS,
+    CONFIG_AUCTION_SEARCH_RATE_LIMIT,
 
     CONFIG_WORLDCHANNEL_MINLEVEL,
     CONFIG_TICKET_LEVEL_REQ,
@@ -373,6 +384,7 @@ enum WorldConfigs
     CONFIG_MONITORING_DYNAMIC_VIEWDIST_AVERAGE_COUNT,
 
 	CONFIG_MONITORING_LAG_AUTO_REBOOT_COUNT,
+    CONFIG_MONITORING_TICK_HISTORY_SIZE,
 
     CONFIG_HOTSWAP_ENABLED,
     CONFIG_HOTSWAP_RECOMPILER_ENABLED,
@@ -62,14 +62,15 @@ void PacketHandlingHelper::AddPacket(const WorldPacket& packet)
 
 
 PlayerbotAI::PlayerbotAI() : PlayerbotAIBase(), bot(nullptr), aiObjectContext(nullptr),
-    currentEngine(nullptr), chatHelper(this), chatFilter(this), accountId(0), security(nullptr), master(nullptr), currentState(BOT_STATE_NON_COMBAT)
+    currentEngine(nullptr), chatHelper(this), chatFilter(this), accountId(0), security(nullptr), master(nullptr), currentState(BOT_STATE_NON_COMBAT),
+    resetStrategiesOnWorldPackets(false)
 {
     for (int i = 0 ; i < BOT_STATE_MAX; i++)
         engines[i] = nullptr;
 }
 
 PlayerbotAI::PlayerbotAI(Player* bot) :
-    PlayerbotAIBase(), chatHelper(this), chatFilter(this), security(bot), master(nullptr)
+    PlayerbotAIBase(), chatHelper(this), chatFilter(this), security(bot), master(nullptr), resetStrategiesOnWorldPackets(false)
 {
     this->bot = bot;
 
@@ -211,6 +212,38 @@ void PlayerbotAI::HandleTeleportAck()
     }
 }
 
+void PlayerbotAI::QueueWorldPacket(WorldPacket* packet, bool resetStrategies)
+{
+    if (resetStrategies)
+        resetStrategiesOnWorldPackets = true;
+
+    bot->GetSession()->QueuePacket(packet);
+}
+
+bool PlayerbotAI::HandleOrQueueWorldPacket(WorldPacket* packet)
+{
+    ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
+    if (opHandle->ProcessingPlace == PROCESS_THREADUNSAFE)
+    {
+        QueueWorldPacket(packet);
+        return false;
+    }
+
+    opHandle->Call(bot->GetSession(), *packet);
+    delete packet;
+    return true;
+}
+
+void PlayerbotAI::OnWorldPacketsHandled()
+{
+    // group membership changes the default strategies of random bots
+    if (resetStrategiesOnWorldPackets)
+    {
+        resetStrategiesOnWorldPackets = false;
+        ResetStrategies();
+    }
+}
+
 void PlayerbotAI::Reset()
 {
     if (bot->IsFlying())
@@ -1088,7 +1121,7 @@ bool PlayerbotAI::HasAuraToDispel(Unit* target, uint32 dispelType)
     for (uint32 type = SPELL_AURA_NONE; type < TOTAL_AURAS; ++type)
     {
         auto const& auras = target->GetAuraEffectsByType((AuraType)type);
-        for (std::list<AuraEffect*>::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
+        for (auto itr = auras.begin(); itr != auras.end(); ++itr)
         {
             const Aura* const aura = (*itr)->GetBase();
             const SpellInfo* entry = aura->GetSpellInfo();
@@ -110,6 +110,13 @@ public:
     void HandleMasterIncomingPacket(const WorldPacket& packet);
     void HandleMasterOutgoingPacket(const WorldPacket& packet);
     void HandleTeleportAck();
+    // Thread-unsafe handlers can't run from the bot map update, the packet is handled on the world thread by
+    // PlayerbotHolder::UpdateSessions. With resetStrategies, the strategies are reset once it has been handled.
+    void QueueWorldPacket(WorldPacket* packet, bool resetStrategies = false);
+    // Handles the packet right away if its handler is thread-safe in this build, else queues it with QueueWorldPacket.
+    // Returns false if it was queued.
+    bool HandleOrQueueWorldPacket(WorldPacket* packet);
+    void OnWorldPacketsHandled();
     void ChangeEngine(BotState type);
     void DoNextAction();
     void DoSpecificAction(std::string name);
@@ -188,6 +195,7 @@ protected:
     PacketHandlingHelper masterOutgoingPacketHandlers;
     CompositeChatFilter chatFilter;
     PlayerbotSecurity security;
+    bool resetStrategiesOnWorldPackets;
 };
 
 class TC_GAME_API PlayerbotTestingAI : public PlayerbotAI
@@ -35,7 +35,10 @@ void PlayerbotHolder::UpdateSessions(uint32 elapsed)
         }
         else if (bot->IsInWorld())
         {
-            bot->GetSession()->HandleBotPackets();
+            // thread-safe packets are handled by the bot map update
+            WorldSessionFilter updater(bot->GetSession());
+            if (bot->GetSession()->HandleBotPackets(updater))
+                bot->GetPlayerbotAI()->OnWorldPacketsHandled();
         }
     }
 }
@@ -113,10 +116,10 @@ void PlayerbotHolder::OnBotLogin(Player * const bot, bool testingBot)
 
         if (!groupValid)
         {
-            WorldPacket p;
+            WorldPacket* p = new WorldPacket(CMSG_GROUP_DISBAND);
             std::string member = bot->GetName();
-            p << uint32(PARTY_OP_LEAVE) << member << uint32(0);
-            bot->GetSession()->HandleGroupDisbandOpcode(p);
+            *p << uint32(PARTY_OP_LEAVE) << member << uint32(0);
+            ai->QueueWorldPacket(p, true);
         }
     }
 
@@ -219,6 +219,7 @@ void RandomPlayerbotFactory::CreateRandomBots()
         }
 
         CharacterDatabase.Execute("DELETE FROM ai_playerbot_random_bots");
+        sRandomPlayerbotMgr.ResetEventValues();
         sLog->outMessage("playerbot", LOG_LEVEL_INFO, "Random bot accounts deleted");
     }
 
@@ -13,7 +13,7 @@
 #include "TestPlayer.h"
 #endif
 
-RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0)
+RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0), eventValuesLoaded(false)
 {
 }
 
@@ -73,6 +73,8 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed)
 
     if (processTicks++ == 1)
         PrintStats();
+
+    SaveEventValues();
 }
 
 uint32 RandomPlayerbotMgr::AddRandomBot(bool alliance)
@@ -475,17 +477,12 @@ std::list<uint32> RandomPlayerbotMgr::GetBots()
 {
     list<uint32> bots;
 
-    QueryResult results = CharacterDatabase.Query(
-            "select bot from ai_playerbot_random_bots where owner = 0 and event = 'add'");
-
-    if (results)
     {
-        do
-        {
-            Field* fields = results->Fetch();
-            uint32 bot = uint32(fields[0].GetUInt64());
-            bots.push_back(bot);
-        } while (results->NextRow());
+        std::lock_guard<std::mutex> lock(eventValuesLock);
+        LoadEventValues();
+        for (auto const& botEvents : eventValues)
+            if (botEvents.second.count("add"))
+                bots.push_back(botEvents.first);
     }
 
     //add data to player global data if not existing yet
@@ -516,17 +513,12 @@ vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
 {
     set<uint32> bots;
 
-    QueryResult results = CharacterDatabase.PQuery(
-            "select `bot` from ai_playerbot_random_bots where event = 'add'");
-
-    if (results)
     {
-        do
-        {
-            Field* fields = results->Fetch();
-            uint32 bot = uint64(fields[0].GetUInt64());
-            bots.insert(bot);
-        } while (results->NextRow());
+        std::lock_guard<std::mutex> lock(eventValuesLock);
+        LoadEventValues();
+        for (auto const& botEvents : eventValues)
+            if (botEvents.second.count("add"))
+                bots.insert(botEvents.first);
     }
 
     vector<uint32> guids;
@@ -556,41 +548,142 @@ vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
     return guids;
 }
 
-uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string event)
+void RandomPlayerbotMgr::LoadEventValues()
 {
-    uint64 value = 0;
+    if (eventValuesLoaded)
+        return;
 
-    QueryResult results = CharacterDatabase.PQuery(
-            "select `value`, `time`, validIn from ai_playerbot_random_bots where owner = 0 and bot = '%u' and event = '%s'",
-            bot, event.c_str());
+    eventValuesLoaded = true;
+
+    QueryResult results = CharacterDatabase.Query(
+            "select bot, event, `value`, `time`, validIn from ai_playerbot_random_bots where owner = 0");
 
     if (results)
     {
-        Field* fields = results->Fetch();
-        value = fields[0].GetUInt64();
-        uint64 lastChangeTime = fields[1].GetUInt64();
-        uint64 validIn = fields[2].GetUInt64();
-        if ((time(0) - lastChangeTime) >= validIn)
-            value = 0;
+        do
+        {
+            Field* fields = results->Fetch();
+            BotEventValue& eventValue = eventValues[fields[0].GetUInt32()][fields[1].GetString()];
+            eventValue.value = fields[2].GetUInt32();
+            eventValue.lastChangeTime = fields[3].GetUInt32();
+            eventValue.validIn = fields[4].GetUInt32();
+        } while (results->NextRow());
     }
 
-    return value;
+    sLog->outMessage("playerbot", LOG_LEVEL_INFO, "%u random bots events loaded", uint32(results ? results->GetRowCount() : 0));
+}
+
+void RandomPlayerbotMgr::ResetEventValues()
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+
+    eventValues.clear();
+    changedEventValues.clear();
+    eventValuesLoaded = true;
+}
+
+uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string event)
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+
+    LoadEventValues();
+
+    auto botEvents = eventValues.find(bot);
+    if (botEvents == eventValues.end())
+        return 0;
+
+    auto itr = botEvents->second.find(event);
+    if (itr == botEvents->second.end())
+        return 0;
+
+    BotEventValue const& eventValue = itr->second;
+    if ((time(0) - eventValue.lastChangeTime) >= eventValue.validIn)
+        return 0;
+
+    return eventValue.value;
 }
 
 uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, std::string event, uint32 value, uint32 validIn)
 {
-    CharacterDatabase.PExecute("delete from ai_playerbot_random_bots where owner = 0 and bot = '%u' and event = '%s'",
-            bot, event.c_str());
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+
+    LoadEventValues();
+
     if (value)
     {
-        CharacterDatabase.PExecute(
-                "insert into ai_playerbot_random_bots (owner, bot, `time`, validIn, event, `value`) values ('%u', '%u', '%u', '%u', '%s', '%u')",
-                0, bot, (uint32)time(0), validIn, event.c_str(), value);
+        BotEventValue& eventValue = eventValues[bot][event];
+        eventValue.value = value;
+        eventValue.lastChangeTime = uint32(time(0));
+        eventValue.validIn = validIn;
+    }
+    else
+    {
+        auto botEvents = eventValues.find(bot);
+        if (botEvents != eventValues.end())
+        {
+            botEvents->second.erase(event);
+            if (botEvents->second.empty())
+                eventValues.erase(botEvents);
+        }
     }
 
+    changedEventValues.insert(make_pair(bot, event));
     return value;
 }
 
+void RandomPlayerbotMgr::SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn)
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+
+    LoadEventValues();
+
+    auto botEvents = eventValues.find(bot);
+    if (botEvents == eventValues.end())
+        return;
+
+    auto itr = botEvents->second.find(event);
+    if (itr == botEvents->second.end())
+        return;
+
+    itr->second.validIn = validIn;
+    changedEventValues.insert(make_pair(bot, event));
+}
+
+void RandomPlayerbotMgr::SaveEventValues()
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+
+    if (changedEventValues.empty())
+        return;
+
+    // only the last value of each event is written, no matter how many times it changed since last save
+    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    for (auto const& changed : changedEventValues)
+    {
+        uint32 bot = changed.first;
+        std::string const& event = changed.second;
+        trans->PAppend("delete from ai_playerbot_random_bots where owner = 0 and bot = '%u' and event = '%s'",
+                bot, event.c_str());
+
+        auto botEvents = eventValues.find(bot);
+        if (botEvents == eventValues.end())
+            continue;
+
+        auto itr = botEvents->second.find(event);
+        if (itr == botEvents->second.end())
+            continue;
+
+        BotEventValue const& eventValue = itr->second;
+        trans->PAppend(
+                "insert into ai_playerbot_random_bots (owner, bot, `time`, validIn, event, `value`) values ('%u', '%u', '%u', '%u', '%s', '%u')",
+                0, bot, eventValue.lastChangeTime, eventValue.validIn, event.c_str(), eventValue.value);
+    }
+    CharacterDatabase.CommitTransaction(trans);
+
+    sLog->outMessage("playerbot", LOG_LEVEL_DEBUG, "%u random bots events saved", uint32(changedEventValues.size()));
+    changedEventValues.clear();
+}
+
 bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, char const* args)
 {
     if (!sPlayerbotAIConfig.enabled)
@@ -610,6 +703,7 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
     if (cmd == "reset")
     {
         CharacterDatabase.PExecute("delete from ai_playerbot_random_bots");
+        sRandomPlayerbotMgr.ResetEventValues();
         sLog->outMessage("playerbot", LOG_LEVEL_INFO, "Random bots were reset for all players. Please restart the Server.");
         return true;
     }
@@ -656,13 +750,12 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
                         sRandomPlayerbotMgr.IncreaseLevel(bot);
                     }
                     uint32 randomTime = urand(sPlayerbotAIConfig.minRandomBotRandomizeTime, sPlayerbotAIConfig.maxRandomBotRandomizeTime);
-                    CharacterDatabase.PExecute("update ai_playerbot_random_bots set validIn = '%u' where event = 'randomize' and bot = '%u'",
-                            randomTime, bot->GetGUID().GetCounter());
-                    CharacterDatabase.PExecute("update ai_playerbot_random_bots set validIn = '%u' where event = 'logout' and bot = '%u'",
-                            sPlayerbotAIConfig.maxRandomBotInWorldTime, bot->GetGUID().GetCounter());
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUID().GetCounter(), "randomize", randomTime);
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUID().GetCounter(), "logout", sPlayerbotAIConfig.maxRandomBotInWorldTime);
                 } while (results->NextRow());
             }
         }
+        sRandomPlayerbotMgr.SaveEventValues();
         return true;
     }
     else
@@ -5,6 +5,10 @@
 #include "PlayerbotAIBase.h"
 #include "PlayerbotMgr.h"
 
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
 class WorldLocation;
 class WorldPacket;
 class Player;
@@ -48,13 +52,27 @@ class TC_GAME_API RandomPlayerbotMgr : public PlayerbotHolder
         uint32 GetTradeDiscount(Player* bot);
         void Refresh(Player* bot);
         void RandomTeleportForLevel(Player* bot);
+        // Write event values changed since last save to the database, in one asynchronous transaction
+        void SaveEventValues();
+        // Forget all event values, to be called when ai_playerbot_random_bots is emptied
+        void ResetEventValues();
 
     protected:
         void OnBotLoginInternal(Player * const bot) override {}
 
     private:
+        struct BotEventValue
+        {
+            uint32 value;
+            uint32 lastChangeTime;
+            uint32 validIn;
+        };
+        typedef unordered_map<std::string, BotEventValue> BotEventValues;
+
+        void LoadEventValues(); // eventValuesLock must be held
         uint32 GetEventValue(uint32 bot, std::string event);
         uint32 SetEventValue(uint32 bot, std::string event, uint32 value, uint32 validIn);
+        void SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn);
         list<uint32> GetBots();
         vector<uint32> GetFreeBots(bool alliance);
         bool ProcessBot(uint32 bot);
@@ -67,6 +85,13 @@ class TC_GAME_API RandomPlayerbotMgr : public PlayerbotHolder
     private:
         vector<Player*> players;
         int processTicks;
+
+        // ai_playerbot_random_bots content, loaded at first use. Changes are written by SaveEventValues.
+        // Bots AI read and write them from map threads, guarded by eventValuesLock.
+        unordered_map<uint32, BotEventValues> eventValues;
+        set<pair<uint32, std::string>> changedEventValues;
+        bool eventValuesLoaded;
+        std::mutex eventValuesLock;
 };
 
 //extra ifdef to make sure we don't try to include the playerbot mgr if playerbot are disabled
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 
 namespace ai
 {
@@ -68,10 +69,11 @@ namespace ai
 
         std::shared_ptr<T> create(std::string name, PlayerbotAI* ai)
         {
-            if (created.find(name) == created.end())
+            auto found = created.find(name);
+            if (found == created.end())
                 return created[name] = NamedObjectFactory<T>::create(name, ai);
 
-            return created[name];
+            return found->second;
         }
 
         virtual ~NamedObjectContext()
@@ -86,7 +88,7 @@ namespace ai
 
         void Update()
         {
-            for (typename map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
+            for (typename unordered_map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
             {
                 if (i->second)
                     i->second->Update();
@@ -95,7 +97,7 @@ namespace ai
 
         void Reset()
         {
-            for (typename map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
+            for (typename unordered_map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
             {
                 if (i->second)
                     i->second->Reset();
@@ -114,7 +116,7 @@ namespace ai
         }
 
     protected:
-        map<string, std::shared_ptr<T>> created;
+        unordered_map<string, std::shared_ptr<T>> created;
         bool shared;
         bool supportsSiblings;
     };
@@ -135,16 +137,28 @@ namespace ai
         void Add(NamedObjectContext<T>* context)
         {
             contexts.push_back(context);
+            resolved.clear();
         }
 
-        std::shared_ptr<T> GetObject(std::string name, PlayerbotAI* ai)
+        // Resolved names are remembered so a lookup costs a single hash instead of a scan of every context
+        std::shared_ptr<T> GetObject(std::string const& name, PlayerbotAI* ai)
         {
+            auto found = resolved.find(name);
+            if (found != resolved.end())
+                return found->second;
+
+            std::shared_ptr<T> result = nullptr;
             for (auto i = contexts.begin(); i != contexts.end(); i++)
             {
                 std::shared_ptr<T> object = (*i)->create(name, ai);
-                if (object) return object;
+                if (object)
+                {
+                    result = object;
+                    break;
+                }
             }
-            return nullptr;
+            resolved[name] = result;
+            return result;
         }
 
         void Update()
@@ -213,6 +227,7 @@ namespace ai
 
     private:
         list<NamedObjectContext<T>*> contexts;
+        unordered_map<string, std::shared_ptr<T>> resolved;
     };
 
     template <class T> class NamedObjectFactoryList
@@ -31,15 +31,14 @@ namespace ai
                 return false;
             }
 
-            WorldPacket p;
+            WorldPacket* p = new WorldPacket(CMSG_GROUP_ACCEPT);
             uint32 roles_mask = 0;
-            p << roles_mask;
-            bot->GetSession()->HandleGroupAcceptOpcode(p);
+            *p << roles_mask;
+            ai->QueueWorldPacket(p, true);
 
             if (sRandomPlayerbotMgr.IsRandomBot(bot))
                 bot->GetPlayerbotAI()->SetMaster(inviter);
 
-            ai->ResetStrategies();
             ai->TellMaster("Hello");
             return true;
         }
@@ -20,10 +20,9 @@ bool ReachAreaTriggerAction::Execute(Event event)
     AreaTrigger const* at = sObjectMgr->GetAreaTrigger(triggerId);
     if (!at)
     {
-        WorldPacket p1(CMSG_AREATRIGGER);
-        p1 << triggerId;
-        p1.rpos(0);
-        bot->GetSession()->HandleAreaTriggerOpcode(p1);
+        WorldPacket* p1 = new WorldPacket(CMSG_AREATRIGGER);
+        *p1 << triggerId;
+        ai->HandleOrQueueWorldPacket(p1);
 
         return true;
     }
@@ -70,10 +69,9 @@ bool AreaTriggerAction::Execute(Event event)
     MotionMaster &mm = *bot->GetMotionMaster();
     mm.Clear();
 
-    WorldPacket p(CMSG_AREATRIGGER);
-    p << triggerId;
-    p.rpos(0);
-    bot->GetSession()->HandleAreaTriggerOpcode(p);
+    WorldPacket* p = new WorldPacket(CMSG_AREATRIGGER);
+    *p << triggerId;
+    ai->HandleOrQueueWorldPacket(p);
 
     ai->TellMaster("Hello");
     return true;
@@ -7,11 +7,9 @@ using namespace ai;
 
 bool CheckMailAction::Execute(Event event)
 {
+    // mails are loaded by the world thread, they are processed by a later check
     if (!bot->IsMailsLoaded())
-    {
-        WorldPacket p;
-        bot->GetSession()->HandleQueryNextMailTime(p);
-    }
+        ai->QueueWorldPacket(new WorldPacket(MSG_QUERY_NEXT_MAIL_TIME));
 
     if (!bot->GetMailSize())
         return false;
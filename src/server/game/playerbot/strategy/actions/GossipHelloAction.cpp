@@ -38,6 +38,7 @@ bool GossipHelloAction::Execute(Event event)
     if (pMenuItemBounds.first == pMenuItemBounds.second)
         return false;
 
+    // called directly even where the handler is thread-unsafe (LICH_KING): the menu is walked right after, like gossip select below
     WorldPacket p1;
     p1 << guid;
     bot->GetSession()->HandleGossipHelloOpcode(p1);
@@ -28,15 +28,14 @@ bool GuildAcceptAction::Execute(Event event)
         accept = false;
     }
 
-    WorldPacket packet;
     if (accept)
     {
         bot->SetGuildIdInvited(guildId);
-        bot->GetSession()->HandleGuildAcceptOpcode(packet);
+        ai->QueueWorldPacket(new WorldPacket(CMSG_GUILD_ACCEPT));
     }
     else
     {
-        bot->GetSession()->HandleGuildDeclineOpcode(packet);
+        ai->QueueWorldPacket(new WorldPacket(CMSG_GUILD_DECLINE));
     }
     return true;
 }
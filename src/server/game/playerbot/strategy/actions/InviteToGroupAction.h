@@ -15,11 +15,11 @@ namespace ai
             if (!master)
                 return false;
 
-            WorldPacket p;
+            WorldPacket* p = new WorldPacket(CMSG_GROUP_INVITE);
             uint32 roles_mask = 0;
-            p << master->GetName();
-            p << roles_mask;
-            bot->GetSession()->HandleGroupInviteOpcode(p);
+            *p << master->GetName();
+            *p << roles_mask;
+            ai->QueueWorldPacket(p);
 
             return true;
         }
@@ -17,10 +17,10 @@ namespace ai
             ai->TellMaster("Goodbye!", PLAYERBOT_SECURITY_TALK);
 
             //SMSG_PARTY_COMMAND_RESULT
-            WorldPacket p;
+            WorldPacket* p = new WorldPacket(CMSG_GROUP_DISBAND);
             std::string member = bot->GetName();
-            p << uint32(PARTY_OP_LEAVE) << member << uint32(PARTY_RESULT_OK);
-            bot->GetSession()->HandleGroupDisbandOpcode(p);
+            *p << uint32(PARTY_OP_LEAVE) << member << uint32(PARTY_RESULT_OK);
+            ai->QueueWorldPacket(p, true);
 
             if (sRandomPlayerbotMgr.IsRandomBot(bot))
             {
@@ -29,7 +29,6 @@ namespace ai
                 sRandomPlayerbotMgr.SetLootAmount(bot, 0);
             }
 
-            ai->ResetStrategies();
             return true;
         }
     };
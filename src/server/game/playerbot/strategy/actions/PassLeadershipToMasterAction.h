@@ -14,9 +14,9 @@ namespace ai
             if (master && bot->GetGroup() && bot->GetGroup()->IsMember(master->GetGUID()))
             {
                 //BC+LK ok
-                WorldPacket p(CMSG_GROUP_SET_LEADER, 8);
-                p << master->GetGUID();
-                bot->GetSession()->HandleGroupSetLeaderOpcode(p);
+                WorldPacket* p = new WorldPacket(CMSG_GROUP_SET_LEADER, 8);
+                *p << master->GetGUID();
+                ai->QueueWorldPacket(p);
                 return true;
             }
 
@@ -91,11 +91,15 @@ bool QuestAction::AcceptQuest(Quest const* quest, uint64 questGiver)
 
     else
     {
-        WorldPacket p(CMSG_QUESTGIVER_ACCEPT_QUEST);
+        WorldPacket* p = new WorldPacket(CMSG_QUESTGIVER_ACCEPT_QUEST);
         uint32 unk1 = 0;
-        p << questGiver << questId << unk1;
-        p.rpos(0);
-        bot->GetSession()->HandleQuestgiverAcceptQuestOpcode(p);
+        *p << questGiver << questId << unk1;
+        if (!ai->HandleOrQueueWorldPacket(p))
+        {
+            out << "Accepting " << chat->formatQuest(quest);
+            ai->TellMaster(out);
+            return true;
+        }
 
         if (bot->GetQuestStatus(questId) != QUEST_STATUS_NONE)
         {
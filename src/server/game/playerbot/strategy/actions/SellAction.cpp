@@ -86,9 +86,9 @@ void SellAction::Sell(Item* item)
     ObjectGuid itemguid = ObjectGuid(item->GetGUID());
     uint32 count = item->GetCount();
 
-    WorldPacket p;
-    p << vendor->GetGUID() << itemguid << count;
-    bot->GetSession()->HandleSellItemOpcode(p);
+    WorldPacket* p = new WorldPacket(CMSG_SELL_ITEM);
+    *p << vendor->GetGUID() << itemguid << count;
+    ai->HandleOrQueueWorldPacket(p);
 
     std::ostringstream out; out << chat->formatItem(item->GetTemplate()) << " sold";
     ai->TellMaster(out);
@@ -40,11 +40,9 @@ bool TeleportAction::Execute(Event event)
     LastMovement& movement = context->GetValue<LastMovement&>("last movement")->Get();
     if (movement.lastAreaTrigger)
     {
-        WorldPacket p(CMSG_AREATRIGGER);
-        p << movement.lastAreaTrigger;
-        p.rpos(0);
-
-        bot->GetSession()->HandleAreaTriggerOpcode(p);
+        WorldPacket* p = new WorldPacket(CMSG_AREATRIGGER);
+        *p << movement.lastAreaTrigger;
+        ai->HandleOrQueueWorldPacket(p);
         movement.lastAreaTrigger = 0;
         return true;
     }
@@ -14,6 +14,18 @@ using namespace ai;
 
 bool TradeStatusAction::Execute(Event event)
 {
+    WorldPacket p(event.getPacket());
+    p.rpos(0);
+    uint32 status;
+    p >> status;
+
+    // the trade is completed by the world thread, the trader is already gone
+    if (status == TRADE_STATUS_TRADE_COMPLETE)
+    {
+        CompleteTrade();
+        return true;
+    }
+
     Player* trader = bot->GetTrader();
     Player* master = GetMaster();
     if (!trader)
@@ -26,48 +38,30 @@ bool TradeStatusAction::Execute(Event event)
 
     if (trader != master || !ai->GetSecurity()->CheckLevelFor(PLAYERBOT_SECURITY_ALLOW_ALL, true, master))
     {
-        WorldPacket p;
-        uint32 status = 0;
-        p << status;
-        bot->GetSession()->HandleCancelTradeOpcode(p);
+        WorldPacket* packet = new WorldPacket(CMSG_CANCEL_TRADE, 4);
+        *packet << uint32(0);
+        ai->QueueWorldPacket(packet);
         return false;
     }
 
-    WorldPacket p(event.getPacket());
-    p.rpos(0);
-    uint32 status;
-    p >> status;
-
     if (status == TRADE_STATUS_TRADE_ACCEPT)
     {
-        WorldPacket _p;
-        status = 0;
-        _p << status;
-
         if (CheckTrade())
         {
-            int32 botMoney = CalculateCost(bot->GetTradeData(), true);
-
-            map<uint32, uint32> itemIds;
+            // accounted when the world thread reports the trade as complete
+            acceptedMoney = CalculateCost(bot->GetTradeData(), true);
+            acceptedItemIds.clear();
             for (uint32 slot = 0; slot < TRADE_SLOT_TRADED_COUNT; ++slot)
             {
                 Item* item = master->GetTradeData()->GetItem((TradeSlots)slot);
                 if (item)
-                    itemIds[item->GetTemplate()->ItemId] += item->GetCount();
+                    acceptedItemIds[item->GetTemplate()->ItemId] += item->GetCount();
             }
+            hasAcceptedTrade = true;
 
-            bot->GetSession()->HandleAcceptTradeOpcode(_p);
-            if (bot->GetTradeData())
-                return false;
-
-            for (map<uint32, uint32>::iterator i = itemIds.begin(); i != itemIds.end(); ++i)
-                sGuildTaskMgr.CheckItemTask(i->first, i->second, master, bot);
-
-            if (sRandomPlayerbotMgr.IsRandomBot(bot))
-            {
-                int32 lootAmount = sRandomPlayerbotMgr.GetLootAmount(bot);
-                sRandomPlayerbotMgr.SetLootAmount(bot, max(0, lootAmount - botMoney * 10));
-            }
+            WorldPacket* packet = new WorldPacket(CMSG_ACCEPT_TRADE, 4);
+            *packet << uint32(0);
+            ai->QueueWorldPacket(packet);
             return true;
         }
     }
@@ -82,10 +76,31 @@ bool TradeStatusAction::Execute(Event event)
 }
 
 
+void TradeStatusAction::CompleteTrade()
+{
+    if (!hasAcceptedTrade)
+        return;
+
+    hasAcceptedTrade = false;
+
+    Player* master = GetMaster();
+    if (!master)
+        return;
+
+    for (map<uint32, uint32>::iterator i = acceptedItemIds.begin(); i != acceptedItemIds.end(); ++i)
+        sGuildTaskMgr.CheckItemTask(i->first, i->second, master, bot);
+
+    if (sRandomPlayerbotMgr.IsRandomBot(bot))
+    {
+        int32 lootAmount = sRandomPlayerbotMgr.GetLootAmount(bot);
+        sRandomPlayerbotMgr.SetLootAmount(bot, max(0, lootAmount - acceptedMoney * 10));
+    }
+}
+
 void TradeStatusAction::BeginTrade()
 {
-    WorldPacket p;
-    bot->GetSession()->HandleBeginTradeOpcode(p);
+    hasAcceptedTrade = false;
+    ai->QueueWorldPacket(new WorldPacket(CMSG_BEGIN_TRADE));
 
     ListItemsVisitor visitor;
     IterateItems(&visitor);
@@ -10,12 +10,18 @@ namespace ai
     class TradeStatusAction : public QueryItemUsageAction
     {
     public:
-        TradeStatusAction(PlayerbotAI* ai) : QueryItemUsageAction(ai, "accept trade") {}
+        TradeStatusAction(PlayerbotAI* ai) : QueryItemUsageAction(ai, "accept trade"), hasAcceptedTrade(false), acceptedMoney(0) {}
         virtual bool Execute(Event event);
 
     private:
         void BeginTrade();
+        void CompleteTrade();
         bool CheckTrade();
         int32 CalculateCost(TradeData* data, bool sell);
+
+        // the accept is handled by the world thread, what the bot agreed to is accounted once the trade completes
+        bool hasAcceptedTrade;
+        int32 acceptedMoney;
+        map<uint32, uint32> acceptedItemIds;
     };
 }
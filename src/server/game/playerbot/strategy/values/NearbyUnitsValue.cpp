@@ -0,0 +1,31 @@
+
+#include "../../playerbot.h"
+#include "NearbyUnitsValue.h"
+
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "CellImpl.h"
+
+using namespace ai;
+using namespace Trinity;
+
+class AnyUnitInVisitedCellsCheck
+{
+public:
+    bool operator()(Unit* u) { return true; }
+};
+
+list<ObjectGuid> NearbyUnitsValue::Calculate()
+{
+    list<Unit*> targets;
+
+    AnyUnitInVisitedCellsCheck u_check;
+    UnitListSearcher<AnyUnitInVisitedCellsCheck> searcher(bot, targets, u_check);
+    Cell::VisitAllObjects(bot, searcher, bot->GetMap()->GetVisibilityRange());
+
+    list<ObjectGuid> result;
+    for (list<Unit*>::iterator i = targets.begin(); i != targets.end(); ++i)
+        result.push_back((*i)->GetGUID());
+
+    return result;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "../Value.h"
+
+namespace ai
+{
+    // Every unit in the visited grid cells, searched once per tick and shared by the nearest units values
+    class NearbyUnitsValue : public ObjectGuidListCalculatedValue
+    {
+    public:
+        NearbyUnitsValue(PlayerbotAI* ai) :
+            ObjectGuidListCalculatedValue(ai, "nearby units", 1) {}
+
+    protected:
+        virtual list<ObjectGuid> Calculate();
+    };
+}
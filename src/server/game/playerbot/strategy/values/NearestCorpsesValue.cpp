@@ -3,8 +3,6 @@
 #include "NearestCorpsesValue.h"
 
 #include "GridNotifiers.h"
-#include "GridNotifiersImpl.h"
-#include "CellImpl.h"
 
 using namespace ai;
 using namespace Trinity;
@@ -26,8 +24,7 @@ private:
 void NearestCorpsesValue::FindUnits(list<Unit*> &targets)
 {
     AnyDeadUnitInObjectRangeCheck u_check(bot, range);
-    UnitListSearcher<AnyDeadUnitInObjectRangeCheck> searcher(bot, targets, u_check);
-    Cell::VisitAllObjects(bot, searcher, bot->GetMap()->GetVisibilityRange());
+    FindNearbyUnits(targets, u_check);
 }
 
 bool NearestCorpsesValue::AcceptUnit(Unit* unit)
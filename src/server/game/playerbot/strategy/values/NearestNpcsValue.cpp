@@ -3,8 +3,6 @@
 #include "NearestNpcsValue.h"
 
 #include "GridNotifiers.h"
-#include "GridNotifiersImpl.h"
-#include "CellImpl.h"
 
 
 using namespace ai;
@@ -13,8 +11,7 @@ using namespace Trinity;
 void NearestNpcsValue::FindUnits(list<Unit*> &targets)
 {
     AnyFriendlyUnitInObjectRangeCheck u_check(bot, bot, range);
-    UnitListSearcher<AnyFriendlyUnitInObjectRangeCheck> searcher(bot, targets, u_check);
-    Cell::VisitAllObjects(bot, searcher, bot->GetMap()->GetVisibilityRange());
+    FindNearbyUnits(targets, u_check);
 }
 
 bool NearestNpcsValue::AcceptUnit(Unit* unit)
@@ -30,6 +30,19 @@ namespace ai
         virtual void FindUnits(list<Unit*> &targets) = 0;
         virtual bool AcceptUnit(Unit* unit) = 0;
 
+        // Filters the units found by the shared "nearby units" search instead of visiting the grid again
+        template<class Check>
+        void FindNearbyUnits(list<Unit*> &targets, Check& check)
+        {
+            list<ObjectGuid> nearby = context->GetValue<list<ObjectGuid> >("nearby units")->Get();
+            for (list<ObjectGuid>::iterator i = nearby.begin(); i != nearby.end(); ++i)
+            {
+                Unit* unit = ai->GetUnit(*i);
+                if (unit && check(unit))
+                    targets.push_back(unit);
+            }
+        }
+
     protected:
         float range;
     };
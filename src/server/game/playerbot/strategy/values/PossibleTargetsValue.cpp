@@ -3,8 +3,6 @@
 #include "PossibleTargetsValue.h"
 
 #include "GridNotifiers.h"
-#include "GridNotifiersImpl.h"
-#include "CellImpl.h"
 
 using namespace ai;
 using namespace Trinity;
@@ -12,8 +10,7 @@ using namespace Trinity;
 void PossibleTargetsValue::FindUnits(list<Unit*> &targets)
 {
     AnyUnfriendlyUnitInObjectRangeCheck u_check(bot, bot, range);
-    UnitListSearcher<AnyUnfriendlyUnitInObjectRangeCheck> searcher(bot, targets, u_check);
-    Cell::VisitAllObjects(bot, searcher, bot->GetMap()->GetVisibilityRange());
+    FindNearbyUnits(targets, u_check);
 }
 
 bool PossibleTargetsValue::AcceptUnit(Unit* unit)
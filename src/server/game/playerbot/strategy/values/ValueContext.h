@@ -2,6 +2,7 @@
 
 #include "NearestGameObjects.h"
 #include "LogLevelValue.h"
+#include "NearbyUnitsValue.h"
 #include "NearestNpcsValue.h"
 #include "PossibleTargetsValue.h"
 #include "NearestAdsValue.h"
@@ -64,6 +65,7 @@ namespace ai
         ValueContext()
         {
             creators["nearest game objects"] = &ValueContext::nearest_game_objects;
+            creators["nearby units"] = &ValueContext::nearby_units;
             creators["nearest npcs"] = &ValueContext::nearest_npcs;
             creators["possible targets"] = &ValueContext::possible_targets;
             creators["nearest adds"] = &ValueContext::nearest_adds;
@@ -191,6 +193,7 @@ namespace ai
         static std::shared_ptr<UntypedValue> has_mana(PlayerbotAI* ai) { return std::make_shared<HasManaValue>(ai); }
         static std::shared_ptr<UntypedValue> nearest_game_objects(PlayerbotAI* ai) { return std::make_shared<NearestGameObjects>(ai); }
         static std::shared_ptr<UntypedValue> log_level(PlayerbotAI* ai) { return std::make_shared<LogLevelValue>(ai); }
+        static std::shared_ptr<UntypedValue> nearby_units(PlayerbotAI* ai) { return std::make_shared<NearbyUnitsValue>(ai); }
         static std::shared_ptr<UntypedValue> nearest_npcs(PlayerbotAI* ai) { return std::make_shared<NearestNpcsValue>(ai); }
         static std::shared_ptr<UntypedValue> nearest_corpses(PlayerbotAI* ai) { return std::make_shared<NearestCorpsesValue>(ai); }
         static std::shared_ptr<UntypedValue> possible_targets(PlayerbotAI* ai) { return std::make_shared<PossibleTargetsValue>(ai); }
@@ -225,7 +225,7 @@ public:
         handler->PSendSysMessage("mmap stats:");
 
         MMAP::MMapManager *manager = MMAP::MMapFactory::createOrGetMMapManager();
-        handler->PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
+        handler->PSendSysMessage(" %u maps loaded with %u tiles overall (%u mapped from files)", manager->getLoadedMapsCount(), manager->getLoadedTilesCount(), manager->getMappedTilesCount());
 
         const dtNavMesh* navmesh = manager->GetNavMesh(handler->GetSession()->GetPlayer()->GetMapId());
         if (!navmesh)
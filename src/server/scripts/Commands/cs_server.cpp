@@ -14,6 +14,9 @@
 #include "UpdateTime.h"
 #include "WorldSession.h"
 #include "Player.h"
+#include "MapManager.h"
+#include "AuctionHouseMgr.h"
+#include "WorldSocketMgr.h"
 
 #include <boost/filesystem.hpp>
 #include <openssl/crypto.h>
@@ -53,16 +56,25 @@ public:
         };
         static std::vector<ChatCommand> serverCommandTable =
         {
+            { "auctionsearch",  SEC_GAMEMASTER3,     true, &HandleServerAuctionSearchCommand, "" },
+            { "compression",    SEC_GAMEMASTER3,     true, &HandleServerCompressionCommand,   "" },
             { "corpses",        SEC_GAMEMASTER2,     true, &HandleServerCorpsesCommand,       "" },
             { "debug",          SEC_PLAYER,          true, &HandleServerDebugCommand,         "" },
             { "exit",           SEC_ADMINISTRATOR,   true, &HandleServerExitCommand,          "" },
+            { "gridpreload",    SEC_GAMEMASTER3,     true, &HandleServerGridPreloadCommand,   "" },
             { "idlerestart",    SEC_ADMINISTRATOR,   true,  nullptr,                          "", serverIdleRestartCommandTable },
             { "idleshutdown",   SEC_ADMINISTRATOR,   true,  nullptr,                          "", serverShutdownCommandTable },
             { "info",           SEC_PLAYER,          true,  &HandleServerInfoCommand,         "" },
+            { "logqueue",       SEC_GAMEMASTER3,     true, &HandleServerLogQueueCommand,      "" },
+            { "loscache",       SEC_GAMEMASTER3,     true, &HandleServerLosCacheCommand,      "" },
+            { "mapworkers",     SEC_GAMEMASTER3,     true,  &HandleServerMapWorkersCommand,   "" },
             { "motd",           SEC_PLAYER,          true,  &HandleServerMotdCommand,         "" },
+            { "network",        SEC_GAMEMASTER3,     true,  &HandleServerNetworkCommand,      "" },
             { "restart",        SEC_ADMINISTRATOR,   true,  nullptr,                          "", serverRestartCommandTable },
             { "shutdown",       SEC_ADMINISTRATOR,   true,  nullptr,                          "", serverShutdownCommandTable },
             { "set",            SEC_ADMINISTRATOR,   true,  nullptr,                          "", serverSetCommandTable },
+            { "spellmodcache",  SEC_GAMEMASTER3,     true, &HandleServerSpellModCacheCommand, "" },
+            { "ticks",          SEC_GAMEMASTER3,     true,  &HandleServerTicksCommand,        "" },
         };
         static std::vector<ChatCommand> commandTable =
         {
@@ -71,6 +83,19 @@ public:
         return commandTable;
     }
 
+    /// Display auction house browse queries counters, and those of selected player if any
+    static bool HandleServerAuctionSearchCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        AuctionSearcher& searcher = sAuctionMgr->GetSearcher();
+        handler->PSendSysMessage("Auction searches: " UI64FMTD ", ignored by rate limit: " UI64FMTD ", currently queued: %u (%s)",
+            searcher.GetSearchCount(), searcher.GetThrottledCount(), searcher.GetQueuedCount(), searcher.activated() ? "threaded" : "world thread");
+
+        if (Player* target = handler->GetSelectedPlayer())
+            handler->PSendSysMessage("%s: %u searches, %u ignored by rate limit", target->GetName().c_str(),
+                target->GetSession()->GetAuctionSearchCount(), target->GetSession()->GetAuctionSearchThrottledCount());
+        return true;
+    }
+
     /// Triggering corpses expire check in world
     static bool HandleServerCorpsesCommand(ChatHandler* handler, char const* /*args*/)
     {
@@ -243,6 +268,133 @@ public:
         return true;
     }
 
+    static bool HandleServerMapWorkersCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        std::vector<MapWorkerUsage> usage = sMonitor->GetMapWorkersUsage();
+        if (usage.empty())
+        {
+            handler->SendSysMessage("No map workers usage available (map updater disabled, monitoring disabled or not enough data yet).");
+            return true;
+        }
+
+        for (MapWorkerUsage const& worker : usage)
+            handler->PSendSysMessage("Worker %u: %u%% busy, %u updates, %u steals, %u queued", worker.workerId, worker.busyPct, worker.updates, worker.steals, worker.queueSize);
+
+        return true;
+    }
+
+    static bool HandleServerCompressionCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        UpdateCompressionStats stats = sMonitor->GetUpdateCompressionStats();
+        if (!stats.packets)
+        {
+            handler->SendSysMessage("No update packet compressed yet.");
+            return true;
+        }
+
+        handler->PSendSysMessage("Compressed update packets: " UI64FMTD ", " UI64FMTD " bytes in, " UI64FMTD " bytes out (%.1f%%)", stats.packets, stats.bytesIn, stats.bytesOut, stats.bytesIn ? float(stats.bytesOut) * 100.0f / float(stats.bytesIn) : 0.0f);
+        handler->PSendSysMessage("Time spent compressing: " UI64FMTD " ms (%.1f us per packet)", stats.time / 1000, float(stats.time) / float(stats.packets));
+        return true;
+    }
+
+    /// Display packet payload bytes copied to or shared between sockets write queues, and network threads write stats
+    static bool HandleServerNetworkCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        std::vector<NetworkThreadStats> threadsStats = sWorldSocketMgr.GetNetworkThreadsStats();
+        for (size_t i = 0; i < threadsStats.size(); ++i)
+        {
+            NetworkThreadStats const& thread = threadsStats[i];
+            handler->PSendSysMessage("Network thread %u: %i connections, %.0f writes/s, %.0f bytes/s, %.0f bytes and %.1f buffers per write, write queues %u entries (max %u)",
+                uint32(i), thread.connections, thread.writeCallsPerSec, thread.bytesPerSec,
+                thread.writeCalls ? float(thread.bytesWritten) / float(thread.writeCalls) : 0.0f,
+                thread.writeCalls ? float(thread.buffersWritten) / float(thread.writeCalls) : 0.0f,
+                thread.queueDepth, thread.maxQueueDepth);
+        }
+
+        SocketWriteStats stats = sMonitor->GetSocketWriteStats();
+        uint64 const total = stats.bytesCopied + stats.bytesShared;
+        handler->PSendSysMessage("Packet payloads queued: " UI64FMTD " bytes copied, " UI64FMTD " bytes shared (%.1f%% shared)", stats.bytesCopied, stats.bytesShared, total ? float(stats.bytesShared) * 100.0f / float(total) : 0.0f);
+        handler->PSendSysMessage("Last world loop: " UI64FMTD " bytes copied, " UI64FMTD " bytes shared", stats.lastTickBytesCopied, stats.lastTickBytesShared);
+        return true;
+    }
+
+    /// Display world and current map update diff percentiles. Use "dump" to get all maps in JSON format
+    static bool HandleServerTicksCommand(ChatHandler* handler, char const* args)
+    {
+        if (args && strcmp(args, "dump") == 0)
+        {
+            handler->SendSysMessage(sMonitor->DumpTickPercentiles().c_str());
+            return true;
+        }
+
+        TickPercentiles world = sMonitor->GetWorldDiffPercentiles();
+        handler->PSendSysMessage("World loop (last %u): p50 %u ms, p95 %u ms, p99 %u ms, max %u ms", world.count, world.p50, world.p95, world.p99, world.max);
+
+        Player* player = handler->GetSession() ? handler->GetSession()->GetPlayer() : nullptr;
+        if (player && player->FindMap())
+        {
+            TickPercentiles map = sMonitor->GetMapDiffPercentiles(*player->GetMap());
+            handler->PSendSysMessage("Map %u (instance %u) (last %u): p50 %u ms, p95 %u ms, p99 %u ms, max %u ms", player->GetMapId(), player->GetInstanceId(), map.count, map.p50, map.p95, map.p99, map.max);
+        }
+        return true;
+    }
+
+    static bool HandleServerGridPreloadCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (!sMapMgr->GetGridPreloader()->activated())
+        {
+            handler->SendSysMessage("Grid preloader is not activated (GridPreload.Threads)");
+            return true;
+        }
+
+        GridPreloadStats stats = sMonitor->GetGridPreloadStats();
+        uint64 const loads = stats.hits + stats.late + stats.misses;
+        handler->PSendSysMessage("Grids loaded: " UI64FMTD ", preloaded: " UI64FMTD " (%.1f%%), waited for preloader: " UI64FMTD ", not predicted: " UI64FMTD,
+            loads, stats.hits, loads ? float(stats.hits) * 100.0f / float(loads) : 0.0f, stats.late, stats.misses);
+        handler->PSendSysMessage("Preloaded but never used: " UI64FMTD ", currently queued: %u", stats.expired, sMapMgr->GetGridPreloader()->GetPendingCount());
+        return true;
+    }
+
+    static bool HandleServerLogQueueCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (!sLog->IsAsynchronous())
+        {
+            handler->SendSysMessage("Logging is synchronous (Log.Async.Enable)");
+            return true;
+        }
+
+        LogAsyncStats stats = sLog->GetAsyncStats();
+        handler->PSendSysMessage("Log queue capacity: %u, messages queued: " UI64FMTD ", dropped: " UI64FMTD ", waited for a free record: " UI64FMTD ", flushes: " UI64FMTD,
+            uint32(stats.capacity), stats.queued, stats.dropped, stats.waited, stats.flushes);
+        return true;
+    }
+
+    static bool HandleServerLosCacheCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (!sWorld->getIntConfig(CONFIG_LOS_CACHE_SIZE))
+        {
+            handler->SendSysMessage("Line of sight cache is disabled (LineOfSight.Cache.Size)");
+            return true;
+        }
+
+        LineOfSightCacheStats stats = sMonitor->GetLineOfSightCacheStats();
+        uint64 const queries = stats.hits + stats.misses;
+        uint64 const lastTickQueries = stats.lastTickHits + stats.lastTickMisses;
+        handler->PSendSysMessage("Line of sight queries: " UI64FMTD ", cached: " UI64FMTD " (%.1f%%)", queries, stats.hits, queries ? float(stats.hits) * 100.0f / float(queries) : 0.0f);
+        handler->PSendSysMessage("Last world loop: " UI64FMTD " queries, " UI64FMTD " cached (%.1f%%)", lastTickQueries, stats.lastTickHits, lastTickQueries ? float(stats.lastTickHits) * 100.0f / float(lastTickQueries) : 0.0f);
+        return true;
+    }
+
+    static bool HandleServerSpellModCacheCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        SpellModCacheStats stats = sMonitor->GetSpellModCacheStats();
+        uint64 const queries = stats.hits + stats.misses;
+        uint64 const lastTickQueries = stats.lastTickHits + stats.lastTickMisses;
+        handler->PSendSysMessage("Spell mod lookups: " UI64FMTD ", cached: " UI64FMTD " (%.1f%%)", queries, stats.hits, queries ? float(stats.hits) * 100.0f / float(queries) : 0.0f);
+        handler->PSendSysMessage("Last world loop: " UI64FMTD " lookups, " UI64FMTD " cached (%.1f%%)", lastTickQueries, stats.lastTickHits, lastTickQueries ? float(stats.lastTickHits) * 100.0f / float(lastTickQueries) : 0.0f);
+        return true;
+    }
+
     /// Display the 'Message of the day' for the realm
     static bool HandleServerMotdCommand(ChatHandler* handler, char const* /*args*/)
     {
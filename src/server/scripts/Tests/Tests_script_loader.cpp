@@ -25,6 +25,11 @@ void AddSC_test_talents_warlock();
 void AddSC_test_talents_warrior();
 void AddSC_test_creature();
 void AddSC_test_pools();
+void AddSC_test_threat();
+void AddSC_test_conditions();
+void AddSC_test_events();
+void AddSC_test_aura_effect_list();
+void AddSC_test_playerbot_ai();
 
 void AddTestsScripts()
 {
@@ -33,6 +38,11 @@ void AddTestsScripts()
     AddSC_test_quest_misc();
     AddSC_test_quest_spells();
     AddSC_test_creature();
+    AddSC_test_threat();
+    AddSC_test_conditions();
+    AddSC_test_events();
+    AddSC_test_aura_effect_list();
+    AddSC_test_playerbot_ai();
 	AddSC_test_pools();
     AddSC_test_movement_point();
 
@@ -0,0 +1,77 @@
+#include "TestCase.h"
+#include "AuraEffectList.h"
+#include <algorithm>
+
+// "aura effect list"
+// Check AuraEffectList iteration while effects are removed/added, compaction and aggregates cache.
+// Effects are never dereferenced here, fake pointers are enough.
+class AuraEffectListTest : public TestCase
+{
+public:
+    static uint32 const EFFECT_COUNT = 10;
+
+    void Test() override
+    {
+        std::vector<AuraEffect*> effects;
+        for (uint32 i = 0; i < EFFECT_COUNT; i++)
+            effects.push_back(reinterpret_cast<AuraEffect*>(uintptr_t(0x1000 + i * 0x10)));
+
+        AuraEffectList list;
+        TEST_ASSERT(list.empty() && list.begin() == list.end());
+        for (AuraEffect* aurEff : effects)
+            list.push_back(aurEff);
+        TEST_ASSERT(list.size() == EFFECT_COUNT);
+        TEST_ASSERT(list.front() == effects.front());
+
+        // remove every other effect while iterating, add one: removed ones are skipped, added one is not visited yet
+        std::vector<AuraEffect*> visited;
+        AuraEffect* added = reinterpret_cast<AuraEffect*>(uintptr_t(0x2000));
+        for (AuraEffect* aurEff : list)
+        {
+            visited.push_back(aurEff);
+            if (aurEff == effects[0])
+                list.push_back(added);
+            for (uint32 i = 1; i < EFFECT_COUNT; i += 2)
+                if (aurEff == effects[i - 1])
+                    list.remove(effects[i]);
+        }
+        ASSERT_INFO("Visited %u effects", uint32(visited.size()));
+        TEST_ASSERT(visited.size() == EFFECT_COUNT / 2);
+        TEST_ASSERT(list.size() == EFFECT_COUNT / 2 + 1);
+        TEST_ASSERT(list.NeedsCompact());
+
+        // copies are compacted and keep order
+        AuraEffectList copy(list);
+        TEST_ASSERT(!copy.NeedsCompact());
+        TEST_ASSERT(std::equal(copy.begin(), copy.end(), list.begin()));
+
+        list.Compact();
+        TEST_ASSERT(!list.NeedsCompact());
+        TEST_ASSERT(list.size() == EFFECT_COUNT / 2 + 1);
+        std::vector<AuraEffect*> remaining(list.begin(), list.end());
+        for (uint32 i = 0; i < EFFECT_COUNT / 2; i++)
+            TEST_ASSERT(remaining[i] == effects[i * 2]);
+        TEST_ASSERT(remaining.back() == added);
+
+        // aggregates cache
+        int32 modifier = 0;
+        float multiplier = 0.0f;
+        TEST_ASSERT(!list.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, modifier));
+        list.SetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, 42);
+        list.SetAggregate(AuraEffectList::AGGREGATE_TOTAL_MULTIPLIER, 1.5f);
+        TEST_ASSERT(list.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, modifier) && modifier == 42);
+        TEST_ASSERT(list.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MULTIPLIER, multiplier) && multiplier == 1.5f);
+        TEST_ASSERT(!list.GetAggregate(AuraEffectList::AGGREGATE_MAX_POSITIVE_MODIFIER, modifier));
+        list.remove(added);
+        TEST_ASSERT(!list.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MODIFIER, modifier));
+        TEST_ASSERT(!list.GetAggregate(AuraEffectList::AGGREGATE_TOTAL_MULTIPLIER, multiplier));
+
+        list.clear();
+        TEST_ASSERT(list.empty() && list.begin() == list.end());
+    }
+};
+
+void AddSC_test_aura_effect_list()
+{
+    RegisterTestCase("aura effect list", AuraEffectListTest);
+}
@@ -0,0 +1,105 @@
+#include "TestCase.h"
+#include "TestPlayer.h"
+#include "ConditionMgr.h"
+#include <chrono>
+#include <map>
+
+// Previous evaluation storing every else group result in a map, used as reference for results and speed
+namespace
+{
+    bool IsObjectMeetToConditionsByElseGroupStore(WorldObject* object, ConditionContainer const& conditions)
+    {
+        ConditionSourceInfo sourceInfo = ConditionSourceInfo(object);
+        //     groupId, groupCheckPassed
+        std::map<uint32, bool> ElseGroupStore;
+        for (auto condition : conditions)
+        {
+            if (!condition->isLoaded())
+                continue;
+
+            std::map<uint32, bool>::const_iterator itr = ElseGroupStore.find(condition->ElseGroup);
+            if (itr == ElseGroupStore.end())
+                ElseGroupStore[condition->ElseGroup] = true;
+            else if (!(*itr).second)
+                continue;
+
+            if (!condition->Meets(sourceInfo))
+                ElseGroupStore[condition->ElseGroup] = false;
+        }
+
+        for (std::map<uint32, bool>::const_iterator i = ElseGroupStore.begin(); i != ElseGroupStore.end(); ++i)
+            if (i->second)
+                return true;
+
+        return false;
+    }
+}
+
+// "conditions evaluation"
+// Benchmark ConditionMgr::IsObjectMeetToConditions on a list of several else groups, only the last one being met,
+// against the previous else group store evaluation.
+class ConditionsEvaluationTest : public TestCase
+{
+public:
+    static uint32 const ELSE_GROUPS = 4;
+    static uint32 const CONDITIONS_PER_GROUP = 4;
+    static uint32 const ITERATIONS = 200000;
+
+    void Test() override
+    {
+        TestPlayer* player = SpawnRandomPlayer();
+
+        std::vector<Condition> storage(ELSE_GROUPS * CONDITIONS_PER_GROUP);
+        ConditionContainer conditions;
+        for (uint32 i = 0; i < CONDITIONS_PER_GROUP; i++)
+        {
+            for (uint32 group = 0; group < ELSE_GROUPS; group++)
+            {
+                Condition& condition = storage[group * CONDITIONS_PER_GROUP + i];
+                condition.ElseGroup = group;
+                condition.ConditionType = (i % 2) ? CONDITION_RACE : CONDITION_CLASS;
+                condition.ConditionValue1 = (i % 2) ? player->GetRaceMask() : player->GetClassMask();
+                // every group but the last fails on its last condition
+                condition.NegativeCondition = group + 1 < ELSE_GROUPS && i + 1 == CONDITIONS_PER_GROUP;
+
+                ConditionMgr::AddToConditionList(conditions, &condition);
+            }
+        }
+
+        // inserted interleaved, AddToConditionList keeps them ordered by ElseGroup
+        for (size_t i = 1; i < conditions.size(); i++)
+            TEST_ASSERT(conditions[i - 1]->ElseGroup <= conditions[i]->ElseGroup);
+
+        TEST_ASSERT(sConditionMgr->IsObjectMeetToConditions(player, conditions));
+        TEST_ASSERT(IsObjectMeetToConditionsByElseGroupStore(player, conditions));
+
+        uint32 const elapsedUs = Benchmark([&]() { return sConditionMgr->IsObjectMeetToConditions(player, conditions); });
+        uint32 const referenceUs = Benchmark([&]() { return IsObjectMeetToConditionsByElseGroupStore(player, conditions); });
+        TC_LOG_INFO("test.unit_test", "conditions evaluation: %u else groups x %u conditions, %u evaluations in %u us (else group store: %u us)",
+            ELSE_GROUPS, CONDITIONS_PER_GROUP, ITERATIONS, elapsedUs, referenceUs);
+
+        // no group met anymore
+        storage.back().NegativeCondition = true;
+        TEST_ASSERT(!sConditionMgr->IsObjectMeetToConditions(player, conditions));
+        TEST_ASSERT(!IsObjectMeetToConditionsByElseGroupStore(player, conditions));
+    }
+
+    template<typename Evaluation>
+    uint32 Benchmark(Evaluation evaluation)
+    {
+        uint32 met = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < ITERATIONS; i++)
+            if (evaluation())
+                met++;
+
+        uint32 const elapsedUs = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        TEST_ASSERT(met == ITERATIONS);
+        return elapsedUs;
+    }
+};
+
+void AddSC_test_conditions()
+{
+    RegisterTestCase("conditions evaluation", ConditionsEvaluationTest);
+}
@@ -0,0 +1,295 @@
+#include "TestCase.h"
+#include "EventMap.h"
+#include "EventProcessor.h"
+#include <chrono>
+#include <map>
+
+// Previous multimap based storages, used as reference for ordering and speed
+namespace
+{
+    class MultimapEventProcessor
+    {
+    public:
+        ~MultimapEventProcessor() { KillAllEvents(); }
+
+        void AddEvent(BasicEvent* event, uint64 execTime) { _events.insert(std::make_pair(execTime, event)); }
+        void Update(uint32 diff)
+        {
+            _time += diff;
+            std::multimap<uint64, BasicEvent*>::iterator itr;
+            while ((itr = _events.begin()) != _events.end() && itr->first <= _time)
+            {
+                BasicEvent* event = itr->second;
+                _events.erase(itr);
+                if (event->Execute(_time, diff))
+                    delete event;
+            }
+        }
+        void KillAllEvents()
+        {
+            for (auto& pair : _events)
+                delete pair.second;
+            _events.clear();
+        }
+        uint64 CalculateTime(uint64 offset) const { return _time + offset; }
+
+    private:
+        uint64 _time = 0;
+        std::multimap<uint64, BasicEvent*> _events;
+    };
+
+    class MultimapEventMap
+    {
+    public:
+        void Update(uint32 diff) { _time += diff; }
+        void ScheduleEvent(uint32 eventId, uint32 time, uint32 group)
+        {
+            _events.insert(std::make_pair(_time + time, eventId | (1 << (group + 15))));
+        }
+        void CancelEvent(uint32 eventId)
+        {
+            for (auto itr = _events.begin(); itr != _events.end();)
+                itr = (eventId == (itr->second & 0x0000FFFF)) ? _events.erase(itr) : std::next(itr);
+        }
+        void DelayEvents(uint32 delay, uint32 group)
+        {
+            std::multimap<uint32, uint32> delayed;
+            for (auto itr = _events.begin(); itr != _events.end();)
+            {
+                if (itr->second & (1 << (group + 15)))
+                {
+                    delayed.insert(std::make_pair(itr->first + delay, itr->second));
+                    itr = _events.erase(itr);
+                }
+                else
+                    ++itr;
+            }
+            _events.insert(delayed.begin(), delayed.end());
+        }
+        uint32 ExecuteEvent()
+        {
+            if (_events.empty() || _events.begin()->first > _time)
+                return 0;
+            uint32 eventId = _events.begin()->second & 0x0000FFFF;
+            _events.erase(_events.begin());
+            return eventId;
+        }
+
+    private:
+        uint32 _time = 0;
+        std::multimap<uint32, uint32> _events;
+    };
+
+    class RecordEvent : public BasicEvent
+    {
+    public:
+        RecordEvent(std::vector<uint32>& executed, uint32 id) : _executed(executed), _id(id) { }
+        bool Execute(uint64, uint32) override { _executed.push_back(_id); return true; }
+
+    private:
+        std::vector<uint32>& _executed;
+        uint32 _id;
+    };
+
+    class KeepEvent : public BasicEvent
+    {
+    public:
+        KeepEvent(bool& aborted, bool& deleted) : _aborted(aborted), _deleted(deleted) { }
+        ~KeepEvent() { _deleted = true; }
+        bool IsDeletable() const override { return false; }
+        void Abort(uint64) override { _aborted = true; }
+
+    private:
+        bool& _aborted;
+        bool& _deleted;
+    };
+}
+
+// "events ordering"
+// Check EventProcessor and EventMap execute events in the same order as the multimap storages they replaced.
+class EventsOrderingTest : public TestCase
+{
+public:
+    static uint32 const EVENT_COUNT = 500;
+
+    void Test() override
+    {
+        TestEventProcessor();
+        TestEventMap();
+    }
+
+    void TestEventProcessor()
+    {
+        std::vector<uint32> executed, expected;
+        EventProcessor processor;
+        MultimapEventProcessor reference;
+        // few distinct times, so that many events share the same one
+        for (uint32 i = 0; i < EVENT_COUNT; i++)
+        {
+            uint64 offset = urand(0, 50) * 20;
+            processor.AddEvent(new RecordEvent(executed, i), processor.CalculateTime(offset));
+            reference.AddEvent(new RecordEvent(expected, i), reference.CalculateTime(offset));
+        }
+
+        for (uint32 time = 0; time <= 1000; time += 50)
+        {
+            processor.Update(50);
+            reference.Update(50);
+        }
+
+        ASSERT_INFO("EventProcessor executed %u events out of %u", uint32(executed.size()), EVENT_COUNT);
+        TEST_ASSERT(executed.size() == EVENT_COUNT);
+        ASSERT_INFO("EventProcessor did not execute events in multimap order");
+        TEST_ASSERT(executed == expected);
+
+        // non deletable events survive KillAllEvents, and are aborted
+        bool aborted = false;
+        bool deleted = false;
+        processor.AddEvent(new KeepEvent(aborted, deleted), processor.CalculateTime(100));
+        processor.AddEvent(new RecordEvent(executed, 0), processor.CalculateTime(50));
+        processor.KillAllEvents(false);
+        processor.Update(200);
+        TEST_ASSERT(aborted && !deleted);
+        TEST_ASSERT(executed.size() == EVENT_COUNT);
+        processor.KillAllEvents(true);
+        TEST_ASSERT(deleted);
+    }
+
+    void TestEventMap()
+    {
+        EventMap events;
+        MultimapEventMap reference;
+        std::vector<uint32> executed, expected;
+        for (uint32 step = 0; step < EVENT_COUNT; step++)
+        {
+            uint32 eventId = urand(1, 20);
+            uint32 group = urand(1, 8);
+            switch (urand(0, 9))
+            {
+                case 0:
+                    events.CancelEvent(eventId);
+                    reference.CancelEvent(eventId);
+                    break;
+                case 1:
+                    events.DelayEvents(100, group);
+                    reference.DelayEvents(100, group);
+                    break;
+                default:
+                {
+                    uint32 time = urand(0, 10) * 50;
+                    events.ScheduleEvent(eventId, time, group);
+                    reference.ScheduleEvent(eventId, time, group);
+                    break;
+                }
+            }
+
+            events.Update(50);
+            reference.Update(50);
+            while (uint32 id = events.ExecuteEvent())
+                executed.push_back(id);
+            while (uint32 id = reference.ExecuteEvent())
+                expected.push_back(id);
+        }
+
+        ASSERT_INFO("EventMap did not execute events in multimap order");
+        TEST_ASSERT(executed == expected);
+    }
+};
+
+// "events benchmark"
+// Benchmark schedule/fire/cancel of many small event queues (one per creature), against the multimap storages.
+class EventsBenchmarkTest : public TestCase
+{
+public:
+    static uint32 const QUEUE_COUNT = 2000;
+    static uint32 const EVENTS_PER_QUEUE = 8;
+    static uint32 const UPDATES = 40;
+    static uint32 const UPDATE_DIFF = 50;
+
+    void Test() override
+    {
+        std::vector<uint32> executed;
+        executed.reserve(QUEUE_COUNT * EVENTS_PER_QUEUE * UPDATES);
+
+        uint64 processorUs = Measure([&]()
+        {
+            std::vector<EventProcessor> processors(QUEUE_COUNT);
+            RunProcessors(processors, executed);
+            for (EventProcessor& processor : processors)
+                processor.KillAllEvents(false);
+        });
+        uint64 referenceUs = Measure([&]()
+        {
+            std::vector<MultimapEventProcessor> processors(QUEUE_COUNT);
+            RunProcessors(processors, executed);
+            for (MultimapEventProcessor& processor : processors)
+                processor.KillAllEvents();
+        });
+        TC_LOG_INFO("test.unit_test", "events benchmark: EventProcessor " UI64FMTD " us, multimap " UI64FMTD " us (%u queues, %u updates)",
+            processorUs, referenceUs, QUEUE_COUNT, UPDATES);
+
+        processorUs = Measure([&]()
+        {
+            std::vector<EventMap> maps(QUEUE_COUNT);
+            RunEventMaps(maps);
+        });
+        referenceUs = Measure([&]()
+        {
+            std::vector<MultimapEventMap> maps(QUEUE_COUNT);
+            RunEventMaps(maps);
+        });
+        TC_LOG_INFO("test.unit_test", "events benchmark: EventMap " UI64FMTD " us, multimap " UI64FMTD " us (%u maps, %u updates)",
+            processorUs, referenceUs, QUEUE_COUNT, UPDATES);
+    }
+
+    template<typename Callback>
+    static uint64 Measure(Callback callback)
+    {
+        auto start = std::chrono::steady_clock::now();
+        callback();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // every update, each queue schedules new events (some are left pending and killed at the end)
+    template<typename Processor>
+    static void RunProcessors(std::vector<Processor>& processors, std::vector<uint32>& executed)
+    {
+        executed.clear();
+        for (uint32 update = 0; update < UPDATES; update++)
+        {
+            for (Processor& processor : processors)
+            {
+                for (uint32 i = 0; i < EVENTS_PER_QUEUE; i++)
+                    processor.AddEvent(new RecordEvent(executed, i), processor.CalculateTime(i * 250));
+                processor.Update(UPDATE_DIFF);
+            }
+        }
+    }
+
+    // typical creature script, a few repeating spells and one cancel per update
+    template<typename Map>
+    static void RunEventMaps(std::vector<Map>& maps)
+    {
+        for (Map& map : maps)
+            for (uint32 i = 1; i <= EVENTS_PER_QUEUE; i++)
+                map.ScheduleEvent(i, i * 100, 1 + i % 2);
+
+        for (uint32 update = 0; update < UPDATES; update++)
+        {
+            for (Map& map : maps)
+            {
+                map.Update(UPDATE_DIFF);
+                while (uint32 eventId = map.ExecuteEvent())
+                    map.ScheduleEvent(eventId, eventId * 100, 1 + eventId % 2);
+                map.CancelEvent(1 + update % EVENTS_PER_QUEUE);
+                map.ScheduleEvent(1 + update % EVENTS_PER_QUEUE, 100, 1);
+            }
+        }
+    }
+};
+
+void AddSC_test_events()
+{
+    RegisterTestCase("events ordering", EventsOrderingTest);
+    RegisterTestCase("events benchmark", EventsBenchmarkTest);
+}
@@ -0,0 +1,61 @@
+#include "TestCase.h"
+#include "TestPlayer.h"
+#include "TemporarySummon.h"
+#include "playerbot.h"
+#include <algorithm>
+#include <chrono>
+
+// "playerbot ai benchmark"
+// Run the AI engine of many bots standing among creatures, one AI tick per bot per round, and log the time spent.
+// Also checks the shared per tick "nearby units" search and the per bot name resolution.
+class PlayerbotAIBenchmarkTest : public TestCase
+{
+public:
+    static uint32 const BOT_COUNT = 20;
+    static uint32 const CREATURE_COUNT = 20;
+    static uint32 const ROUNDS = 50;
+    static uint32 const LOOKUPS = 100000;
+
+    void Test() override
+    {
+        std::vector<TestPlayer*> bots;
+        for (uint32 i = 0; i < BOT_COUNT; i++)
+            bots.push_back(SpawnRandomPlayer());
+
+        std::vector<Creature*> creatures;
+        for (uint32 i = 0; i < CREATURE_COUNT; i++)
+            creatures.push_back(SpawnCreature());
+
+        ai::AiObjectContext* context = bots.front()->GetPlayerbotAI()->GetAiObjectContext();
+        std::list<ObjectGuid> nearby = context->GetValue<std::list<ObjectGuid> >("nearby units")->Get();
+        for (Creature* creature : creatures)
+        {
+            ASSERT_INFO("Creature %u not found by nearby units", creature->GetGUID().GetCounter());
+            TEST_ASSERT(std::find(nearby.begin(), nearby.end(), creature->GetGUID()) != nearby.end());
+        }
+
+        // resolved names are cached per bot: same object for the same name, unknown names stay null
+        TEST_ASSERT(context->GetUntypedValue("nearby units") == context->GetUntypedValue("nearby units"));
+        TEST_ASSERT(context->GetUntypedValue("nearby units::unknown qualifier") == context->GetUntypedValue("nearby units::unknown qualifier"));
+        TEST_ASSERT(!context->GetUntypedValue("no such value"));
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 round = 0; round < ROUNDS; round++)
+            for (TestPlayer* bot : bots)
+                bot->GetPlayerbotAI()->DoNextAction();
+        uint64 const tickUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        TC_LOG_INFO("test.unit_test", "playerbot ai benchmark: %u bots x %u creatures, %u ticks in " UI64FMTD " us (%.2f us per bot tick)",
+            BOT_COUNT, CREATURE_COUNT, ROUNDS, tickUs, float(tickUs) / (ROUNDS * BOT_COUNT));
+
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < LOOKUPS; i++)
+            context->GetUntypedValue("possible targets");
+        uint64 const lookupUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        TC_LOG_INFO("test.unit_test", "playerbot ai benchmark: %u value lookups in " UI64FMTD " us", LOOKUPS, lookupUs);
+    }
+};
+
+void AddSC_test_playerbot_ai()
+{
+    RegisterTestCase("playerbot ai benchmark", PlayerbotAIBenchmarkTest);
+}
@@ -0,0 +1,66 @@
+#include "TestCase.h"
+#include "TestPlayer.h"
+#include "TemporarySummon.h"
+#include "ThreatManager.h"
+#include <chrono>
+#include <limits>
+
+// "threat aoe_pull"
+// Benchmark threat lists on an AoE pull: 40 players hitting 25 creatures, every creature reselecting its victim every round.
+class ThreatAoEPullTest : public TestCase
+{
+public:
+    static uint32 const PLAYER_COUNT = 40;
+    static uint32 const CREATURE_COUNT = 25;
+    static uint32 const ROUNDS = 200;
+
+    void Test() override
+    {
+        std::vector<TestPlayer*> players;
+        for (uint32 i = 0; i < PLAYER_COUNT; i++)
+            players.push_back(SpawnRandomPlayer());
+
+        std::vector<Creature*> creatures;
+        for (uint32 i = 0; i < CREATURE_COUNT; i++)
+            creatures.push_back(SpawnCreature());
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 round = 0; round < ROUNDS; round++)
+        {
+            // later players do more damage, and so should end up highest on every threat list
+            for (uint32 i = 0; i < PLAYER_COUNT; i++)
+                for (Creature* creature : creatures)
+                    creature->GetThreatManager().AddThreat(players[i], float(i + 1), nullptr, true, true);
+
+            for (Creature* creature : creatures)
+                creature->GetThreatManager().Update(ThreatManager::THREAT_UPDATE_INTERVAL);
+        }
+        uint64 const elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        TC_LOG_INFO("test.unit_test", "threat aoe_pull: %u players x %u creatures, %u rounds in " UI64FMTD " us (%.2f us per round)",
+            PLAYER_COUNT, CREATURE_COUNT, ROUNDS, elapsedUs, float(elapsedUs) / ROUNDS);
+
+        for (Creature* creature : creatures)
+        {
+            ThreatManager& mgr = creature->GetThreatManager();
+            TEST_ASSERT(mgr.GetThreatListSize() == PLAYER_COUNT);
+            ASSERT_INFO("Creature did not select the highest threat player");
+            TEST_ASSERT(mgr.GetCurrentVictim() == players.back());
+
+            float lastThreat = std::numeric_limits<float>::max();
+            for (ThreatReference const* ref : mgr.GetSortedThreatList())
+            {
+                ASSERT_INFO("Sorted threat list is not in descending threat order");
+                TEST_ASSERT(ref->GetThreat() <= lastThreat);
+                lastThreat = ref->GetThreat();
+            }
+        }
+
+        for (Creature* creature : creatures)
+            creature->GetThreatManager().ClearAllThreat();
+    }
+};
+
+void AddSC_test_threat()
+{
+    RegisterTestCase("threat aoe_pull", ThreatAoEPullTest);
+}
@@ -423,6 +423,45 @@ class SpellTargetsAoETrigger : public TestCase
     }
 };
 
+/* "spells spellmod cache"
+Check spell mods cached by the player are updated on aura apply and remove
+*/
+class SpellModCacheTest : public TestCase
+{
+    void Test() override
+    {
+        uint32 const FIREBALL = 27070;
+        uint32 const IMPROVED_FIREBALL_RNK_5 = 12341; // -0.5s casting time
+        uint32 const PRESENCE_OF_MIND = 12043;        // next spell instant, uses charges
+
+        TestPlayer* player = SpawnPlayer(CLASS_MAGE, RACE_HUMAN);
+        auto castTime = [&]()
+        {
+            int32 value = 3500;
+            player->ApplySpellMod(FIREBALL, SPELLMOD_CASTING_TIME, value);
+            return value;
+        };
+
+        int32 const baseCastTime = castTime();
+        TEST_ASSERT(castTime() == baseCastTime); // served from cache
+
+        player->AddAura(IMPROVED_FIREBALL_RNK_5, player);
+        int32 const talentCastTime = castTime();
+        ASSERT_INFO("Cast time %i with talent, %i without", talentCastTime, baseCastTime);
+        TEST_ASSERT(talentCastTime < baseCastTime);
+
+        Aura* presenceOfMind = player->AddAura(PRESENCE_OF_MIND, player);
+        TEST_ASSERT(presenceOfMind != nullptr);
+        TEST_ASSERT(castTime() == 0);
+
+        player->RemoveAurasDueToSpell(PRESENCE_OF_MIND);
+        TEST_ASSERT(castTime() == talentCastTime);
+
+        player->RemoveAurasDueToSpell(IMPROVED_FIREBALL_RNK_5);
+        TEST_ASSERT(castTime() == baseCastTime);
+    }
+};
+
 void AddSC_test_spells_misc()
 {
     new NextMeleeHitTest();
@@ -431,4 +470,5 @@ void AddSC_test_spells_misc()
     new SpellPositivity();
     RegisterTestCase("spells delayed stacks", SpellDelayedStacks);
     RegisterTestCase("spells targets aoetrigger", SpellTargetsAoETrigger);
+    RegisterTestCase("spells spellmod cache", SpellModCacheTest);
 }
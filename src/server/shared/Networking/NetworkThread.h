@@ -24,22 +24,39 @@
 #include "Log.h"
 #include "Timer.h"
 #include "IoContext.h"
+#include "Socket.h"
 #include <boost/asio/ip/tcp.hpp>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 
 using boost::asio::ip::tcp;
 
+struct NetworkThreadStats
+{
+    int32 connections       = 0;
+    uint64 writeCalls       = 0; // socket writes since thread start
+    uint64 bytesWritten     = 0;
+    uint64 buffersWritten   = 0; // write queue entries sent
+    uint32 queueDepth       = 0; // write queue entries waiting in all sockets at last update
+    uint32 maxQueueDepth    = 0; // largest write queue of a single socket at last update
+    float writeCallsPerSec  = 0.0f; // over the last NETWORK_STATS_INTERVAL
+    float bytesPerSec       = 0.0f;
+};
+
+#define NETWORK_STATS_INTERVAL 10000 // ms
+
 template<class SocketType>
 class NetworkThread
 {
 public:
     NetworkThread() : _connections(0), _stopped(false), _thread(nullptr), _ioContext(1),
-        _acceptSocket(_ioContext), _updateTimer(_ioContext)
+        _acceptSocket(_ioContext), _updateTimer(_ioContext), _statsIntervalStart(0)
     {
     }
 
@@ -93,6 +110,14 @@ public:
 
     tcp::socket* GetSocketForAccept() { return &_acceptSocket; }
 
+    NetworkThreadStats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(_statsLock);
+        NetworkThreadStats stats = _stats;
+        stats.connections = _connections;
+        return stats;
+    }
+
 protected:
     virtual void SocketAdded(std::shared_ptr<SocketType> /*sock*/) { }
     virtual void SocketRemoved(std::shared_ptr<SocketType> /*sock*/) { }
@@ -141,9 +166,21 @@ protected:
 
         AddNewSockets();
 
-        _sockets.erase(std::remove_if(_sockets.begin(), _sockets.end(), [this](std::shared_ptr<SocketType> sock)
+        // sockets also write between updates when woken up, counters are collected here
+        SocketWriteCounters writeCounters;
+        uint32 queueDepth = 0;
+        uint32 maxQueueDepth = 0;
+
+        _sockets.erase(std::remove_if(_sockets.begin(), _sockets.end(), [&](std::shared_ptr<SocketType> sock)
         {
-            if (!sock->Update())
+            bool const updated = sock->Update();
+
+            SocketWriteCounters counters = sock->TakeWriteCounters();
+            writeCounters.writeCalls += counters.writeCalls;
+            writeCounters.bytesWritten += counters.bytesWritten;
+            writeCounters.buffersWritten += counters.buffersWritten;
+
+            if (!updated)
             {
                 if (sock->IsOpen())
                     sock->CloseSocket();
@@ -154,8 +191,39 @@ protected:
                 return true;
             }
 
+            uint32 const socketQueueDepth = uint32(sock->GetWriteQueueSize());
+            queueDepth += socketQueueDepth;
+            maxQueueDepth = std::max(maxQueueDepth, socketQueueDepth);
             return false;
         }), _sockets.end());
+
+        UpdateStats(writeCounters, queueDepth, maxQueueDepth);
+    }
+
+    void UpdateStats(SocketWriteCounters const& writeCounters, uint32 queueDepth, uint32 maxQueueDepth)
+    {
+        _intervalCounters.writeCalls += writeCounters.writeCalls;
+        _intervalCounters.bytesWritten += writeCounters.bytesWritten;
+
+        std::lock_guard<std::mutex> lock(_statsLock);
+        _stats.writeCalls += writeCounters.writeCalls;
+        _stats.bytesWritten += writeCounters.bytesWritten;
+        _stats.buffersWritten += writeCounters.buffersWritten;
+        _stats.queueDepth = queueDepth;
+        _stats.maxQueueDepth = maxQueueDepth;
+
+        uint32 const now = GetMSTime();
+        if (!_statsIntervalStart)
+            _statsIntervalStart = now;
+
+        uint32 const elapsed = GetMSTimeDiff(_statsIntervalStart, now);
+        if (elapsed < NETWORK_STATS_INTERVAL)
+            return;
+
+        _stats.writeCallsPerSec = float(_intervalCounters.writeCalls) * 1000.0f / elapsed;
+        _stats.bytesPerSec = float(_intervalCounters.bytesWritten) * 1000.0f / elapsed;
+        _intervalCounters = SocketWriteCounters();
+        _statsIntervalStart = now;
     }
 
 private:
@@ -174,6 +242,13 @@ private:
     Trinity::Asio::IoContext _ioContext;
     tcp::socket _acceptSocket;
     Trinity::Asio::DeadlineTimer _updateTimer;
+
+    // network thread only
+    uint32 _statsIntervalStart;
+    SocketWriteCounters _intervalCounters;
+
+    mutable std::mutex _statsLock;
+    NetworkThreadStats _stats;
 };
 
 #endif // NetworkThread_h__
@@ -20,26 +20,146 @@
 
 #include "MessageBuffer.h"
 #include "Log.h"
+#include "IoContext.h"
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <algorithm>
+#include <array>
+#include <vector>
 #include <boost/asio/ip/tcp.hpp>
 
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+// Maximum buffers sent by a single gathered write (stays well below IOV_MAX)
+#define MAX_WRITE_BUFFERS_GATHER 64
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
 
+/**
+Outgoing data queued on a socket: bytes owned by the socket, interleaved with payloads shared with other sockets
+(a packet broadcast to several players is serialized once and referenced by every recipient socket).
+Owned bytes and shared payloads are sent in the order they were appended, with gathered writes.
+*/
+struct SocketWriteBuffer
+{
+    // A slice of the owned buffer (sharedData null) or a shared payload
+    struct Segment
+    {
+        std::shared_ptr<void const> sharedOwner; // keeps shared payload alive until sent
+        uint8 const* sharedData;                 // shared bytes not sent yet
+        std::size_t size;                        // bytes not sent yet
+    };
+
+    explicit SocketWriteBuffer(MessageBuffer&& _buffer) : buffer(std::move(_buffer)), frontSegment(0), activeSize(0)
+    {
+        if (std::size_t const owned = buffer.GetActiveSize())
+            AppendOwned(owned);
+    }
+
+    std::size_t GetActiveSize() const { return activeSize; }
+
+    // Append bytes owned by this buffer, caller makes sure there's enough space left in buffer
+    void Write(void const* data, std::size_t size)
+    {
+        buffer.Write(data, size);
+        AppendOwned(size);
+    }
+
+    // Append a payload shared with other sockets, sharedOwner keeps sharedData alive until it's sent
+    void WriteShared(std::shared_ptr<void const> sharedOwner, uint8 const* sharedData, std::size_t sharedSize)
+    {
+        if (!sharedSize)
+            return;
+
+        segments.push_back({ std::move(sharedOwner), sharedData, sharedSize });
+        activeSize += sharedSize;
+    }
+
+    // Mark bytes as sent, in append order
+    void ReadCompleted(std::size_t bytes)
+    {
+        activeSize -= bytes;
+        while (bytes && frontSegment < segments.size())
+        {
+            Segment& segment = segments[frontSegment];
+            std::size_t const sent = std::min(bytes, segment.size);
+            if (segment.sharedData)
+                segment.sharedData += sent;
+            else
+                buffer.ReadCompleted(sent);
+
+            segment.size -= sent;
+            bytes -= sent;
+            if (!segment.size)
+            {
+                segment.sharedOwner.reset();
+                ++frontSegment;
+            }
+        }
+    }
+
+    // Append the parts not sent yet to buffers, up to maxBuffers in total. Returns the number of bytes added
+    std::size_t GatherBuffers(std::vector<boost::asio::const_buffer>& buffers, std::size_t maxBuffers)
+    {
+        std::size_t bytes = 0;
+        uint8 const* owned = buffer.GetReadPointer();
+        for (std::size_t i = frontSegment; i < segments.size() && buffers.size() < maxBuffers; ++i)
+        {
+            Segment const& segment = segments[i];
+            if (segment.sharedData)
+                buffers.emplace_back(segment.sharedData, segment.size);
+            else
+            {
+                buffers.emplace_back(owned, segment.size);
+                owned += segment.size;
+            }
+
+            bytes += segment.size;
+        }
+
+        return bytes;
+    }
+
+    MessageBuffer buffer;
+    std::vector<Segment> segments;
+    std::size_t frontSegment; // first segment not fully sent
+    std::size_t activeSize;
+
+private:
+    void AppendOwned(std::size_t size)
+    {
+        if (!size)
+            return;
+
+        // contiguous owned bytes share a segment
+        if (!segments.empty() && frontSegment < segments.size() && !segments.back().sharedData)
+            segments.back().size += size;
+        else
+            segments.push_back({ nullptr, nullptr, size });
+
+        activeSize += size;
+    }
+};
+
+// Write counters of a socket, collected by its network thread
+struct SocketWriteCounters
+{
+    uint64 writeCalls     = 0;
+    uint64 bytesWritten   = 0;
+    uint64 buffersWritten = 0; // write queue entries fully sent
+};
+
 template<class T>
 class Socket : public std::enable_shared_from_this<T>
 {
 public:
     explicit Socket(tcp::socket&& socket) : _socket(std::move(socket)), _remoteAddress(_socket.remote_endpoint().address()),
-        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
+        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false), _wakeUpPending(false)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
     }
@@ -92,13 +212,37 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.emplace_back(std::move(buffer));
+
+#ifdef TC_SOCKET_USE_IOCP
+        AsyncProcessQueue();
+#endif
+    }
+
+    // Queue owned bytes interleaved with payloads shared with other sockets
+    void QueuePacket(SocketWriteBuffer&& buffer)
+    {
+        _writeQueue.push_back(std::move(buffer));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
 #endif
     }
 
+    /// Thread safe. Run Update on the network thread as soon as possible instead of waiting for its next periodic update.
+    /// Calls are coalesced until the update runs.
+    void WakeUp()
+    {
+        if (_wakeUpPending.exchange(true))
+            return;
+
+#if BOOST_VERSION >= 106600
+        boost::asio::post(_socket.get_executor(), std::bind(&Socket<T>::WakeUpHandler, this->shared_from_this()));
+#else
+        _socket.get_io_service().post(std::bind(&Socket<T>::WakeUpHandler, this->shared_from_this()));
+#endif
+    }
+
     bool IsOpen() const { return !_closed && !_closing; }
 
     void CloseSocket()
@@ -120,6 +264,16 @@ public:
 
     MessageBuffer& GetReadBuffer() { return _readBuffer; }
 
+    // Network thread only
+    std::size_t GetWriteQueueSize() const { return _writeQueue.size(); }
+    // Network thread only. Counters since last call.
+    SocketWriteCounters TakeWriteCounters()
+    {
+        SocketWriteCounters counters = _writeCounters;
+        _writeCounters = SocketWriteCounters();
+        return counters;
+    }
+
 protected:
     virtual void OnClose() { }
 
@@ -133,8 +287,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        GatherWriteQueue();
+        _socket.async_write_some(_writeBuffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -166,6 +320,47 @@ private:
         ReadHandler();
     }
 
+    void WakeUpHandler()
+    {
+        _wakeUpPending = false;
+        if (!_closed)
+            this->Update(); // on failure, socket is removed at next network thread update
+    }
+
+    // Fill _writeBuffers with the front of the write queue, returns the number of bytes gathered
+    std::size_t GatherWriteQueue()
+    {
+        _writeBuffers.clear();
+
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < _writeQueue.size() && _writeBuffers.size() < MAX_WRITE_BUFFERS_GATHER; ++i)
+            bytes += _writeQueue[i].GatherBuffers(_writeBuffers, MAX_WRITE_BUFFERS_GATHER);
+
+        return bytes;
+    }
+
+    // Pop the write queue entries fully sent and mark the remaining one as partially sent
+    void WriteCompleted(std::size_t bytes)
+    {
+        ++_writeCounters.writeCalls;
+        _writeCounters.bytesWritten += bytes;
+
+        while (bytes && !_writeQueue.empty())
+        {
+            SocketWriteBuffer& queuedMessage = _writeQueue.front();
+            std::size_t const activeSize = queuedMessage.GetActiveSize();
+            if (bytes < activeSize)
+            {
+                queuedMessage.ReadCompleted(bytes);
+                return;
+            }
+
+            bytes -= activeSize;
+            _writeQueue.pop_front();
+            ++_writeCounters.buffersWritten;
+        }
+    }
+
 #ifdef TC_SOCKET_USE_IOCP
 
     void WriteHandler(boost::system::error_code error, std::size_t transferedBytes)
@@ -173,9 +368,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -199,37 +392,34 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        // send as much of the queue as possible with a single writev
+        std::size_t bytesToSend = GatherWriteQueue();
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(_writeBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        WriteCompleted(bytesSent);
+        if (bytesSent < bytesToSend) // socket send buffer is full
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -243,12 +433,16 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<SocketWriteBuffer> _writeQueue;
+    // buffers of the write in progress, reused to avoid allocations
+    std::vector<boost::asio::const_buffer> _writeBuffers;
+    SocketWriteCounters _writeCounters;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
 
     bool _isWritingAsync;
+    std::atomic<bool> _wakeUpPending;
 };
 
 #endif // __SOCKET_H__
@@ -110,6 +110,15 @@ public:
 
 	int32 GetNetworkThreadCount() const { return _threadCount; }
 
+	std::vector<NetworkThreadStats> GetNetworkThreadsStats() const
+	{
+		std::vector<NetworkThreadStats> stats;
+		for (int32 i = 0; i < _threadCount; ++i)
+			stats.push_back(_threads[i].GetStats());
+
+		return stats;
+	}
+
 	uint32 SelectThreadWithMinConnections() const
 	{
 		uint32 min = 0;
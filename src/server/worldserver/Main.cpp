@@ -19,6 +19,7 @@
 #include "AsyncAcceptor.h"
 #include "ScriptMgr.h"
 #include "BattlegroundMgr.h"
+#include "AuctionHouseMgr.h"
 #include "TCSoap.h"
 #include "CliRunnable.h"
 #include "WorldSocket.h"
@@ -183,8 +184,7 @@ extern int main(int argc, char **argv)
     std::shared_ptr<Trinity::Asio::IoContext> ioContext = std::make_shared<Trinity::Asio::IoContext>();
 
     sLog->RegisterAppender<AppenderDB>();
-    // If logs are supposed to be handled async then we need to pass the ioContext into the Log singleton
-    sLog->Initialize(sConfigMgr->GetBoolDefault("Log.Async.Enable", false) ? ioContext.get() : nullptr);
+    sLog->Initialize(sConfigMgr->GetBoolDefault("Log.Async.Enable", false));
 
     Trinity::Banner::Show("worldserver-daemon",
         [](char const* text)
@@ -275,6 +275,7 @@ extern int main(int argc, char **argv)
 
             sInstanceSaveMgr->Unload();
             sOutdoorPvPMgr->Die();                     // unload it before MapManager
+            sAuctionMgr->GetSearcher().deactivate();
             sMapMgr->UnloadAll();                      // unload all grids (including locked in memory)
         });
 
@@ -19,13 +19,19 @@
 #include <stdio.h>
 #include <deque>
 #include <set>
+#include <map>
 #include <cstdlib>
 #include <fstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "dbcfile.h"
 #include "Banner.h"
 #include "mpq_libmpq04.h"
 #include "StringFormat.h"
+#include "SHA1.h"
+#include "Util.h"
 
 #include "adt.h"
 #include "wdt.h"
@@ -34,7 +40,7 @@
 #include <boost/filesystem.hpp>
 #include "WaterDefines.h"
 
-extern ArchiveSet gOpenArchives;
+extern thread_local ArchiveSet gOpenArchives;
 
 typedef struct
 {
@@ -74,6 +80,11 @@ float CONF_float_to_int16_limit = 2048.0f;   // Max accuracy = val/65536
 float CONF_flat_height_delta_limit = 0.005f; // If max - min less this value - surface is flat
 float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - liquid surface is flat
 
+// Number of threads converting adt files, 0 converts them on the main thread
+unsigned int CONF_threads = std::thread::hardware_concurrency();
+// Skip tiles whose adt data and options did not change since the last run
+bool  CONF_incremental = false;
+
                                              // List MPQ for extract from
 const char *CONF_mpq_list[] = {
     "common.MPQ",
@@ -109,7 +120,9 @@ void Usage(char* prg)
         "-o set output path (max %d characters)\n"\
         "-e extract only MAP(1)/DBC(2)/Camera(4) - standard: all(7)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
-        "Example: %s -f 0 -i \"c:\\games\\game\"", prg, MAX_PATH_LENGTH - 1, MAX_PATH_LENGTH - 1, prg);
+        "-t number of threads converting map tiles, 0 converts them on the main thread - standard: %u\n"\
+        "-u incremental extraction, skip map tiles unchanged since the last run 0 by default\n"\
+        "Example: %s -f 0 -i \"c:\\games\\game\"", prg, MAX_PATH_LENGTH - 1, MAX_PATH_LENGTH - 1, std::thread::hardware_concurrency(), prg);
     exit(1);
 }
 
@@ -122,6 +135,8 @@ void HandleArgs(int argc, char * arg[])
         // e - extract only MAP(1)/DBC(2) - standard both(3)
         // f - use float to int conversion
         // h - limit minimum height
+        // t - number of threads
+        // u - incremental extraction
         if (arg[c][0] != '-')
             Usage(arg[0]);
 
@@ -161,6 +176,23 @@ void HandleArgs(int argc, char * arg[])
             else
                 Usage(arg[0]);
             break;
+        case 't':
+            if (c + 1 < argc)                            // all ok
+            {
+                int threads = atoi(arg[(c++) + 1]);
+                if (threads < 0)
+                    Usage(arg[0]);
+                CONF_threads = uint32(threads);
+            }
+            else
+                Usage(arg[0]);
+            break;
+        case 'u':
+            if (c + 1 < argc)                            // all ok
+                CONF_incremental = atoi(arg[(c++) + 1]) != 0;
+            else
+                Usage(arg[0]);
+            break;
         }
     }
 }
@@ -328,31 +360,26 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, one per converting thread
+thread_local uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
 
-int16 flight_box_max[3][3];
-int16 flight_box_min[3][3];
+thread_local int16 flight_box_max[3][3];
+thread_local int16 flight_box_min[3][3];
 
-bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int /*cell_y*/, int /*cell_x*/, uint32 build)
+bool ConvertADT(ADT_file& adt, std::string const& inputPath, std::string const& outputPath, int /*cell_y*/, int /*cell_x*/, uint32 build)
 {
-    ADT_file adt;
-
-    if (!adt.loadFile(inputPath))
-        return false;
-
     adt_MCIN *cells = adt.a_grid->getMCIN();
     if (!cells)
     {
@@ -913,10 +940,118 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
     return true;
 }
 
-void ExtractMapsFromMpq(uint32 build)
+void LoadLocaleMPQFiles(int const locale);
+void LoadCommonMPQFiles();
+inline void CloseMPQFiles();
+
+struct MapTile
+{
+    MapTile(uint32 mapIndex, uint32 x, uint32 y) : MapIndex(mapIndex), X(x), Y(y) { }
+
+    uint32 MapIndex;
+    uint32 X;
+    uint32 Y;
+};
+
+// Input hashes of the converted tiles, keyed by map id and grid coordinates
+std::map<uint32, std::string> tileHashes;
+std::mutex tileHashesLock;
+std::atomic<uint32> tilesUnchanged(0);
+
+inline uint32 GetTileKey(uint32 mapId, uint32 y, uint32 x)
+{
+    return (mapId << 16) | (y << 8) | x;
+}
+
+std::string GetTileInputHash(ADT_file& adt, uint32 build)
+{
+    // the options are part of the hash, changing any of them converts every tile again
+    std::string options = Trinity::StringFormat("%s %u %u %f %u %f %f %f %f", MAP_VERSION_MAGIC, build,
+        uint32(CONF_allow_height_limit), CONF_use_minHeight, uint32(CONF_allow_float_to_int), CONF_float_to_int8_limit,
+        CONF_float_to_int16_limit, CONF_flat_height_delta_limit, CONF_flat_liquid_delta_limit);
+
+    SHA1Hash sha;
+    sha.UpdateData(options);
+    sha.UpdateData(adt.GetData(), int(adt.GetDataSize()));
+    sha.Finalize();
+
+    return ByteArrayToHexStr(sha.GetDigest(), sha.GetLength());
+}
+
+void LoadTileHashes(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "r");
+    if (!file)
+    {
+        printf("No tile hashes found, converting all tiles\n");
+        return;
+    }
+
+    uint32 mapId, y, x;
+    char hash[SHA_DIGEST_LENGTH * 2 + 1];
+    while (fscanf(file, "%u %u %u %40s", &mapId, &y, &x, hash) == 4)
+        tileHashes[GetTileKey(mapId, y, x)] = hash;
+    fclose(file);
+
+    printf("Loaded %u tile hashes\n", uint32(tileHashes.size()));
+}
+
+void SaveTileHashes(std::string const& fileName)
+{
+    // written to a temporary file first, an interrupted run keeps the previous hashes
+    std::string tmpFileName = fileName + ".tmp";
+    FILE* file = fopen(tmpFileName.c_str(), "w");
+    if (!file)
+    {
+        printf("Can't create the output file '%s'\n", tmpFileName.c_str());
+        return;
+    }
+
+    for (auto const& itr : tileHashes)
+        fprintf(file, "%03u %02u %02u %s\n", itr.first >> 16, (itr.first >> 8) & 0xFF, itr.first & 0xFF, itr.second.c_str());
+    fclose(file);
+
+    std::remove(fileName.c_str());
+    if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+        printf("Can't write the tile hashes to '%s'\n", fileName.c_str());
+}
+
+void ConvertTile(MapTile const& tile, uint32 build)
+{
+    map_id const& map = map_ids[tile.MapIndex];
+    std::string mpqFileName = Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map.name, map.name, tile.X, tile.Y);
+    std::string outputFileName = Trinity::StringFormat("%s/maps/%03u%02u%02u.map", output_path, map.id, tile.Y, tile.X);
+
+    ADT_file adt;
+    if (!adt.loadFile(mpqFileName))
+        return;
+
+    std::string hash;
+    if (CONF_incremental)
+    {
+        hash = GetTileInputHash(adt, build);
+
+        std::lock_guard<std::mutex> lock(tileHashesLock);
+        auto itr = tileHashes.find(GetTileKey(map.id, tile.Y, tile.X));
+        if (itr != tileHashes.end() && itr->second == hash && boost::filesystem::exists(outputFileName))
+        {
+            ++tilesUnchanged;
+            return;
+        }
+    }
+
+    if (!ConvertADT(adt, mpqFileName, outputFileName, tile.Y, tile.X, build))
+        return;
+
+    if (CONF_incremental)
+    {
+        std::lock_guard<std::mutex> lock(tileHashesLock);
+        tileHashes[GetTileKey(map.id, tile.Y, tile.X)] = hash;
+    }
+}
+
+void ExtractMapsFromMpq(uint32 build, int locale)
 {
-    std::string mpqFileName;
-    std::string outputFileName;
     std::string mpqMapName;
 
     printf("Extracting maps...\n");
@@ -933,12 +1068,15 @@ void ExtractMapsFromMpq(uint32 build)
     path += "/maps/";
     CreateDir(path);
 
-    printf("Convert map files\n");
+    std::string hashesFileName = path + "maps.sha1";
+    if (CONF_incremental)
+        LoadTileHashes(hashesFileName);
+
+    // the wdt files only tell which tiles exist, they are read up front and the adt files are converted in parallel
+    std::vector<MapTile> tiles;
     for (uint32 z = 0; z < map_count; ++z)
     {
-        printf("Extract %s (%d/%u)                  \n", map_ids[z].name, z + 1, map_count);
         // Loadup map grid data
-
         mpqMapName = Trinity::StringFormat("World\\Maps\\%s\\%s.wdt", map_ids[z].name, map_ids[z].name);
         WDT_file wdt;
         if (!wdt.loadFile(mpqMapName, false))
@@ -948,21 +1086,63 @@ void ExtractMapsFromMpq(uint32 build)
         }
 
         for (uint32 y = 0; y < WDT_MAP_SIZE; ++y)
-        {
             for (uint32 x = 0; x < WDT_MAP_SIZE; ++x)
+                if (wdt.main->adt_list[y][x].exist)
+                    tiles.emplace_back(z, x, y);
+    }
+
+    printf("Convert map files (%u tiles, %u threads)\n", uint32(tiles.size()), CONF_threads);
+
+    std::atomic<uint32> nextTile(0);
+    std::atomic<uint32> tilesDone(0);
+    if (CONF_threads > 0)
+    {
+        std::vector<std::thread> workers;
+        for (uint32 i = 0; i < CONF_threads; ++i)
+        {
+            workers.emplace_back([&]()
             {
-                if (!wdt.main->adt_list[y][x].exist)
-                    continue;
+                // the archives of the main thread are not visible here, every worker reads through its own handles
+                LoadLocaleMPQFiles(locale);
+                LoadCommonMPQFiles();
 
-                mpqFileName = Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                outputFileName = Trinity::StringFormat("%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpqFileName, outputFileName, y, x, build);
-            }
+                for (uint32 index = nextTile++; index < tiles.size(); index = nextTile++)
+                {
+                    ConvertTile(tiles[index], build);
+                    ++tilesDone;
+                }
+
+                CloseMPQFiles();
+            });
+        }
+
+        // draw progress bar
+        while (tilesDone < tiles.size())
+        {
+            printf("Processing........................%u%%\r", uint32(100 * uint64(tilesDone) / tiles.size()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+    else
+    {
+        for (MapTile const& tile : tiles)
+        {
+            ConvertTile(tile, build);
             // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
+            printf("Processing........................%u%%\r", uint32(100 * uint64(++tilesDone) / tiles.size()));
         }
     }
     printf("\n");
+
+    if (CONF_incremental)
+    {
+        printf("%u tiles unchanged since the last run\n", uint32(tilesUnchanged));
+        SaveTileHashes(hashesFileName);
+    }
+
     delete[] map_ids;
 }
 
@@ -1189,7 +1369,7 @@ int main(int argc, char * arg[])
         LoadCommonMPQFiles();
 
         // Extract maps
-        ExtractMapsFromMpq(build);
+        ExtractMapsFromMpq(build, FirstLocale);
 
         // Close MPQs
         CloseMPQFiles();
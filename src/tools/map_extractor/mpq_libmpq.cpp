@@ -20,7 +20,8 @@
 #include <deque>
 #include <cstdio>
 
-ArchiveSet gOpenArchives;
+// every extraction thread opens its own handles, libmpq archives can't be shared between threads
+thread_local ArchiveSet gOpenArchives;
 
 MPQArchive::MPQArchive(char const* filename)
 {
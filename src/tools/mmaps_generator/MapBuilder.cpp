@@ -11,14 +11,19 @@
 #include "DetourCommon.h"
 
 #include "MMapManager.h"
+#include "VMapManager2.h"
+#include "SHA1.h"
+#include "Timer.h"
+#include "Util.h"
 
 namespace MMAP
 {
     MapBuilder::MapBuilder(bool skipLiquid,
         bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-        bool debugOutput, int mapid, bool quick, const char* offMeshFilePath) :
+        bool debugOutput, int mapid, bool quick, const char* offMeshFilePath, bool incremental) :
         m_terrainBuilder     (NULL),
         m_debugOutput        (debugOutput),
+        m_skipLiquid         (skipLiquid),
         m_offMeshFilePath    (offMeshFilePath),
         m_skipContinents     (skipContinents),
         m_skipJunkMaps       (skipJunkMaps),
@@ -26,9 +31,11 @@ namespace MMAP
         m_mapid              (mapid),
         m_totalTiles         (0u),
         m_totalTilesProcessed(0u),
+        m_totalTilesUnchanged(0u),
         m_rcContext          (NULL),
         _cancelationToken    (false),
-        m_quick(quick)
+        m_quick(quick),
+        m_incremental(incremental)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid, quick);
 
@@ -154,58 +161,194 @@ namespace MMAP
 
     void MapBuilder::WorkerThread()
     {
+        // terrain builder keeps the loaded vmap tiles and terrain heights of the tile being built, so one per thread
+        TerrainBuilder terrainBuilder(m_skipLiquid, m_quick);
+        dtNavMesh* navMesh = NULL;
+        uint32 navMeshMapId = 0;
+
         while (1)
         {
-            uint32 mapId = 0;
+            TileInfo tileInfo;
 
-            _queue.WaitAndPop(mapId);
+            _queue.WaitAndPop(tileInfo);
 
             if (_cancelationToken)
+                break;
+
+            buildQueuedTile(tileInfo, terrainBuilder, navMesh, navMeshMapId);
+        }
+
+        dtFreeNavMesh(navMesh);
+    }
+
+    void MapBuilder::buildQueuedTile(TileInfo const& tileInfo, TerrainBuilder& terrainBuilder, dtNavMesh*& navMesh, uint32& navMeshMapId)
+    {
+        uint32 mapID = tileInfo.m_mapId;
+        uint32 tileX = tileInfo.m_tileX;
+        uint32 tileY = tileInfo.m_tileY;
+
+        std::string inputHash;
+        if (m_incremental)
+        {
+            inputHash = getTileInputHash(mapID, tileX, tileY);
+            if (isTileUpToDate(mapID, tileX, tileY, inputHash))
+            {
+                ++m_totalTilesUnchanged;
+                ++m_totalTilesProcessed;
+                return;
+            }
+
+            // a tile left without data would otherwise keep its old file
+            char fileName[255];
+            sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
+            std::remove(fileName);
+        }
+        else if (shouldSkipTile(mapID, tileX, tileY))
+        {
+            ++m_totalTilesProcessed;
+            return;
+        }
+
+        // the navmesh is only used to check and serialize the tile, each thread needs its own
+        if (!navMesh || navMeshMapId != mapID)
+        {
+            dtFreeNavMesh(navMesh);
+            navMesh = dtAllocNavMesh();
+            navMeshMapId = mapID;
+            if (!navMesh->init(&m_navMeshParams.at(mapID)))
+            {
+                printf("[Map %03i] Failed creating navmesh!\n", mapID);
+                dtFreeNavMesh(navMesh);
+                navMesh = NULL;
+                ++m_totalTilesProcessed;
                 return;
+            }
+        }
+
+        buildTile(mapID, tileX, tileY, navMesh, terrainBuilder);
+
+        if (m_incremental)
+        {
+            TileHash tileHash;
+            tileHash.m_hash = inputHash;
+            tileHash.m_hasTile = shouldSkipTile(mapID, tileX, tileY);
 
-            buildMap(mapId);
+            std::lock_guard<std::mutex> lock(m_tileHashesLock);
+            m_tileHashes[(uint64(mapID) << 32) | StaticMapTree::packTileID(tileX, tileY)] = tileHash;
         }
+
+        ++m_totalTilesProcessed;
     }
+
     void MapBuilder::buildAllMaps(unsigned int threads)
     {
         printf("Using %u threads to extract mmaps\n", threads);
 
-        for (unsigned int i = 0; i < threads; ++i)
-        {
-            _workerThreads.push_back(std::thread(&MapBuilder::WorkerThread, this));
-        }
+        if (m_incremental)
+            loadTileHashes();
 
         m_tiles.sort([](MapTiles a, MapTiles b)
         {
             return a.m_tiles->size() > b.m_tiles->size();
         });
 
+        // navmesh params are written once per map, the tiles of every map then go to the same queue
+        std::vector<TileInfo> queuedTiles;
         for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
         {
             uint32 mapId = it->m_mapId;
-            if (!shouldSkipMap(mapId))
+            std::set<uint32>* tiles = it->m_tiles;
+            if (shouldSkipMap(mapId) || tiles->empty())
+                continue;
+
+            dtNavMesh* navMesh = NULL;
+            buildNavMesh(mapId, navMesh);
+            if (!navMesh)
             {
-                if (threads > 0)
-                    _queue.Push(mapId);
-                else
-                    buildMap(mapId);
+                printf("[Map %03i] Failed creating navmesh!\n", mapId);
+                m_totalTilesProcessed += tiles->size();
+                continue;
+            }
+
+            m_navMeshParams[mapId] = *navMesh->getParams();
+            dtFreeNavMesh(navMesh);
+
+            printf("[Map %03i] We have %u tiles.\n", mapId, (unsigned int)tiles->size());
+            for (std::set<uint32>::iterator itr = tiles->begin(); itr != tiles->end(); ++itr)
+            {
+                uint32 tileX, tileY;
+                StaticMapTree::unpackTileID((*itr), tileX, tileY);
+                queuedTiles.emplace_back(mapId, tileX, tileY);
             }
         }
 
-        while (!_queue.Empty())
+        uint32 startTime = GetMSTime();
+        if (threads > 0)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            for (unsigned int i = 0; i < threads; ++i)
+            {
+                _workerThreads.push_back(std::thread(&MapBuilder::WorkerThread, this));
+            }
+
+            for (TileInfo const& tileInfo : queuedTiles)
+                _queue.Push(tileInfo);
+
+            uint32 lastProgress = startTime;
+            while (!_queue.Empty())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+                if (GetMSTimeDiffToNow(lastProgress) >= 10 * IN_MILLISECONDS)
+                {
+                    printProgress(startTime);
+                    lastProgress = GetMSTime();
+                }
+            }
+
+            _cancelationToken = true;
+
+            _queue.Cancel();
+
+            for (auto& thread : _workerThreads)
+            {
+                thread.join();
+            }
         }
+        else
+        {
+            dtNavMesh* navMesh = NULL;
+            uint32 navMeshMapId = 0;
+            for (TileInfo const& tileInfo : queuedTiles)
+                buildQueuedTile(tileInfo, *m_terrainBuilder, navMesh, navMeshMapId);
 
-        _cancelationToken = true;
+            dtFreeNavMesh(navMesh);
+        }
 
-        _queue.Cancel();
+        printProgress(startTime);
 
-        for (auto& thread : _workerThreads)
+        if (m_incremental)
         {
-            thread.join();
+            printf("%u tiles unchanged since the last run\n", uint32(m_totalTilesUnchanged));
+            saveTileHashes();
         }
     }
+
+    void MapBuilder::printProgress(uint32 startTime)
+    {
+        uint32 total = m_totalTiles;
+        uint32 done = m_totalTilesProcessed;
+        uint32 elapsed = GetMSTimeDiffToNow(startTime) / IN_MILLISECONDS;
+
+        std::string eta = "unknown";
+        if (done && done < total)
+            eta = secsToTimeString(uint64(elapsed) * (total - done) / done, true);
+        else if (done >= total)
+            eta = "done";
+
+        printf("Progress: %u/%u tiles (%u%%), elapsed %s, ETA %s\n", done, total, percentageDone(total, done),
+            secsToTimeString(elapsed, true).c_str(), eta.c_str());
+    }
+
     /**************************************************************************/
     void MapBuilder::getGridBounds(uint32 mapID, uint32 &minX, uint32 &minY, uint32 &maxX, uint32 &maxY) const
     {
@@ -347,51 +490,12 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh);
+        buildTile(mapID, tileX, tileY, navMesh, *m_terrainBuilder);
         dtFreeNavMesh(navMesh);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
-    {
-        std::set<uint32>* tiles = getTileList(mapID);
-
-        if (!tiles->empty())
-        {
-            // build navMesh
-            dtNavMesh* navMesh = NULL;
-            buildNavMesh(mapID, navMesh);
-            if (!navMesh)
-            {
-                printf("[Map %03i] Failed creating navmesh!\n", mapID);
-                m_totalTilesProcessed += tiles->size();
-                return;
-            }
-
-            // now start building mmtiles for each tile
-            printf("[Map %03i] We have %u tiles.                          \n", mapID, (unsigned int)tiles->size());
-            for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
-            {
-                uint32 tileX, tileY;
-
-                // unpack tile coords
-                StaticMapTree::unpackTileID((*it), tileX, tileY);
-
-                if (!shouldSkipTile(mapID, tileX, tileY))
-                    buildTile(mapID, tileX, tileY, navMesh);
-
-                ++m_totalTilesProcessed;
-                
-            }
-
-            dtFreeNavMesh(navMesh);
-        }
-
-        printf("[Map %03i] Complete!\n", mapID);
-    }
-
-    /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, TerrainBuilder& terrainBuilder)
     {
         printf("%u%% [Map %03i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
         printf("[Map %03i] Building tile [%02u,%02u]\n", mapID, tileX, tileY);
@@ -399,14 +503,14 @@ namespace MMAP
         MeshData meshData;
 
         // get heightmap data
-        m_terrainBuilder->loadMap(mapID, tileX, tileY, meshData);
+        terrainBuilder.loadMap(mapID, tileX, tileY, meshData);
 
         // remove unused vertices
         TerrainBuilder::cleanVertices(meshData.solidVerts, meshData.solidTris);
         TerrainBuilder::cleanVertices(meshData.liquidVerts, meshData.liquidTris);
 
         // get model data
-        m_terrainBuilder->loadVMap(mapID, tileY, tileX, meshData);
+        terrainBuilder.loadVMap(mapID, tileY, tileX, meshData);
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
@@ -428,11 +532,11 @@ namespace MMAP
         float bmin[3], bmax[3];
         getTileBounds(tileX, tileY, allVerts.getCArray(), allVerts.size() / 3, bmin, bmax);
 
-        m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
+        terrainBuilder.loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
         // build navmesh tile
         buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
-        m_terrainBuilder->unloadVMap(mapID, tileY, tileX);
+        terrainBuilder.unloadVMap(mapID, tileY, tileX);
     }
 
     /**************************************************************************/
@@ -1096,6 +1200,129 @@ namespace MMAP
 
         return true;
     }
+
+    /**************************************************************************/
+    std::string MapBuilder::getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY)
+    {
+        // builder settings and formats are part of the inputs
+        std::ostringstream inputs;
+        inputs << MMAP_VERSION << ' ' << DT_NAVMESH_VERSION << ' ' << m_skipLiquid << ' ' << m_quick << '\n';
+
+        // terrain of the tile and the borders loaded from its neighbours, then the model spawns
+        std::vector<std::string> fileNames;
+        char fileName[255];
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX);
+        fileNames.push_back(fileName);
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX + 1);
+        fileNames.push_back(fileName);
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX - 1);
+        fileNames.push_back(fileName);
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY + 1, tileX);
+        fileNames.push_back(fileName);
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY - 1, tileX);
+        fileNames.push_back(fileName);
+        fileNames.push_back("vmaps/" + VMapManager2::getMapFileName(mapID));
+        fileNames.push_back("vmaps/" + StaticMapTree::getTileFileName(mapID, tileY, tileX));
+        if (m_offMeshFilePath)
+            fileNames.push_back(m_offMeshFilePath);
+
+        SHA1Hash sha;
+        sha.UpdateData(inputs.str());
+
+        // tile headers are stored relative to the map navmesh origin, which moves when edge tiles are added or removed
+        dtNavMeshParams const& params = m_navMeshParams.at(mapID);
+        sha.UpdateData(reinterpret_cast<uint8 const*>(params.orig), int(sizeof(params.orig)));
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&params.tileWidth), int(sizeof(params.tileWidth)));
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&params.tileHeight), int(sizeof(params.tileHeight)));
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&params.maxTiles), int(sizeof(params.maxTiles)));
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&params.maxPolys), int(sizeof(params.maxPolys)));
+
+        for (std::string const& name : fileNames)
+        {
+            sha.UpdateData(name);
+
+            FILE* file = fopen(name.c_str(), "rb");
+            if (!file)
+                continue;
+
+            uint8 buffer[64 * 1024];
+            size_t count;
+            while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+                sha.UpdateData(buffer, int(count));
+            fclose(file);
+        }
+        sha.Finalize();
+
+        return ByteArrayToHexStr(sha.GetDigest(), sha.GetLength());
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::isTileUpToDate(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash)
+    {
+        TileHash tileHash;
+        {
+            std::lock_guard<std::mutex> lock(m_tileHashesLock);
+            auto itr = m_tileHashes.find((uint64(mapID) << 32) | StaticMapTree::packTileID(tileX, tileY));
+            if (itr == m_tileHashes.end())
+                return false;
+
+            tileHash = itr->second;
+        }
+
+        if (tileHash.m_hash != inputHash)
+            return false;
+
+        // tiles without any data never have a file
+        return !tileHash.m_hasTile || shouldSkipTile(mapID, tileX, tileY);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::loadTileHashes()
+    {
+        FILE* file = fopen("mmaps/tiles.sha1", "r");
+        if (!file)
+        {
+            printf("No tile hashes found, building all tiles\n");
+            return;
+        }
+
+        uint32 mapID, tileX, tileY, hasTile;
+        char hash[SHA_DIGEST_LENGTH * 2 + 1];
+        while (fscanf(file, "%u %u %u %40s %u", &mapID, &tileX, &tileY, hash, &hasTile) == 5)
+        {
+            TileHash& tileHash = m_tileHashes[(uint64(mapID) << 32) | StaticMapTree::packTileID(tileX, tileY)];
+            tileHash.m_hash = hash;
+            tileHash.m_hasTile = hasTile != 0;
+        }
+        fclose(file);
+
+        printf("Loaded %u tile hashes\n", uint32(m_tileHashes.size()));
+    }
+
+    /**************************************************************************/
+    void MapBuilder::saveTileHashes()
+    {
+        // written to a temporary file first, an interrupted run keeps the previous hashes
+        FILE* file = fopen("mmaps/tiles.sha1.tmp", "w");
+        if (!file)
+        {
+            perror("Failed to open mmaps/tiles.sha1.tmp for writing!");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_tileHashesLock);
+        for (auto const& itr : m_tileHashes)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(uint32(itr.first), tileX, tileY);
+            fprintf(file, "%03u %02u %02u %s %u\n", uint32(itr.first >> 32), tileX, tileY, itr.second.m_hash.c_str(), itr.second.m_hasTile ? 1 : 0);
+        }
+        fclose(file);
+
+        std::remove("mmaps/tiles.sha1");
+        if (std::rename("mmaps/tiles.sha1.tmp", "mmaps/tiles.sha1") != 0)
+            perror("Failed to write mmaps/tiles.sha1!");
+    }
     /**************************************************************************/
     /**
     * Build navmesh for GameObject model.
@@ -25,6 +25,8 @@
 #include <map>
 #include <list>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
@@ -55,6 +57,24 @@ namespace MMAP
 
     typedef std::list<MapTiles> TileList;
 
+    // one unit of work for the builder threads
+    struct TileInfo
+    {
+        TileInfo() : m_mapId(uint32(-1)), m_tileX(0), m_tileY(0) {}
+        TileInfo(uint32 mapId, uint32 tileX, uint32 tileY) : m_mapId(mapId), m_tileX(tileX), m_tileY(tileY) {}
+
+        uint32 m_mapId;
+        uint32 m_tileX;
+        uint32 m_tileY;
+    };
+
+    // input hash of a built tile, see --incremental
+    struct TileHash
+    {
+        std::string m_hash;
+        bool m_hasTile;
+    };
+
     struct Tile
     {
         Tile() : chf(NULL), solid(NULL), cset(NULL), pmesh(NULL), dmesh(NULL) {}
@@ -105,18 +125,18 @@ namespace MMAP
                 bool debugOutput         = false,
                 int mapid                = -1,
                 bool quick               = false,
-                const char* offMeshFilePath = NULL);
+                const char* offMeshFilePath = NULL,
+                bool incremental         = false);
 
             ~MapBuilder();
 
-            // builds all mmap tiles for the specified map id (ignores skip settings)
-            void buildMap(uint32 mapID);
             void buildMeshFromFile(char* name);
 
             // builds an mmap tile for the specified map and its mesh
             void buildSingleTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
             // builds list of maps, then builds all of mmap tiles (based on the skip settings)
+            // tiles of all maps are shared between the threads
             void buildAllMaps(unsigned int threads);
 
             void buildGameObject(std::string modelName, uint32 displayId);
@@ -134,7 +154,10 @@ namespace MMAP
 
             void buildNavMesh(uint32 mapID, dtNavMesh* &navMesh);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
+            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, TerrainBuilder& terrainBuilder);
+
+            // builds a tile popped from the queue, navMesh is (re)created from the map params when the map changes
+            void buildQueuedTile(TileInfo const& tileInfo, TerrainBuilder& terrainBuilder, dtNavMesh*& navMesh, uint32& navMeshMapId);
 
             // move map building
             void buildMoveMapTile(uint32 mapID,
@@ -154,17 +177,28 @@ namespace MMAP
             bool isTransportMap(uint32 mapID);
             bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
+            // incremental mode: hash of every input file and map navmesh params a tile is built from
+            std::string getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY);
+            bool isTileUpToDate(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash);
+            void loadTileHashes();
+            void saveTileHashes();
+
             // Fences should not be passable
             float const agentMaxClimbModelTerrainTransition = 1.2f;
             float const agentMaxClimbTerrain = 1.8f;
             rcConfig GetMapSpecificConfig(uint32 mapID, float bmin[3], float bmax[3], const TileConfig &tileConfig);
 
             uint32 percentageDone(uint32 totalTiles, uint32 totalTilesDone);
+            void printProgress(uint32 startTime);
 
             TerrainBuilder* m_terrainBuilder;
             TileList m_tiles;
 
+            // written before the builder threads start, read only afterwards
+            std::unordered_map<uint32, dtNavMeshParams> m_navMeshParams;
+
             bool m_debugOutput;
+            bool m_skipLiquid;
 
             const char* m_offMeshFilePath;
             bool m_skipContinents;
@@ -179,18 +213,24 @@ namespace MMAP
             */
             bool m_quick;
 
+            // only rebuild tiles whose input files changed since the last run
+            bool m_incremental;
+            std::unordered_map<uint64, TileHash> m_tileHashes;
+            std::mutex m_tileHashesLock;
+
             //sun: removed //bool m_bigBaseUnit;
 
             int32 m_mapid;
 
             std::atomic<uint32> m_totalTiles;
             std::atomic<uint32> m_totalTilesProcessed;
+            std::atomic<uint32> m_totalTilesUnchanged;
 
             // build performance - not really used for now
             rcContext* m_rcContext;
 
             std::vector<std::thread> _workerThreads;
-            ProducerConsumerQueue<uint32> _queue;
+            ProducerConsumerQueue<TileInfo> _queue;
             std::atomic<bool> _cancelationToken;
     };
 }
@@ -66,7 +66,8 @@ bool handleArgs(int argc, char** argv,
                char* &offMeshInputPath,
                char* &file,
                unsigned int& threads,
-               bool& quick)
+               bool& quick,
+               bool& incremental)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -188,6 +189,10 @@ bool handleArgs(int argc, char** argv,
         {
             quick = true;
         }
+        else if (strcmp(argv[i], "--incremental") == 0)
+        {
+            incremental = true;
+        }
         else
         {
             int map = atoi(argv[i]);
@@ -224,13 +229,14 @@ int main(int argc, char** argv)
          skipBattlegrounds = false,
          debugOutput = false,
          silent = false,
-         quick = false;
+         quick = false,
+         incremental = false;
     char* offMeshInputPath = nullptr;
     char* file = nullptr;
 
     bool validParam = handleArgs(argc, argv, mapnum,
                                  tileX, tileY, skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debugOutput, silent, offMeshInputPath, file, threads, quick);
+                                 debugOutput, silent, offMeshInputPath, file, threads, quick, incremental);
 
     if (!validParam)
         return silent ? -1 : finish("You have specified invalid parameters", -1);
@@ -251,7 +257,7 @@ int main(int argc, char** argv)
         return silent ? -3 : finish("Press ENTER to close...", -3);
 
     MapBuilder builder(skipLiquid, skipContinents, skipJunkMaps,
-                       skipBattlegrounds, debugOutput, mapnum, quick, offMeshInputPath);
+                       skipBattlegrounds, debugOutput, mapnum, quick, offMeshInputPath, incremental);
 
     uint32 start = GetMSTime();
     if (file)
@@ -259,7 +265,7 @@ int main(int argc, char** argv)
     else if (tileX > -1 && tileY > -1 && mapnum >= 0)
         builder.buildSingleTile(mapnum, tileX, tileY);
     else if (mapnum >= 0)
-        builder.buildMap(uint32(mapnum));
+        builder.buildAllMaps(threads); // only this map is not skipped, its tiles are still built in parallel
     else
     {
         builder.buildTransports();
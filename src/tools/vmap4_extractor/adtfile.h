@@ -121,7 +121,8 @@ public:
     int nMDX;
     std::string* WmoInstansName;
     std::string* ModelInstansName;
-    bool init(uint32 map_num, uint32 tileX, uint32 tileY);
+    bool init(uint32 map_num, uint32 tileX, uint32 tileY, FILE* dirfile);
+    MPQFile& GetFile() { return ADT; }
     //void LoadMapChunks();
 
     //uint32 wmo_count;
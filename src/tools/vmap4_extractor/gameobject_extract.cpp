@@ -22,8 +22,20 @@
 #include "vmapexport.h"
 
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <stdio.h>
 
+struct ExtractedModel
+{
+    std::once_flag Once;
+    bool Result = false;
+};
+
+// Models are shared by the tiles extracted in parallel, the first tile converts them while the others wait
+std::map<std::string, ExtractedModel> extractedModels;
+std::mutex extractedModelsLock;
+
 bool ExtractSingleModel(std::string& fname)
 {
     char * name = GetPlainName((char*)fname.c_str());
@@ -43,14 +55,26 @@ bool ExtractSingleModel(std::string& fname)
     output += "/";
     output += name;
 
-    if (FileExists(output.c_str()))
-        return true;
+    ExtractedModel* model;
+    {
+        std::lock_guard<std::mutex> lock(extractedModelsLock);
+        model = &extractedModels[output];
+    }
+
+    std::call_once(model->Once, [&]()
+    {
+        if (FileExists(output.c_str()))
+        {
+            model->Result = true;
+            return;
+        }
 
-    Model mdl(fname);
-    if (!mdl.open())
-        return false;
+        Model mdl(fname);
+        if (mdl.open())
+            model->Result = mdl.ConvertToVMAPModel(output.c_str());
+    });
 
-    return mdl.ConvertToVMAPModel(output.c_str());
+    return model->Result;
 }
 
 void ExtractGameobjectModels()
@@ -21,7 +21,8 @@
 #include <cstdio>
 #include <algorithm>
 
-ArchiveSet gOpenArchives;
+// every extraction thread opens its own handles, libmpq archives can't be shared between threads
+thread_local ArchiveSet gOpenArchives;
 
 MPQArchive::MPQArchive(const char* filename)
 {
@@ -21,7 +21,13 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <set>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include "Banner.h"
+#include "SHA1.h"
+#include "Util.h"
 #include <errno.h>
 
 #ifdef _WIN32
@@ -57,7 +63,7 @@
 
 //-----------------------------------------------------------------------------
 
-extern ArchiveSet gOpenArchives;
+extern thread_local ArchiveSet gOpenArchives;
 
 typedef struct
 {
@@ -74,6 +80,11 @@ char output_path[128]=".";
 char input_path[1024]=".";
 bool hasInputPathParam = false;
 bool preciseVectorData = false;
+// Number of threads extracting wmo files and map tiles, 0 extracts them on the main thread
+unsigned int threadCount = std::thread::hardware_concurrency();
+// Skip map tiles whose adt data did not change since the last run
+bool incremental = false;
+std::vector<std::string> archiveNames;
 
 // Constants
 
@@ -126,24 +137,100 @@ void ReadLiquidTypeTableDBC()
 }
 #endif
 
+void OpenArchives()
+{
+    for (size_t i=0; i < archiveNames.size(); ++i)
+    {
+        MPQArchive *archive = new MPQArchive(archiveNames[i].c_str());
+        if (gOpenArchives.empty() || gOpenArchives.front() != archive)
+            delete archive;
+    }
+}
+
+void CloseArchives()
+{
+    // the destructor closes the archives still listed as opened
+    while (!gOpenArchives.empty())
+    {
+        delete gOpenArchives.front();
+        gOpenArchives.pop_front();
+    }
+}
+
+// Calls work(index) for every index below count, each worker thread reads through its own archive handles
+template<class Work>
+void RunParallel(size_t count, char const* description, Work const& work)
+{
+    if (threadCount == 0)
+    {
+        for (size_t index = 0; index < count; ++index)
+            work(index);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> done(0);
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([&]()
+        {
+            OpenArchives();
+
+            for (size_t index = next++; index < count; index = next++)
+            {
+                work(index);
+                ++done;
+            }
+
+            CloseArchives();
+        });
+    }
+
+    while (done < count)
+    {
+        printf("%s: %u/%u\r", description, uint32(done), uint32(count));
+        fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    printf("%s: %u/%u\n", description, uint32(count), uint32(count));
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
 bool ExtractWmo()
 {
-    bool success = true;
+    std::atomic<bool> success(true);
 
     //const char* ParsArchiveNames[] = {"patch-2.MPQ", "patch.MPQ", "common.MPQ", "expansion.MPQ"};
 
-    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end() && success; ++ar_itr)
+    // several archives list the same files, each output file is extracted once from the first name listed
+    std::vector<std::string> wmoFiles;
+    std::set<std::string> localFiles;
+    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end(); ++ar_itr)
     {
         vector<string> filelist;
 
         (*ar_itr)->GetFileListTo(filelist);
-        for (vector<string>::iterator fname = filelist.begin(); fname != filelist.end() && success; ++fname)
+        for (vector<string>::iterator fname = filelist.begin(); fname != filelist.end(); ++fname)
         {
-            if (fname->find(".wmo") != string::npos)
-                success = ExtractSingleWmo(*fname);
+            if (fname->find(".wmo") == string::npos)
+                continue;
+
+            std::string localFile = GetPlainName(fname->c_str());
+            fixnamen(&localFile[0], localFile.length());
+            if (localFiles.insert(localFile).second)
+                wmoFiles.push_back(*fname);
         }
     }
 
+    RunParallel(wmoFiles.size(), "Extracting wmo files", [&](size_t index)
+    {
+        if (success && !ExtractSingleWmo(wmoFiles[index]))
+            success = false;
+    });
+
     if (success)
         printf("\nExtract wmo complete (No (fatal) errors)\n");
 
@@ -181,7 +268,7 @@ bool ExtractSingleWmo(std::string& fname)
         return true;
 
     bool file_ok = true;
-    std::cout << "Extracting " << fname << std::endl;
+    printf("Extracting %s\n", fname.c_str());
     WMORoot froot(fname);
     if(!froot.open())
     {
@@ -231,36 +318,201 @@ bool ExtractSingleWmo(std::string& fname)
     return true;
 }
 
+struct MapTile
+{
+    MapTile(uint32 mapIndex, uint32 x, uint32 y) : MapIndex(mapIndex), X(x), Y(y) { }
+
+    uint32 MapIndex;
+    uint32 X;
+    uint32 Y;
+};
+
+// Input hashes of the extracted tiles, keyed by map id and tile coordinates
+std::map<uint32, std::string> tileHashes;
+std::mutex tileHashesLock;
+std::atomic<uint32> tilesUnchanged(0);
+
+inline uint32 GetTileKey(uint32 mapId, uint32 x, uint32 y)
+{
+    return (mapId << 16) | (x << 8) | y;
+}
+
+std::string GetTileInputHash(MPQFile& adt)
+{
+    // spawns are only written for models that were extracted, the models of an unchanged tile are already there
+    SHA1Hash sha;
+    sha.UpdateData(szRawVMAPMagic);
+    sha.UpdateData((uint8 const*)adt.getBuffer(), int(adt.getSize()));
+    sha.Finalize();
+
+    return ByteArrayToHexStr(sha.GetDigest(), sha.GetLength());
+}
+
+void LoadTileHashes(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "r");
+    if (!file)
+    {
+        printf("No tile hashes found, extracting all tiles\n");
+        return;
+    }
+
+    uint32 mapId, x, y;
+    char hash[SHA_DIGEST_LENGTH * 2 + 1];
+    while (fscanf(file, "%u %u %u %40s", &mapId, &x, &y, hash) == 4)
+        tileHashes[GetTileKey(mapId, x, y)] = hash;
+    fclose(file);
+
+    printf("Loaded %u tile hashes\n", uint32(tileHashes.size()));
+}
+
+void SaveTileHashes(std::string const& fileName)
+{
+    // written to a temporary file first, an interrupted run keeps the previous hashes
+    std::string tmpFileName = fileName + ".tmp";
+    FILE* file = fopen(tmpFileName.c_str(), "w");
+    if (!file)
+    {
+        printf("Can't open %s for writing!\n", tmpFileName.c_str());
+        return;
+    }
+
+    for (auto const& itr : tileHashes)
+        fprintf(file, "%03u %02u %02u %s\n", itr.first >> 16, (itr.first >> 8) & 0xFF, itr.first & 0xFF, itr.second.c_str());
+    fclose(file);
+
+    remove(fileName.c_str());
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+        printf("Can't write the tile hashes to %s!\n", fileName.c_str());
+}
+
+std::string GetTileFileName(MapTile const& tile)
+{
+    char fileName[512];
+    sprintf(fileName, "%s/tiles/%03u_%02u_%02u", szWorkDirWmo, map_ids[tile.MapIndex].id, tile.X, tile.Y);
+    return fileName;
+}
+
+// Writes the spawns of one tile to its own file, returns false when the map has no such tile
+bool ExtractTile(MapTile const& tile)
+{
+    map_id const& map = map_ids[tile.MapIndex];
+    char name[512];
+    sprintf(name, "World\\Maps\\%s\\%s_%u_%u.adt", map.name, map.name, tile.X, tile.Y);
+
+    ADTFile ADT(name);
+    if (ADT.GetFile().isEof())
+        return false;
+
+    std::string fileName = GetTileFileName(tile);
+    std::string hash;
+    if (incremental)
+    {
+        hash = GetTileInputHash(ADT.GetFile());
+
+        std::lock_guard<std::mutex> lock(tileHashesLock);
+        auto itr = tileHashes.find(GetTileKey(map.id, tile.X, tile.Y));
+        if (itr != tileHashes.end() && itr->second == hash && FileExists(fileName.c_str()))
+        {
+            ++tilesUnchanged;
+            return true;
+        }
+    }
+
+    FILE* dirfile = fopen(fileName.c_str(), "wb");
+    if (!dirfile)
+    {
+        printf("Can't open dirfile!'%s'\n", fileName.c_str());
+        return false;
+    }
+
+    bool result = ADT.init(map.id, tile.X, tile.Y, dirfile);
+    fclose(dirfile);
+
+    if (result && incremental)
+    {
+        std::lock_guard<std::mutex> lock(tileHashesLock);
+        tileHashes[GetTileKey(map.id, tile.X, tile.Y)] = hash;
+    }
+    return result;
+}
+
 void ParsMapFiles()
 {
+    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
+    FILE* dirfile = fopen(dirname.c_str(), "wb");
+    if (!dirfile)
+    {
+        printf("Can't open dirfile!'%s'\n", dirname.c_str());
+        return;
+    }
+
+    std::string tilesPath = std::string(szWorkDirWmo) + "/tiles";
+    if (mkdir(tilesPath.c_str()
+#if defined(__linux__) || defined(__APPLE__)
+                    , 0711
+#endif
+                    ) && errno != EEXIST)
+    {
+        printf("Can't create directory '%s'\n", tilesPath.c_str());
+        fclose(dirfile);
+        return;
+    }
+
+    std::string hashesFileName = std::string(szWorkDirWmo) + "/tiles.sha1";
+    if (incremental)
+        LoadTileHashes(hashesFileName);
+
     char fn[512];
     //char id_filename[64];
     char id[10];
+    std::vector<MapTile> tiles;
     for (unsigned int i=0; i<map_count; ++i)
     {
         sprintf(id,"%03u",map_ids[i].id);
         sprintf(fn,"World\\Maps\\%s\\%s.wdt", map_ids[i].name, map_ids[i].name);
         WDTFile WDT(fn,map_ids[i].name);
-        if(WDT.init(id, map_ids[i].id))
+        if(WDT.init(id, map_ids[i].id, dirfile))
         {
-            printf("Processing Map %u\n[", map_ids[i].id);
-            for (int x=0; x<64; ++x)
-            {
-                for (int y=0; y<64; ++y)
-                {
-                    if (ADTFile *ADT = WDT.GetMap(x,y))
-                    {
-                        //sprintf(id_filename,"%02u %02u %03u",x,y,map_ids[i].id);//!!!!!!!!!
-                        ADT->init(map_ids[i].id, x, y);
-                        delete ADT;
-                    }
-                }
-                printf("#");
-                fflush(stdout);
-            }
-            printf("]\n");
+            for (uint32 x=0; x<64; ++x)
+                for (uint32 y=0; y<64; ++y)
+                    tiles.emplace_back(i, x, y);
         }
     }
+
+    std::vector<uint8> tileExists(tiles.size(), 0);
+    RunParallel(tiles.size(), "Processing map tiles", [&](size_t index)
+    {
+        tileExists[index] = ExtractTile(tiles[index]) ? 1 : 0;
+    });
+
+    // the tile files are appended in map and tile order, the output does not depend on the thread count
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        if (!tileExists[i])
+            continue;
+
+        std::string fileName = GetTileFileName(tiles[i]);
+        FILE* tileFile = fopen(fileName.c_str(), "rb");
+        if (!tileFile)
+        {
+            printf("Can't open %s!\n", fileName.c_str());
+            continue;
+        }
+
+        char buffer[64 * 1024];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), tileFile)) > 0)
+            fwrite(buffer, 1, count, dirfile);
+        fclose(tileFile);
+    }
+    fclose(dirfile);
+
+    if (incremental)
+    {
+        printf("%u tiles unchanged since the last run\n", uint32(tilesUnchanged));
+        SaveTileHashes(hashesFileName);
+    }
 }
 
 void getGamePath()
@@ -420,6 +672,22 @@ bool processArgv(int argc, char ** argv, const char *versionString)
         {
             preciseVectorData = true;
         }
+        else if(strcmp("-t",argv[i]) == 0)
+        {
+            if((i+1)<argc && atoi(argv[i+1]) >= 0)
+            {
+                threadCount = atoi(argv[i+1]);
+                ++i;
+            }
+            else
+            {
+                result = false;
+            }
+        }
+        else if(strcmp("-u",argv[i]) == 0)
+        {
+            incremental = true;
+        }
         else
         {
             result = false;
@@ -429,10 +697,12 @@ bool processArgv(int argc, char ** argv, const char *versionString)
     if(!result)
     {
         printf("Extract %s.\n",versionString);
-        printf("%s [-?][-s][-l][-d <path>]\n", argv[0]);
+        printf("%s [-?][-s][-l][-d <path>][-t <threads>][-u]\n", argv[0]);
         printf("   -s : (default) small size (data size optimization), ~500MB less vmap data.\n");
         printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
         printf("   -d <path>: Path to the vector data source folder.\n");
+        printf("   -t <threads>: Number of extraction threads, 0 extracts on the main thread. (default %u)\n", std::thread::hardware_concurrency());
+        printf("   -u : incremental, only map tiles changed since the last run are extracted again.\n");
         printf("   -? : This message.\n");
     }
     return result;
@@ -459,8 +729,8 @@ int main(int argc, char ** argv)
     if (!processArgv(argc, argv, versionString))
         return 1;
 
-    // some simple check if working dir is dirty
-    else
+    // some simple check if working dir is dirty, incremental runs reuse the previous output
+    else if (!incremental)
     {
         std::string sdir = std::string(szWorkDirWmo) + "/dir";
         std::string sdir_bin = std::string(szWorkDirWmo) + "/dir_bin";
@@ -485,14 +755,8 @@ int main(int argc, char ** argv)
             success = (errno == EEXIST);
 
     // prepare archive name list
-    std::vector<std::string> archiveNames;
     fillArchiveNameVector(archiveNames);
-    for (size_t i=0; i < archiveNames.size(); ++i)
-    {
-        MPQArchive *archive = new MPQArchive(archiveNames[i].c_str());
-        if (gOpenArchives.empty() || gOpenArchives.front() != archive)
-            delete archive;
-    }
+    OpenArchives();
 
     if (gOpenArchives.empty())
     {
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays line of sight queries recorded by worldserver (Logger.maps.los=1) against extracted vmaps and reports their cost.
+
+#include "Banner.h"
+#include "VMapManager2.h"
+#include "ModelIgnoreFlags.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    float const GRID_SIZE = 533.33333f;
+
+    struct LosQuery
+    {
+        uint32 mapId;
+        float x1, y1, z1;
+        float x2, y2, z2;
+    };
+
+    // vmap tile holding given world position, same as Map grid loading
+    int ComputeTile(float pos)
+    {
+        return 63 - int(pos / GRID_SIZE + 32.0f);
+    }
+
+    bool ReadQueries(char const* fileName, std::vector<LosQuery>& queries)
+    {
+        std::ifstream file(fileName);
+        if (!file)
+            return false;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t pos = line.find("LOS query ");
+            if (pos == std::string::npos)
+                continue;
+
+            LosQuery query;
+            if (sscanf(line.c_str() + pos, "LOS query %u %f %f %f %f %f %f", &query.mapId,
+                &query.x1, &query.y1, &query.z1, &query.x2, &query.y2, &query.z2) == 7)
+                queries.push_back(query);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::Banner::Show("VMAP line of sight benchmark", [](char const* text) { printf("%s\n", text); }, nullptr);
+
+    if (argc < 3)
+    {
+        printf("usage: %s <vmaps dir> <recorded queries log> [iterations]\n", argv[0]);
+        printf("Queries are recorded by worldserver with Logger.maps.los=1\n");
+        return 1;
+    }
+
+    std::string vmapsPath = argv[1];
+    uint32 iterations = argc > 3 ? std::max(atoi(argv[3]), 1) : 10;
+
+    std::vector<LosQuery> queries;
+    if (!ReadQueries(argv[2], queries))
+    {
+        printf("Cannot open %s\n", argv[2]);
+        return 1;
+    }
+    if (queries.empty())
+    {
+        printf("No line of sight query found in %s\n", argv[2]);
+        return 1;
+    }
+
+    VMAP::VMapManager2 vmapManager;
+
+    // load every tile the rays go through before measuring
+    std::set<std::tuple<uint32, int, int>> loadedTiles;
+    uint32 failedTiles = 0;
+    for (LosQuery const& query : queries)
+    {
+        int minX = ComputeTile(std::max(query.x1, query.x2)), maxX = ComputeTile(std::min(query.x1, query.x2));
+        int minY = ComputeTile(std::max(query.y1, query.y2)), maxY = ComputeTile(std::min(query.y1, query.y2));
+        for (int x = minX; x <= maxX; ++x)
+            for (int y = minY; y <= maxY; ++y)
+                if (loadedTiles.emplace(query.mapId, x, y).second)
+                    if (vmapManager.loadMap(vmapsPath.c_str(), query.mapId, x, y) != VMAP::VMAP_LOAD_RESULT_OK)
+                        ++failedTiles;
+    }
+
+    printf("%u queries, %u tiles (%u without vmap), %u iterations\n", uint32(queries.size()), uint32(loadedTiles.size()), failedTiles, iterations);
+
+    uint32 inLineOfSight = 0;
+    for (LosQuery const& query : queries)
+        if (vmapManager.isInLineOfSight(query.mapId, query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, VMAP::ModelIgnoreFlags::Nothing))
+            ++inLineOfSight;
+
+    auto start = std::chrono::steady_clock::now();
+    uint32 checksum = 0;
+    for (uint32 i = 0; i < iterations; ++i)
+        for (LosQuery const& query : queries)
+            checksum += vmapManager.isInLineOfSight(query.mapId, query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, VMAP::ModelIgnoreFlags::Nothing) ? 1 : 0;
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (checksum != inLineOfSight * iterations)
+    {
+        printf("Results differ between iterations\n");
+        return 1;
+    }
+
+    uint64 totalQueries = uint64(queries.size()) * iterations;
+    printf("%u/%u queries in line of sight\n", inLineOfSight, uint32(queries.size()));
+    printf("%.1f ms total, %.1f ns per query, %.0f queries per second\n", elapsedMs, elapsedMs * 1000000.0 / totalQueries, totalQueries / (elapsedMs / 1000.0));
+    return 0;
+}